@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+// Minimal timing helpers shared by the microbenchmarks in this directory.
+namespace bench {
+
+// Keep the compiler from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Average nanoseconds per call of fn, best of several runs after a warm-up
+template <typename F>
+[[nodiscard]] double ns_per_op(size_t iterations, F&& fn, int runs = 5) {
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        fn();
+    }
+
+    double best = 0.0;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        double per_op = elapsed / static_cast<double>(iterations);
+        best = (run == 0) ? per_op : std::min(best, per_op);
+    }
+    return best;
+}
+
+} // namespace bench
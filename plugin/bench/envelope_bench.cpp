@@ -0,0 +1,161 @@
+// Envelope serialization benchmark: text JSON against CBOR and MessagePack
+// for the shapes of the largest endpoints (disassembly, memory map, symbol
+// listing). Times are for serialize() on an ok() envelope, as the server runs
+// it per response; the binary formats include the address-to-integer pass.
+//
+// Routes that write their payload with c_json_envelope (disasm, stack read,
+// cfg/function) hand serialize() JSON text instead of a DOM. The "body"
+// column times that path: nothing for JSON, parsing the text back and then
+// encoding it for CBOR and MessagePack.
+//
+// Usage: envelope_bench
+
+#include "http/c_json_writer.h"
+#include "http/s_http_response.h"
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string address(uint64_t value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "0x%016llX", static_cast<unsigned long long>(value));
+    return buf;
+}
+
+// 2000 instructions, as /api/disasm/at returns them
+nlohmann::json disassembly() {
+    static const char* listing[] = {
+        "push rbp", "mov rbp, rsp", "sub rsp, 0x40", "mov qword ptr ss:[rbp-0x08], rcx",
+        "call qword ptr ds:[<&GetProcAddress>]", "test eax, eax", "je 0x00007FF6A1B21050",
+        "lea rcx, qword ptr ds:[0x00007FF6A1B34F10]", "xor eax, eax", "ret"
+    };
+    auto instructions = nlohmann::json::array();
+    uint64_t ip = 0x00007FF6A1B21000;
+    for (int i = 0; i < 2000; ++i) {
+        const char* text = listing[i % 10];
+        int size = 3 + (i % 5);
+        instructions.push_back({
+            {"address",     address(ip)},
+            {"instruction", text},
+            {"size",        size},
+            {"type",        i % 3},
+            {"is_branch",   i % 10 == 6},
+            {"is_call",     i % 10 == 4},
+            {"label",       (i % 50 == 0) ? "sub_" + std::to_string(i) : ""},
+            {"comment",     ""}
+        });
+        ip += static_cast<uint64_t>(size);
+    }
+    return {{"address", address(0x00007FF6A1B21000)}, {"count", 2000}, {"instructions", instructions}};
+}
+
+// 600 regions, as /api/memmap/list returns them
+nlohmann::json memory_map() {
+    auto regions = nlohmann::json::array();
+    uint64_t base = 0x0000000000010000;
+    for (int i = 0; i < 600; ++i) {
+        uint64_t size = 0x1000ull << (i % 6);
+        regions.push_back({
+            {"base",            address(base)},
+            {"allocation_base", address(base & ~0xFFFFull)},
+            {"size",            size},
+            {"size_hex",        std::to_string(size)},
+            {"state",           "MEM_COMMIT"},
+            {"protect",         (i % 4 == 0) ? "ERW--" : "-R---"},
+            {"type",            (i % 3 == 0) ? "MEM_IMAGE" : "MEM_PRIVATE"},
+            {"info",            (i % 3 == 0) ? "kernel32.dll" : ""}
+        });
+        base += size + 0x10000;
+    }
+    return {{"count", 600}, {"regions", regions}};
+}
+
+// 5000 symbols, as /api/symbols/list returns them
+nlohmann::json symbols() {
+    auto list = nlohmann::json::array();
+    for (int i = 0; i < 5000; ++i) {
+        auto name = "Rtl" + std::to_string(i) + "CaptureContext";
+        list.push_back({
+            {"address",     address(0x00007FFC2D400000 + static_cast<uint64_t>(i) * 0x40)},
+            {"decorated",   name},
+            {"undecorated", name},
+            {"type",        i % 3},
+            {"ordinal",     i}
+        });
+    }
+    return {{"module", "ntdll.dll"}, {"base", address(0x00007FFC2D400000)}, {"count", 5000}, {"symbols", list}};
+}
+
+void run(const char* name, const nlohmann::json& payload) {
+    struct s_format {
+        const char* label;
+        e_body_format format;
+    };
+    static constexpr s_format formats[] = {
+        {"json",    e_body_format::json},
+        {"cbor",    e_body_format::cbor},
+        {"msgpack", e_body_format::msgpack},
+    };
+
+    // Building the envelope copies the payload; time that alone and report
+    // only the serialization on top of it
+    double build_ns = bench::ns_per_op(50, [&] {
+        auto resp = s_http_response::ok(payload);
+        bench::do_not_optimize(resp.document);
+    });
+
+    // The same payload as c_json_envelope writes it; each run starts from a
+    // copy of that response, timed alone as well
+    c_json_envelope envelope;
+    envelope.data().value(payload);
+    const auto written = envelope.finish();
+    double copy_ns = bench::ns_per_op(50, [&] {
+        auto resp = written;
+        bench::do_not_optimize(resp.body);
+    });
+
+    std::printf("%s\n", name);
+    std::printf("  %-8s %9s %8s  %10s %8s  %10s\n", "", "bytes", "", "DOM", "", "body");
+    double json_ns = 0.0;
+    size_t json_size = 0;
+
+    for (const auto& [label, format] : formats) {
+        size_t size = 0;
+        double ns = bench::ns_per_op(50, [&] {
+            auto resp = s_http_response::ok(payload);
+            resp.serialize(format);
+            size = resp.body.size();
+            bench::do_not_optimize(resp.body);
+        }) - build_ns;
+
+        double body_ns = bench::ns_per_op(50, [&] {
+            auto resp = written;
+            resp.serialize(format);
+            bench::do_not_optimize(resp.body);
+        }) - copy_ns;
+
+        if (format == e_body_format::json) {
+            json_ns = ns;
+            json_size = size;
+        }
+        std::printf("  %-8s %9zu (%5.1f%%)  %8.1f us (%5.2fx)  %8.1f us\n",
+                    label, size, 100.0 * static_cast<double>(size) / static_cast<double>(json_size),
+                    ns / 1000.0, ns / json_ns, std::max(body_ns, 0.0) / 1000.0);
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main() {
+    run("disassembly (2000 instructions)", disassembly());
+    run("memory map (600 regions)", memory_map());
+    run("symbols (5000 entries)", symbols());
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Formatting and pattern-search baseline: the format_utils helpers and the
+// AOB pattern parser/scanner behind /api/search/*, on buffers from 1KB to
+// 64MB. Scanned buffers are pseudo-random bytes with the pattern planted
+// every 64KB, and each scan must find all the planted copies.
+//
+// Usage: format_bench [largest buffer in MB = 64]
+
+#include "util/format_utils.h"
+#include "util/pattern_utils.h"
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t KB = 1024;
+constexpr size_t MB = 1024 * KB;
+constexpr size_t BYTE_BUDGET = 4 * MB; // bytes processed per timed run
+constexpr size_t PLANT_STRIDE = 64 * KB;
+
+struct s_pattern_case {
+    const char* name;
+    const char* pattern;
+};
+
+const s_pattern_case k_patterns[] = {
+    {"short",         "48 8B 05"},
+    {"prologue",      "48 89 5C 24 08 57 48 83 EC 20"},
+    {"long",          "48 89 5C 24 08 48 89 74 24 10 57 48 83 EC 20 48 8B F9 48 8B DA "
+                      "E8 11 22 33 44 48 8B CF 48 8B D3 FF 15 55 66 77 88 48 8B 5C 24 30"},
+    {"wildcards",     "48 8B 0D ?? ?? ?? ?? E8 ?? ?? ?? ?? 85 C0 74 ??"},
+    {"mostly_wild",   "E8 ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? C3"},
+    {"leading_wild",  "?? ?? ?? ?? 48 8B C4"},
+};
+
+std::vector<uint8_t> make_buffer(size_t size) {
+    std::vector<uint8_t> buffer(size);
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (auto& byte : buffer) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = static_cast<uint8_t>(state);
+    }
+    return buffer;
+}
+
+// Write the pattern's concrete bytes every PLANT_STRIDE (wildcards keep the noise)
+void plant(std::vector<uint8_t>& buffer, const std::vector<pattern_utils::pattern_byte>& pattern) {
+    for (size_t at = PLANT_STRIDE / 2; at + pattern.size() <= buffer.size(); at += PLANT_STRIDE) {
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (!pattern[i].is_wildcard) buffer[at + i] = pattern[i].value;
+        }
+    }
+}
+
+std::string size_label(size_t size) {
+    return size >= MB ? std::to_string(size / MB) + "MB" : std::to_string(size / KB) + "KB";
+}
+
+size_t iterations_for(size_t bytes) {
+    return std::max<size_t>(1, BYTE_BUDGET / std::max<size_t>(bytes, 1));
+}
+
+// Large inputs run once: one pass already takes long enough to time
+int runs_for(size_t bytes) {
+    return bytes >= BYTE_BUDGET ? 1 : 3;
+}
+
+void report(const std::string& name, double ns, size_t bytes) {
+    if (bytes == 0) {
+        std::printf("%-36s %12.1f ns/op\n", name.c_str(), ns);
+        return;
+    }
+    std::printf("%-36s %12.1f us/op %10.1f MB/s\n", name.c_str(), ns / 1e3,
+                static_cast<double>(bytes) / MB / (ns / 1e9));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t max_size = ((argc > 1) ? static_cast<size_t>(std::atoi(argv[1])) : 64) * MB;
+    std::vector<size_t> sizes;
+    for (size_t size : {1 * KB, 64 * KB, 1 * MB, 16 * MB, 64 * MB}) {
+        if (size <= std::max(max_size, KB)) sizes.push_back(size);
+    }
+
+    std::printf("-- addresses\n");
+    {
+        duint address = 0x00007FF6A1B21000;
+        report("format_address", bench::ns_per_op(1'000'000, [&] {
+            bench::do_not_optimize(format_utils::format_address(address++));
+        }), 0);
+        auto text = format_utils::format_address(address);
+        report("parse_address", bench::ns_per_op(1'000'000, [&] {
+            bench::do_not_optimize(format_utils::parse_address(text));
+        }), 0);
+    }
+
+    std::printf("\n-- hex bytes\n");
+    for (size_t size : sizes) {
+        auto buffer = make_buffer(size);
+        auto hex = format_utils::format_bytes_hex(buffer.data(), buffer.size());
+        if (format_utils::parse_hex_bytes(hex) != buffer) {
+            std::fprintf(stderr, "parse_hex_bytes does not round-trip format_bytes_hex at %s\n",
+                         size_label(size).c_str());
+            return 1;
+        }
+
+        report("format_bytes_hex " + size_label(size),
+               bench::ns_per_op(iterations_for(size), [&] {
+                   bench::do_not_optimize(format_utils::format_bytes_hex(buffer.data(), buffer.size()));
+               }, runs_for(size)), size);
+        report("format_bytes_compact " + size_label(size),
+               bench::ns_per_op(iterations_for(size), [&] {
+                   bench::do_not_optimize(format_utils::format_bytes_compact(buffer.data(), buffer.size()));
+               }, runs_for(size)), size);
+        report("parse_hex_bytes " + size_label(size),
+               bench::ns_per_op(iterations_for(hex.size()), [&] {
+                   bench::do_not_optimize(format_utils::parse_hex_bytes(hex));
+               }, runs_for(hex.size())), size);
+    }
+
+    std::printf("\n-- pattern parsing\n");
+    for (const auto& pattern : k_patterns) {
+        std::string text = pattern.pattern;
+        report(std::string("parse_byte_pattern ") + pattern.name, bench::ns_per_op(200'000, [&] {
+            bench::do_not_optimize(pattern_utils::parse_byte_pattern(text));
+        }), 0);
+    }
+
+    std::printf("\n-- pattern scanning\n");
+    for (const auto& pattern_case : k_patterns) {
+        auto pattern = pattern_utils::parse_byte_pattern(pattern_case.pattern);
+        if (pattern.empty()) {
+            std::fprintf(stderr, "pattern '%s' does not parse\n", pattern_case.name);
+            return 1;
+        }
+
+        for (size_t size : sizes) {
+            auto buffer = make_buffer(size);
+            plant(buffer, pattern);
+            size_t hits = 0;
+            double ns = bench::ns_per_op(iterations_for(size), [&] {
+                auto found = pattern_utils::scan_buffer(buffer.data(), buffer.size(), pattern);
+                hits = found.size();
+                bench::do_not_optimize(found);
+            }, runs_for(size));
+
+            const size_t planted = (size >= PLANT_STRIDE / 2 + pattern.size())
+                                       ? (size - PLANT_STRIDE / 2 - pattern.size()) / PLANT_STRIDE + 1
+                                       : 0;
+            if (hits < planted) {
+                std::fprintf(stderr, "scan_buffer found %zu of %zu planted '%s' matches\n",
+                             hits, planted, pattern_case.name);
+                return 1;
+            }
+            report("scan_buffer " + std::string(pattern_case.name) + " " + size_label(size), ns, size);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,491 @@
+// Response building benchmark: the nlohmann::json DOM path the handlers used
+// (a document per element, copied into an ok() envelope and dumped, or
+// dumped item by item into a c_json_array_stream) against c_json_writer
+// writing the same payload straight into the body. Shapes and sizes are
+// those of the heaviest handlers; both outputs are parsed back and compared,
+// so the benchmark also fails if the writer's output drifts.
+//
+// Usage: json_writer_bench
+
+#include "http/c_json_stream.h"
+#include "http/c_json_writer.h"
+#include "bench_util.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t IMAGE_BASE = 0x00007FF6A1B20000;
+
+std::string address(uint64_t value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "0x%016llX", static_cast<unsigned long long>(value));
+    return buf;
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic inputs, in the form the bridge hands them to the handlers
+// ---------------------------------------------------------------------------
+
+struct s_instruction {
+    uint64_t address;
+    const char* text;
+    int size;
+    int type;
+    bool is_branch;
+    bool is_call;
+    std::string label;
+    const char* comment;
+};
+
+std::vector<s_instruction> instructions(size_t count) {
+    static const char* const listing[] = {
+        "push rbx", "sub rsp, 0x20", "mov rbx, rcx", "call 0x00007FF6A1B21460",
+        "test eax, eax", "je 0x00007FF6A1B2104A", "mov rcx, qword ptr ds:[rbx+0x10]",
+        "lea rdx, qword ptr ss:[rsp+0x30]", "xor r8d, r8d", "add rsp, 0x20", "pop rbx", "ret"
+    };
+    std::vector<s_instruction> out;
+    uint64_t ip = IMAGE_BASE + 0x1000;
+    for (size_t i = 0; i < count; ++i) {
+        const char* text = listing[i % std::size(listing)];
+        int size = 3 + static_cast<int>(i % 5);
+        out.push_back({ip, text, size, 1, text[0] == 'c' || text[0] == 'j', text[0] == 'c',
+                       i % 50 == 0 ? "sub_" + std::to_string(i) : "", i % 40 == 0 ? "\"checked\"" : ""});
+        ip += static_cast<uint64_t>(size);
+    }
+    return out;
+}
+
+struct s_found_string {
+    uint64_t address;
+    const char* type;
+    std::string value;
+};
+
+std::vector<s_found_string> strings(size_t count) {
+    std::vector<s_found_string> out;
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back({IMAGE_BASE + 0x20000 + i * 24, i % 4 == 0 ? "utf16" : "ascii",
+                       "Software\\Microsoft\\Windows\\" + std::to_string(i)});
+    }
+    return out;
+}
+
+struct s_symbol {
+    uint64_t address;
+    std::string decorated;
+    std::string undecorated;
+    int type;
+    uint32_t ordinal;
+};
+
+std::vector<s_symbol> symbols(size_t count) {
+    std::vector<s_symbol> out;
+    for (size_t i = 0; i < count; ++i) {
+        auto name = "Rtl" + std::to_string(i) + "CaptureContext";
+        out.push_back({0x00007FFC2D400000 + i * 0x40, "?" + name + "@@YAXXZ", name,
+                       static_cast<int>(i % 3), static_cast<uint32_t>(i)});
+    }
+    return out;
+}
+
+struct s_region {
+    uint64_t base;
+    uint64_t allocation_base;
+    uint64_t size;
+    const char* state;
+    const char* protect;
+    const char* type;
+    const char* info;
+};
+
+std::vector<s_region> regions(size_t count) {
+    std::vector<s_region> out;
+    uint64_t base = 0x0000000000010000;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t size = 0x1000ull << (i % 6);
+        out.push_back({base, base & ~0xFFFFull, size, "MEM_COMMIT",
+                       i % 4 == 0 ? "PAGE_EXECUTE_READ" : "PAGE_READWRITE",
+                       i % 3 == 0 ? "MEM_IMAGE" : "MEM_PRIVATE", i % 3 == 0 ? "kernel32.dll" : ""});
+        base += size + 0x10000;
+    }
+    return out;
+}
+
+struct s_stack_entry {
+    uint64_t value;
+    std::string label;
+    std::string module;
+};
+
+std::vector<s_stack_entry> stack_entries(size_t count) {
+    std::vector<s_stack_entry> out;
+    for (size_t i = 0; i < count; ++i) {
+        bool code = i % 5 == 0;
+        out.push_back({code ? IMAGE_BASE + 0x1000 + i * 16 : 0x000000C3D5AFF6E8 + i,
+                       code ? "module.sub_" + std::to_string(i) : "", code ? "module.exe" : ""});
+    }
+    return out;
+}
+
+struct s_cfg_node {
+    uint64_t start, end, brtrue, brfalse;
+    bool terminal, split, indirectcall;
+    std::vector<uint64_t> exits;
+    std::vector<std::pair<uint64_t, std::array<uint8_t, 15>>> instrs;
+};
+
+std::map<uint64_t, s_cfg_node> cfg(size_t node_count, size_t instrs_per_node) {
+    std::map<uint64_t, s_cfg_node> nodes;
+    uint64_t ip = IMAGE_BASE + 0x1000;
+    for (size_t n = 0; n < node_count; ++n) {
+        s_cfg_node node{ip, 0, ip + 0x40, ip + 0x80, n + 1 == node_count, n % 7 == 0, n % 11 == 0, {}, {}};
+        for (size_t i = 0; i < instrs_per_node; ++i) {
+            std::array<uint8_t, 15> bytes{};
+            for (size_t b = 0; b < bytes.size(); ++b) bytes[b] = static_cast<uint8_t>(ip * 31 + b);
+            node.instrs.emplace_back(ip, bytes);
+            ip += 4;
+        }
+        node.end = ip - 4;
+        node.exits = {node.brtrue, node.brfalse};
+        nodes.emplace(node.start, std::move(node));
+    }
+    return nodes;
+}
+
+std::string bytes_hex(const uint8_t* data, size_t size) {
+    static constexpr char digits[] = "0123456789ABCDEF";
+    std::string out;
+    for (size_t i = 0; i < size; ++i) {
+        if (i > 0) out += ' ';
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 0xF];
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Before and after, per handler
+// ---------------------------------------------------------------------------
+
+std::string dom_body(nlohmann::json data) {
+    auto resp = s_http_response::ok(std::move(data));
+    resp.serialize(e_body_format::json);
+    return std::move(resp.body);
+}
+
+std::string disasm_dom(const std::vector<s_instruction>& list) {
+    auto items = nlohmann::json::array();
+    for (const auto& instr : list) {
+        items.push_back({
+            {"address",     address(instr.address)},
+            {"instruction", instr.text},
+            {"size",        instr.size},
+            {"type",        instr.type},
+            {"is_branch",   instr.is_branch},
+            {"is_call",     instr.is_call},
+            {"label",       instr.label},
+            {"comment",     instr.comment}
+        });
+    }
+    return dom_body({
+        {"address",      address(list.front().address)},
+        {"count",        items.size()},
+        {"instructions", items}
+    });
+}
+
+std::string disasm_writer(const std::vector<s_instruction>& list) {
+    c_json_envelope out(256 + list.size() * 192);
+    auto& data = out.data();
+    data.begin_object()
+        .address_field("address", list.front().address)
+        .key("instructions").begin_array();
+    for (const auto& instr : list) {
+        data.begin_object()
+            .address_field("address", instr.address)
+            .field("comment",     instr.comment)
+            .field("instruction", instr.text)
+            .field("is_branch",   instr.is_branch)
+            .field("is_call",     instr.is_call)
+            .field("label",       instr.label)
+            .field("size",        instr.size)
+            .field("type",        instr.type)
+            .end_object();
+    }
+    data.end_array()
+        .field("count", list.size())
+        .end_object();
+    return std::move(out.finish().body);
+}
+
+std::string stack_dom(const std::vector<s_stack_entry>& list) {
+    auto entries = nlohmann::json::array();
+    for (size_t i = 0; i < list.size(); ++i) {
+        entries.push_back({
+            {"address", address(0x000000C3D5AFF000 + i * 8)},
+            {"value",   address(list[i].value)},
+            {"label",   list[i].label},
+            {"module",  list[i].module}
+        });
+    }
+    return dom_body({
+        {"base",    address(0x000000C3D5AFF000)},
+        {"size",    list.size() * 8},
+        {"entries", entries}
+    });
+}
+
+std::string stack_writer(const std::vector<s_stack_entry>& list) {
+    c_json_envelope out(256 + list.size() * 96);
+    auto& data = out.data();
+    data.begin_object()
+        .address_field("base", 0x000000C3D5AFF000)
+        .key("entries").begin_array();
+    for (size_t i = 0; i < list.size(); ++i) {
+        data.begin_object()
+            .address_field("address", 0x000000C3D5AFF000 + i * 8)
+            .field("label",  list[i].label)
+            .field("module", list[i].module)
+            .address_field("value", list[i].value)
+            .end_object();
+    }
+    data.end_array()
+        .field("size", list.size() * 8)
+        .end_object();
+    return std::move(out.finish().body);
+}
+
+std::string cfg_dom(const std::map<uint64_t, s_cfg_node>& graph) {
+    auto nodes = nlohmann::json::array();
+    for (const auto& [start, node] : graph) {
+        auto exits = nlohmann::json::array();
+        for (auto exit_addr : node.exits) {
+            exits.push_back(address(exit_addr));
+        }
+        auto instrs = nlohmann::json::array();
+        for (const auto& [addr, bytes] : node.instrs) {
+            instrs.push_back({
+                {"address", address(addr)},
+                {"data",    bytes_hex(bytes.data(), bytes.size())}
+            });
+        }
+        nodes.push_back({
+            {"start",        address(node.start)},
+            {"end",          address(node.end)},
+            {"brtrue",       address(node.brtrue)},
+            {"brfalse",      address(node.brfalse)},
+            {"terminal",     node.terminal},
+            {"split",        node.split},
+            {"indirectcall", node.indirectcall},
+            {"exits",        exits},
+            {"instructions", instrs}
+        });
+    }
+    return dom_body({
+        {"entry_point", address(graph.begin()->first)},
+        {"nodes",       nodes},
+        {"node_count",  nodes.size()}
+    });
+}
+
+std::string cfg_writer(const std::map<uint64_t, s_cfg_node>& graph) {
+    c_json_envelope out(16 * 1024);
+    auto& data = out.data();
+    data.begin_object()
+        .address_field("entry_point", graph.begin()->first)
+        .field("node_count", graph.size())
+        .key("nodes").begin_array();
+    for (const auto& [start, node] : graph) {
+        data.begin_object()
+            .address_field("brfalse", node.brfalse)
+            .address_field("brtrue",  node.brtrue)
+            .address_field("end",     node.end)
+            .key("exits").begin_array();
+        for (auto exit_addr : node.exits) {
+            data.address(exit_addr);
+        }
+        data.end_array()
+            .field("indirectcall", node.indirectcall)
+            .key("instructions").begin_array();
+        for (const auto& [addr, bytes] : node.instrs) {
+            static constexpr char digits[] = "0123456789ABCDEF";
+            char hex[15 * 3];
+            char* p = hex;
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                if (i > 0) *p++ = ' ';
+                *p++ = digits[bytes[i] >> 4];
+                *p++ = digits[bytes[i] & 0xF];
+            }
+            data.begin_object()
+                .address_field("address", addr)
+                .field("data", std::string_view(hex, static_cast<size_t>(p - hex)))
+                .end_object();
+        }
+        data.end_array()
+            .field("split", node.split)
+            .address_field("start", node.start)
+            .field("terminal", node.terminal)
+            .end_object();
+    }
+    data.end_array()
+        .end_object();
+    return std::move(out.finish().body);
+}
+
+// Streamed listings: c_json_array_stream fed DOM items (push) or written in
+// place (emit), collected into one string
+template <typename F>
+std::string collect_stream(const nlohmann::json& head, std::string_view key, F&& produce) {
+    std::string body;
+    body_writer_t write = [&body](std::string piece) {
+        body += piece;
+        return true;
+    };
+    c_json_array_stream out(write, head, key);
+    produce(out);
+    out.finish({{"count", out.count()}});
+    return body;
+}
+
+std::string strings_dom(const std::vector<s_found_string>& list) {
+    return collect_stream({{"module", "module.exe"}}, "strings", [&](c_json_array_stream& out) {
+        for (const auto& s : list) {
+            out.push({
+                {"address", address(s.address)},
+                {"type",    s.type},
+                {"value",   s.value}
+            });
+        }
+    });
+}
+
+std::string strings_writer(const std::vector<s_found_string>& list) {
+    return collect_stream({{"module", "module.exe"}}, "strings", [&](c_json_array_stream& out) {
+        for (const auto& s : list) {
+            out.emit([&s](c_json_writer& item) {
+                item.begin_object()
+                    .address_field("address", s.address)
+                    .field("type",  s.type)
+                    .field("value", s.value)
+                    .end_object();
+            });
+        }
+    });
+}
+
+std::string symbols_dom(const std::vector<s_symbol>& list) {
+    return collect_stream({{"module", "ntdll.dll"}}, "symbols", [&](c_json_array_stream& out) {
+        for (const auto& s : list) {
+            out.push({
+                {"address",     address(s.address)},
+                {"decorated",   s.decorated},
+                {"undecorated", s.undecorated},
+                {"type",        s.type},
+                {"ordinal",     s.ordinal}
+            });
+        }
+    });
+}
+
+std::string symbols_writer(const std::vector<s_symbol>& list) {
+    return collect_stream({{"module", "ntdll.dll"}}, "symbols", [&](c_json_array_stream& out) {
+        for (const auto& s : list) {
+            out.emit([&s](c_json_writer& item) {
+                item.begin_object()
+                    .address_field("address", s.address)
+                    .field("decorated",   s.decorated)
+                    .field("ordinal",     s.ordinal)
+                    .field("type",        s.type)
+                    .field("undecorated", s.undecorated)
+                    .end_object();
+            });
+        }
+    });
+}
+
+std::string memmap_dom(const std::vector<s_region>& list) {
+    return collect_stream(nlohmann::json::object(), "regions", [&](c_json_array_stream& out) {
+        for (const auto& r : list) {
+            out.push({
+                {"base",            address(r.base)},
+                {"allocation_base", address(r.allocation_base)},
+                {"size",            r.size},
+                {"size_hex",        std::to_string(r.size)},
+                {"state",           r.state},
+                {"protect",         r.protect},
+                {"type",            r.type},
+                {"info",            r.info}
+            });
+        }
+    });
+}
+
+std::string memmap_writer(const std::vector<s_region>& list) {
+    return collect_stream(nlohmann::json::object(), "regions", [&](c_json_array_stream& out) {
+        for (const auto& r : list) {
+            out.emit([&r](c_json_writer& item) {
+                item.begin_object()
+                    .address_field("allocation_base", r.allocation_base)
+                    .address_field("base", r.base)
+                    .field("info",     r.info)
+                    .field("protect",  r.protect)
+                    .field("size",     r.size)
+                    .field("size_hex", std::to_string(r.size))
+                    .field("state",    r.state)
+                    .field("type",     r.type)
+                    .end_object();
+            });
+        }
+    });
+}
+
+bool g_mismatch = false;
+
+void run(const char* name, const std::function<std::string()>& before, const std::function<std::string()>& after) {
+    auto expected = nlohmann::json::parse(before());
+    auto actual = nlohmann::json::parse(after());
+    bool same = expected == actual;
+    g_mismatch |= !same;
+
+    size_t size = 0;
+    double dom_ns = bench::ns_per_op(30, [&] {
+        auto body = before();
+        size = body.size();
+        bench::do_not_optimize(body);
+    });
+    double writer_ns = bench::ns_per_op(30, [&] {
+        auto body = after();
+        bench::do_not_optimize(body);
+    });
+
+    std::printf("%-28s %9zu bytes  %9.1f us  %9.1f us  %5.1fx%s\n", name, size,
+                dom_ns / 1000.0, writer_ns / 1000.0, dom_ns / writer_ns, same ? "" : "  OUTPUT DIFFERS");
+}
+
+} // namespace
+
+int main() {
+    auto disasm = instructions(5000);
+    auto found = strings(5000);
+    auto syms = symbols(5000);
+    auto map = regions(600);
+    auto stack = stack_entries(512);
+    auto graph = cfg(250, 20);
+
+    std::printf("%-28s %15s  %12s  %12s  %6s\n", "payload", "size", "dom", "writer", "speedup");
+    run("disasm (5000 instructions)", [&] { return disasm_dom(disasm); }, [&] { return disasm_writer(disasm); });
+    run("strings (5000, streamed)",   [&] { return strings_dom(found); }, [&] { return strings_writer(found); });
+    run("symbols (5000, streamed)",   [&] { return symbols_dom(syms); },  [&] { return symbols_writer(syms); });
+    run("memmap (600, streamed)",     [&] { return memmap_dom(map); },    [&] { return memmap_writer(map); });
+    run("stack read (4KB)",           [&] { return stack_dom(stack); },   [&] { return stack_writer(stack); });
+    run("cfg (250 nodes x 20)",       [&] { return cfg_dom(graph); },     [&] { return cfg_writer(graph); });
+    return g_mismatch ? 1 : 0;
+}
@@ -0,0 +1,374 @@
+// Load test of the whole HTTP stack: c_http_server, the reactor, the worker
+// pool and c_http_router, serving routes shaped like the real handlers from a
+// stub bridge (stub_bridge.h). Client threads drive keep-alive connections
+// on loopback as fast as responses come back, one route at a time, and
+// report throughput and latency percentiles.
+//
+// Usage: load_bench [seconds per route = 3] [connections = 32] [route filter]
+// Exits non-zero if any request failed, so CI can run it as a smoke test.
+
+#include "http/c_http_server.h"
+#include "http/c_json_stream.h"
+#include "util/c_latency_histogram.h"
+#include "stub_bridge.h"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t SYMBOL_COUNT = 2000; // entries in the streamed listing
+
+struct s_scenario {
+    const char* name;
+    std::string request; // sent as-is on every iteration
+};
+
+std::string hex_column(const std::vector<uint8_t>& bytes) {
+    static constexpr char digits[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(bytes.size() * 3);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (i > 0) out += ' ';
+        out += digits[bytes[i] >> 4];
+        out += digits[bytes[i] & 0xF];
+    }
+    return out;
+}
+
+uint64_t query_number(const s_http_request& req, std::string_view key, uint64_t fallback) {
+    auto text = req.get_query(key);
+    uint64_t value = fallback;
+    int base = 10;
+    if (text.starts_with("0x")) {
+        text.remove_prefix(2);
+        base = 16;
+    }
+    std::from_chars(text.data(), text.data() + text.size(), value, base);
+    return value;
+}
+
+// The same paths and response shapes as the plugin's handlers
+void register_stub_routes(c_http_router& router, const c_stub_bridge& bridge) {
+    router.get("/api/health", [](const s_http_request&) {
+        return s_http_response::ok({{"status", "ok"}, {"version", "bench"}});
+    });
+
+    router.get("/api/registers/all", [&bridge](const s_http_request&) {
+        return s_http_response::ok(bridge.registers());
+    });
+
+    router.get("/api/disasm/at", [&bridge](const s_http_request& req) {
+        auto address = query_number(req, "address", c_stub_bridge::IMAGE_BASE + 0x1000);
+        auto count = static_cast<int>(query_number(req, "count", 10));
+        c_json_envelope out(256 + static_cast<size_t>(count) * 192);
+        auto& data = out.data();
+        data.begin_object()
+            .address_field("address", address)
+            .key("instructions").begin_array();
+        size_t written = 0;
+        bridge.for_each_instruction(address, count, [&](const c_stub_bridge::s_instruction& instr) {
+            data.begin_object()
+                .address_field("address", instr.address)
+                .field("comment",     instr.comment)
+                .field("instruction", instr.text)
+                .field("is_branch",   instr.is_branch)
+                .field("is_call",     instr.is_call)
+                .field("label",       instr.label)
+                .field("size",        instr.size)
+                .field("type",        instr.type)
+                .end_object();
+            ++written;
+            return true;
+        });
+        data.end_array()
+            .field("count", written)
+            .end_object();
+        return out.finish();
+    });
+
+    router.get("/api/memory/read", [&bridge](const s_http_request& req) {
+        auto address = query_number(req, "address", c_stub_bridge::IMAGE_BASE);
+        auto size = static_cast<size_t>(query_number(req, "size", 256));
+        auto bytes = bridge.read_memory(address, size);
+        if (req.get_query("format") == "raw") {
+            return s_http_response::binary(std::string(bytes.begin(), bytes.end()));
+        }
+
+        std::string ascii(bytes.size(), '.');
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            if (bytes[i] >= 0x20 && bytes[i] < 0x7F) ascii[i] = static_cast<char>(bytes[i]);
+        }
+        return s_http_response::ok({
+            {"address", c_stub_bridge::format_address(address)},
+            {"size",    bytes.size()},
+            {"hex",     hex_column(bytes)},
+            {"ascii",   std::move(ascii)}
+        });
+    });
+
+    router.post("/api/breakpoints/set", [](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.contains("address")) {
+            return s_http_response::bad_request("Missing 'address' field");
+        }
+        return s_http_response::ok({{"address", body["address"]}, {"type", "software"}, {"set", true}});
+    });
+
+    router.get("/api/symbols/list", [&bridge](const s_http_request&) {
+        return s_http_response::chunked([&bridge](const body_writer_t& write) {
+            c_json_array_stream out(write, {{"module", "module.exe"}}, "symbols");
+            for (size_t i = 0; i < SYMBOL_COUNT; ++i) {
+                if (!out.emit([&](c_json_writer& item) { bridge.symbol(i, item); })) {
+                    break;
+                }
+            }
+            out.finish({{"count", out.count()}, {"truncated", false}});
+        });
+    });
+}
+
+std::vector<s_scenario> make_scenarios() {
+    auto get = [](std::string target) {
+        return "GET " + target + " HTTP/1.1\r\nHost: 127.0.0.1\r\nUser-Agent: load_bench\r\n\r\n";
+    };
+    std::string breakpoint = R"({"address":"0x00007FF6A1B21000","singleshoot":false})";
+
+    return {
+        {"health",          get("/api/health")},
+        {"registers",       get("/api/registers/all")},
+        {"disasm_32",       get("/api/disasm/at?address=0x00007FF6A1B21000&count=32")},
+        {"memory_hex_4k",   get("/api/memory/read?address=0x00007FF6A1B21000&size=4096")},
+        {"memory_raw_64k",  get("/api/memory/read?address=0x00007FF6A1B21000&size=65536&format=raw")},
+        {"breakpoint_post", "POST /api/breakpoints/set HTTP/1.1\r\nHost: 127.0.0.1\r\n"
+                            "Content-Type: application/json\r\nContent-Length: " +
+                            std::to_string(breakpoint.size()) + "\r\n\r\n" + breakpoint},
+        {"symbols_chunked", get("/api/symbols/list?module=module.exe")},
+    };
+}
+
+// Blocking keep-alive client that reads whole responses (Content-Length or
+// chunked). Reconnects when the server closes the connection, as it does
+// after MAX_REQUESTS_PER_CONNECTION; connects count toward the latency.
+class c_load_client {
+public:
+    explicit c_load_client(uint16_t port) : m_port(port) {}
+
+    ~c_load_client() { disconnect(); }
+
+    c_load_client(const c_load_client&) = delete;
+    c_load_client& operator=(const c_load_client&) = delete;
+
+    // Send the request and consume its response. Returns the status code
+    // (0 if the connection failed); `bytes` gets the body size.
+    int round_trip(const std::string& request, size_t& bytes) {
+        bytes = 0;
+        if (m_sock == INVALID_SOCKET && !connect_socket()) return 0;
+        for (size_t sent = 0; sent < request.size();) {
+            auto n = send(m_sock, request.data() + sent, static_cast<int>(request.size() - sent), 0);
+            if (n <= 0) return 0;
+            sent += static_cast<size_t>(n);
+        }
+
+        size_t head_end;
+        while ((head_end = m_buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) return 0;
+        }
+        std::string_view head(m_buffer.data(), head_end);
+        int status = 0;
+        if (head.size() > 12) {
+            std::from_chars(head.data() + 9, head.data() + 12, status);
+        }
+        const bool chunked = head.find("Transfer-Encoding: chunked") != std::string_view::npos;
+        size_t length = 0;
+        if (auto pos = head.find("Content-Length: "); pos != std::string_view::npos) {
+            std::from_chars(head.data() + pos + 16, head.data() + head.size(), length);
+        }
+        const bool close = head.find("Connection: close") != std::string_view::npos;
+        m_buffer.erase(0, head_end + 4);
+
+        if (!chunked) {
+            if (!consume(length)) return 0;
+            bytes = length;
+            if (close) disconnect();
+            return status;
+        }
+
+        // Chunked: size line, data, CRLF ... until the zero-size chunk
+        while (true) {
+            size_t line_end;
+            while ((line_end = m_buffer.find("\r\n")) == std::string::npos) {
+                if (!fill()) return 0;
+            }
+            size_t chunk = 0;
+            std::from_chars(m_buffer.data(), m_buffer.data() + line_end, chunk, 16);
+            m_buffer.erase(0, line_end + 2);
+            if (!consume(chunk + 2)) return 0;
+            if (chunk == 0) {
+                if (close) disconnect();
+                return status;
+            }
+            bytes += chunk;
+        }
+    }
+
+private:
+    uint16_t m_port;
+    socket_t m_sock = INVALID_SOCKET;
+    std::string m_buffer;
+
+    bool connect_socket() {
+        m_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_sock == INVALID_SOCKET) return false;
+        net::set_option(m_sock, IPPROTO_TCP, TCP_NODELAY, 1);
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(m_port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (connect(m_sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    void disconnect() {
+        if (m_sock != INVALID_SOCKET) {
+            net::close_socket(m_sock);
+            m_sock = INVALID_SOCKET;
+        }
+        m_buffer.clear();
+    }
+
+    bool fill() {
+        char chunk[64 * 1024];
+        auto n = recv(m_sock, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        m_buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    // Discard `count` bytes of the stream
+    bool consume(size_t count) {
+        while (m_buffer.size() < count) {
+            count -= m_buffer.size();
+            m_buffer.clear();
+            if (!fill()) return false;
+        }
+        m_buffer.erase(0, count);
+        return true;
+    }
+};
+
+struct s_result {
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    uint64_t body_bytes = 0;
+    double seconds = 0;
+    c_latency_histogram::s_snapshot latency;
+};
+
+s_result run_scenario(const s_scenario& scenario, uint16_t port, size_t connections,
+                      std::chrono::milliseconds duration) {
+    c_latency_histogram latency;
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> body_bytes{0};
+    std::atomic<bool> stop{false};
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < connections; ++i) {
+        clients.emplace_back([&] {
+            c_load_client client(port);
+            while (!stop.load(std::memory_order_relaxed)) {
+                size_t bytes = 0;
+                auto sent = std::chrono::steady_clock::now();
+                int status = client.round_trip(scenario.request, bytes);
+                latency.record(std::chrono::steady_clock::now() - sent);
+                requests.fetch_add(1, std::memory_order_relaxed);
+                body_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                if (status != 200) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                    return; // the connection is unusable after a failed exchange
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    s_result result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    result.requests = requests.load();
+    result.failures = failures.load();
+    result.body_bytes = body_bytes.load();
+    result.latency = latency.snapshot();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = (argc > 1) ? std::atof(argv[1]) : 3.0;
+    const size_t connections = (argc > 2) ? static_cast<size_t>(std::atoi(argv[2])) : 32;
+    const std::string_view filter = (argc > 3) ? argv[3] : "";
+    if (seconds <= 0 || connections == 0) {
+        std::fprintf(stderr, "usage: load_bench [seconds per route] [connections] [route filter]\n");
+        return 2;
+    }
+
+    c_stub_bridge bridge;
+    c_http_router router;
+    register_stub_routes(router, bridge);
+
+    c_http_server server;
+    auto started = server.start("127.0.0.1", 0, &router);
+    if (!started) {
+        std::fprintf(stderr, "server failed to start: %s\n", started.error().c_str());
+        return 1;
+    }
+
+    std::printf("%zu connections, %.1fs per route, port %u\n\n", connections, seconds, server.get_port());
+    std::printf("%-16s %10s %10s %9s %9s %9s %9s %8s\n",
+                "route", "requests", "req/s", "MB/s", "p50 us", "p99 us", "p999 us", "failed");
+
+    uint64_t total_failures = 0;
+    auto duration = std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000));
+    for (const auto& scenario : make_scenarios()) {
+        if (!filter.empty() && std::string_view(scenario.name).find(filter) == std::string_view::npos) {
+            continue;
+        }
+
+        auto result = run_scenario(scenario, server.get_port(), connections, duration);
+        total_failures += result.failures;
+        std::printf("%-16s %10llu %10.0f %9.1f %9llu %9llu %9llu %8llu\n",
+                    scenario.name,
+                    static_cast<unsigned long long>(result.requests),
+                    static_cast<double>(result.requests) / result.seconds,
+                    static_cast<double>(result.body_bytes) / result.seconds / 1e6,
+                    static_cast<unsigned long long>(result.latency.value_at_quantile(0.50)),
+                    static_cast<unsigned long long>(result.latency.value_at_quantile(0.99)),
+                    static_cast<unsigned long long>(result.latency.value_at_quantile(0.999)),
+                    static_cast<unsigned long long>(result.failures));
+    }
+
+    server.stop();
+    if (total_failures > 0) {
+        std::fprintf(stderr, "\n%llu requests failed\n", static_cast<unsigned long long>(total_failures));
+        return 1;
+    }
+    return 0;
+}
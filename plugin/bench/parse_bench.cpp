@@ -0,0 +1,292 @@
+// Request parsing benchmark: the view-based parser in c_http_server against
+// the copying parser it replaced (substr + istringstream + unordered_map).
+// Parses every request of a recorded corpus, then performs the lookups a
+// typical handler does (two query parameters, two headers).
+//
+// Usage: parse_bench [corpus.http]   (defaults to corpus/mcp_session.http)
+
+#include "http/c_http_server.h"
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace legacy {
+
+struct s_legacy_request {
+    std::string method;
+    std::string path;
+    std::string version;
+    std::string query_string;
+    std::unordered_map<std::string, std::string> query;
+    std::unordered_map<std::string, std::string> headers;
+    std::string body;
+
+    [[nodiscard]] std::string get_query(const std::string& key, const std::string& default_value = "") const {
+        auto it = query.find(key);
+        return (it != query.end()) ? it->second : default_value;
+    }
+
+    [[nodiscard]] std::string get_header(const std::string& key, const std::string& default_value = "") const {
+        auto it = headers.find(key);
+        return (it != headers.end()) ? it->second : default_value;
+    }
+};
+
+void parse_query_string(const std::string& query_string, std::unordered_map<std::string, std::string>& out);
+std::string url_decode(const std::string& encoded);
+
+std::expected<s_legacy_request, std::string> parse_request(const std::string& raw_data) {
+    if (raw_data.empty()) {
+        return std::unexpected("Empty request");
+    }
+
+    s_legacy_request req;
+
+    // Find end of request line
+    auto line_end = raw_data.find("\r\n");
+    if (line_end == std::string::npos) {
+        return std::unexpected("Malformed request line");
+    }
+
+    auto request_line = raw_data.substr(0, line_end);
+
+    // Parse: METHOD PATH HTTP/1.x
+    auto first_space = request_line.find(' ');
+    if (first_space == std::string::npos) {
+        return std::unexpected("Malformed request line: no method");
+    }
+    req.method = request_line.substr(0, first_space);
+
+    auto second_space = request_line.find(' ', first_space + 1);
+    if (second_space == std::string::npos) {
+        return std::unexpected("Malformed request line: no path");
+    }
+    auto full_path = request_line.substr(first_space + 1, second_space - first_space - 1);
+    req.version = request_line.substr(second_space + 1);
+
+    // Split path and query string
+    auto query_pos = full_path.find('?');
+    if (query_pos != std::string::npos) {
+        req.path = full_path.substr(0, query_pos);
+        req.query_string = full_path.substr(query_pos + 1);
+        parse_query_string(req.query_string, req.query);
+    } else {
+        req.path = full_path;
+    }
+
+    // Parse headers
+    auto header_end = raw_data.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        return std::unexpected("Malformed headers");
+    }
+
+    auto headers_section = raw_data.substr(line_end + 2, header_end - line_end - 2);
+    std::istringstream header_stream(headers_section);
+    std::string header_line;
+
+    while (std::getline(header_stream, header_line)) {
+        // Remove trailing \r
+        if (!header_line.empty() && header_line.back() == '\r') {
+            header_line.pop_back();
+        }
+        if (header_line.empty()) continue;
+
+        auto colon = header_line.find(':');
+        if (colon == std::string::npos) continue;
+
+        auto key = header_line.substr(0, colon);
+        auto value = header_line.substr(colon + 1);
+
+        // Lowercase the key
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        // Trim leading whitespace from value
+        auto val_start = value.find_first_not_of(" \t");
+        if (val_start != std::string::npos) {
+            value = value.substr(val_start);
+        }
+
+        req.headers[key] = value;
+    }
+
+    // Extract body
+    auto body_start = header_end + 4;
+    if (body_start < raw_data.size()) {
+        req.body = raw_data.substr(body_start);
+    }
+
+    return req;
+}
+
+void parse_query_string(
+    const std::string& query_string,
+    std::unordered_map<std::string, std::string>& out
+) {
+    std::istringstream stream(query_string);
+    std::string pair;
+
+    while (std::getline(stream, pair, '&')) {
+        auto eq = pair.find('=');
+        if (eq != std::string::npos) {
+            auto key = url_decode(pair.substr(0, eq));
+            auto value = url_decode(pair.substr(eq + 1));
+            out[key] = value;
+        } else {
+            out[url_decode(pair)] = "";
+        }
+    }
+}
+
+std::string url_decode(const std::string& encoded) {
+    auto hex_value = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    std::string result;
+    result.reserve(encoded.size());
+
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size()) {
+            int hi = hex_value(encoded[i + 1]);
+            int lo = hex_value(encoded[i + 2]);
+            if (hi >= 0 && lo >= 0) {
+                result += static_cast<char>((hi << 4) | lo);
+                i += 2;
+            } else {
+                // Malformed escape: keep the '%' literally instead of throwing.
+                result += encoded[i];
+            }
+        } else if (encoded[i] == '+') {
+            result += ' ';
+        } else {
+            result += encoded[i];
+        }
+    }
+
+    return result;
+}
+
+} // namespace legacy
+
+namespace {
+
+// Load '###'-separated records, convert to CRLF and add Content-Length for bodies
+std::vector<std::string> load_corpus(const std::string& file) {
+    std::ifstream in(file);
+    std::vector<std::string> records;
+    std::vector<std::string> lines;
+
+    auto flush = [&] {
+        if (lines.empty()) return;
+        auto blank = std::find(lines.begin(), lines.end(), std::string{});
+        std::string body;
+        for (auto it = (blank == lines.end()) ? lines.end() : blank + 1; it != lines.end(); ++it) {
+            body += *it;
+        }
+
+        std::string request;
+        for (auto it = lines.begin(); it != blank; ++it) {
+            request += *it + "\r\n";
+        }
+        if (!body.empty()) {
+            request += "content-length: " + std::to_string(body.size()) + "\r\n";
+        }
+        request += "\r\n" + body;
+        records.push_back(std::move(request));
+        lines.clear();
+    };
+
+    std::string line;
+    bool in_record = false;
+    while (std::getline(in, line)) {
+        if (line == "###") {
+            flush();
+            in_record = true;
+            continue;
+        }
+        if (!in_record || (!line.empty() && line[0] == '#')) continue;
+        lines.push_back(line);
+    }
+    flush();
+
+    // Drop trailing blank lines that separate records
+    for (auto& record : records) {
+        while (record.size() > 4 && record.ends_with("\r\n\r\n\r\n")) {
+            record.resize(record.size() - 2);
+        }
+    }
+    return records;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string corpus_path = (argc > 1) ? argv[1] : BENCH_CORPUS_DIR "/mcp_session.http";
+    auto corpus = load_corpus(corpus_path);
+    if (corpus.empty()) {
+        std::fprintf(stderr, "no requests loaded from %s\n", corpus_path.c_str());
+        return 1;
+    }
+
+    size_t corpus_bytes = 0;
+    for (const auto& request : corpus) {
+        corpus_bytes += request.size();
+    }
+    std::printf("%zu requests, %zu bytes (%s)\n\n", corpus.size(), corpus_bytes, corpus_path.c_str());
+
+    for (const auto& raw : corpus) {
+        auto req = c_http_server::parse_request(raw);
+        if (!req.has_value() || req->get_header("host").empty()) {
+            std::fprintf(stderr, "corpus request does not parse:\n%s\n", raw.c_str());
+            return 1;
+        }
+    }
+
+    constexpr size_t iterations = 20'000;
+
+    // Both parsers start from a fresh copy of the bytes, as the server hands
+    // each framed request over from its receive buffer.
+    auto legacy_ns = bench::ns_per_op(iterations, [&] {
+        for (const auto& raw : corpus) {
+            std::string copy = raw;
+            auto req = legacy::parse_request(copy);
+            bench::do_not_optimize(req->get_query("address"));
+            bench::do_not_optimize(req->get_query("size"));
+            bench::do_not_optimize(req->get_header("authorization"));
+            bench::do_not_optimize(req->get_header("connection"));
+        }
+    });
+
+    auto view_ns = bench::ns_per_op(iterations, [&] {
+        for (const auto& raw : corpus) {
+            auto req = c_http_server::parse_request(std::string(raw));
+            bench::do_not_optimize(req->get_query("address"));
+            bench::do_not_optimize(req->get_query("size"));
+            bench::do_not_optimize(req->get_header("authorization"));
+            bench::do_not_optimize(req->get_header("connection"));
+        }
+    });
+
+    auto report = [&](const char* name, double ns_per_corpus) {
+        double per_request = ns_per_corpus / static_cast<double>(corpus.size());
+        double mb_per_s = static_cast<double>(corpus_bytes) / ns_per_corpus * 1e3;
+        std::printf("%-22s %10.1f ns/req %10.0f req/s %9.1f MB/s\n",
+                    name, per_request, 1e9 / per_request, mb_per_s);
+    };
+
+    report("copying parser", legacy_ns);
+    report("view parser", view_ns);
+    std::printf("\nspeedup: %.1fx\n", legacy_ns / view_ns);
+    return 0;
+}
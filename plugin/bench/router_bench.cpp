@@ -0,0 +1,266 @@
+// Route dispatch microbenchmark: the hashed route table in c_http_router
+// against the linear method+path scan it replaced.
+//
+// Build: cmake -S plugin -B build-bench && cmake --build build-bench --target router_bench
+
+#include "http/c_http_router.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct s_route_spec {
+    const char* method;
+    const char* path;
+};
+
+// Every route the plugin registers (snapshot of the handlers/ tree)
+const s_route_spec k_routes[] = {
+    {"GET", "/api/process/details"},
+    {"GET", "/api/process/cmdline"},
+    {"POST", "/api/process/set_cmdline"},
+    {"GET", "/api/process/elevated"},
+    {"GET", "/api/process/dbversion"},
+    {"POST", "/api/dump/module"},
+    {"GET", "/api/dump/pe_header"},
+    {"GET", "/api/dump/sections"},
+    {"GET", "/api/dump/imports"},
+    {"GET", "/api/dump/exports"},
+    {"POST", "/api/dump/fix_iat"},
+    {"GET", "/api/dump/relocations"},
+    {"POST", "/api/patches/export_file"},
+    {"GET", "/api/dump/entry_point"},
+    {"GET", "/api/analysis/function"},
+    {"GET", "/api/analysis/xrefs_to"},
+    {"GET", "/api/analysis/xrefs_from"},
+    {"GET", "/api/analysis/basic_blocks"},
+    {"GET", "/api/analysis/constants"},
+    {"GET", "/api/analysis/error_codes"},
+    {"GET", "/api/analysis/watch"},
+    {"GET", "/api/analysis/structs"},
+    {"GET", "/api/analysis/source"},
+    {"GET", "/api/analysis/va_to_file"},
+    {"GET", "/api/analysis/file_to_va"},
+    {"GET", "/api/analysis/mnemonic_brief"},
+    {"GET", "/api/analysis/strings"},
+    {"GET", "/api/patches/list"},
+    {"POST", "/api/patches/apply"},
+    {"POST", "/api/patches/restore"},
+    {"POST", "/api/patches/export"},
+    {"POST", "/api/search/pattern"},
+    {"POST", "/api/search/string"},
+    {"GET", "/api/search/string_at"},
+    {"POST", "/api/search/auto_complete"},
+    {"GET", "/api/search/encode_type"},
+    {"GET", "/api/modules/list"},
+    {"GET", "/api/modules/get"},
+    {"GET", "/api/modules/base"},
+    {"GET", "/api/modules/section"},
+    {"GET", "/api/modules/party"},
+    {"GET", "/api/symbols/resolve"},
+    {"GET", "/api/symbols/at"},
+    {"GET", "/api/symbols/search"},
+    {"GET", "/api/symbols/list"},
+    {"GET", "/api/handles/list"},
+    {"GET", "/api/handles/get"},
+    {"GET", "/api/handles/tcp"},
+    {"GET", "/api/handles/windows"},
+    {"GET", "/api/handles/heaps"},
+    {"POST", "/api/handles/close"},
+    {"GET", "/api/debug/state"},
+    {"POST", "/api/debug/run"},
+    {"POST", "/api/debug/pause"},
+    {"POST", "/api/debug/step_into"},
+    {"POST", "/api/debug/step_over"},
+    {"POST", "/api/debug/step_out"},
+    {"POST", "/api/debug/stop"},
+    {"POST", "/api/debug/restart"},
+    {"POST", "/api/debug/force_pause"},
+    {"POST", "/api/debug/run_to"},
+    {"GET", "/api/registers/all"},
+    {"GET", "/api/registers/get"},
+    {"POST", "/api/registers/set"},
+    {"GET", "/api/registers/flags"},
+    {"GET", "/api/registers/avx512"},
+    {"GET", "/api/antidebug/peb"},
+    {"GET", "/api/antidebug/teb"},
+    {"POST", "/api/antidebug/hide_debugger"},
+    {"GET", "/api/antidebug/dep_status"},
+    {"GET", "/api/memmap/list"},
+    {"GET", "/api/memmap/at"},
+    {"GET", "/api/cfg/function"},
+    {"GET", "/api/cfg/branch_dest"},
+    {"GET", "/api/cfg/is_jump_taken"},
+    {"GET", "/api/cfg/loops"},
+    {"POST", "/api/cfg/add_function"},
+    {"POST", "/api/cfg/delete_function"},
+    {"GET", "/api/cfg/func_type"},
+    {"POST", "/api/exceptions/set_bp"},
+    {"POST", "/api/exceptions/delete_bp"},
+    {"GET", "/api/exceptions/list_bps"},
+    {"GET", "/api/exceptions/list_codes"},
+    {"POST", "/api/exceptions/skip"},
+    {"GET", "/api/trace/status"},
+    {"POST", "/api/trace/into"},
+    {"POST", "/api/trace/over"},
+    {"POST", "/api/trace/run"},
+    {"POST", "/api/trace/stop"},
+    {"GET", "/api/trace/record/hitcount"},
+    {"GET", "/api/trace/record/type"},
+    {"POST", "/api/trace/record/set_type"},
+    {"POST", "/api/trace/animate"},
+    {"POST", "/api/trace/conditional_run"},
+    {"POST", "/api/trace/log"},
+    {"GET", "/api/labels/get"},
+    {"POST", "/api/labels/set"},
+    {"GET", "/api/comments/get"},
+    {"POST", "/api/comments/set"},
+    {"POST", "/api/bookmarks/set"},
+    {"POST", "/api/command/exec"},
+    {"POST", "/api/command/eval"},
+    {"POST", "/api/command/format"},
+    {"GET", "/api/command/events"},
+    {"POST", "/api/command/init_script"},
+    {"GET", "/api/command/init_script"},
+    {"GET", "/api/command/hash"},
+    {"POST", "/api/command/script"},
+    {"GET", "/api/memory/read"},
+    {"POST", "/api/memory/write"},
+    {"GET", "/api/memory/is_valid"},
+    {"GET", "/api/memory/page_info"},
+    {"POST", "/api/memory/allocate"},
+    {"POST", "/api/memory/free"},
+    {"POST", "/api/memory/protect"},
+    {"GET", "/api/memory/is_code"},
+    {"POST", "/api/memory/update_map"},
+    {"GET", "/api/stack/trace"},
+    {"GET", "/api/stack/read"},
+    {"GET", "/api/stack/pointers"},
+    {"GET", "/api/stack/comment"},
+    {"GET", "/api/stack/callstack_thread"},
+    {"GET", "/api/stack/return_address"},
+    {"GET", "/api/stack/seh_chain"},
+    {"GET", "/api/breakpoints/list"},
+    {"GET", "/api/breakpoints/get"},
+    {"POST", "/api/breakpoints/set"},
+    {"POST", "/api/breakpoints/set_hardware"},
+    {"POST", "/api/breakpoints/set_memory"},
+    {"POST", "/api/breakpoints/delete"},
+    {"POST", "/api/breakpoints/enable"},
+    {"POST", "/api/breakpoints/disable"},
+    {"POST", "/api/breakpoints/toggle"},
+    {"POST", "/api/breakpoints/set_condition"},
+    {"POST", "/api/breakpoints/set_log"},
+    {"POST", "/api/breakpoints/configure"},
+    {"POST", "/api/breakpoints/configure_batch"},
+    {"POST", "/api/breakpoints/reset_hit_count"},
+    {"GET", "/api/disasm/at"},
+    {"GET", "/api/disasm/function"},
+    {"GET", "/api/disasm/basic"},
+    {"POST", "/api/disasm/assemble"},
+    {"GET", "/api/threads/list"},
+    {"GET", "/api/threads/current"},
+    {"GET", "/api/threads/get"},
+    {"GET", "/api/threads/{id}"},
+    {"POST", "/api/threads/switch"},
+    {"POST", "/api/threads/suspend"},
+    {"POST", "/api/threads/resume"},
+    {"GET", "/api/threads/count"},
+    {"GET", "/api/threads/teb"},
+    {"GET", "/api/threads/name"},
+    {"GET", "/api/health"},
+    {"GET", "/api/process/info"},
+};
+
+// The previous dispatch strategy: compare method and path against every route
+class c_linear_router {
+public:
+    void add_route(const std::string& method, const std::string& path, route_handler_t handler) {
+        m_routes.push_back({method, path, std::move(handler)});
+    }
+
+    [[nodiscard]] const route_handler_t* find(const std::string& method, const std::string& path) const {
+        for (const auto& route : m_routes) {
+            if (route.method == method && route.path == path) {
+                return &route.handler;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    struct s_route {
+        std::string method;
+        std::string path;
+        route_handler_t handler;
+    };
+    std::vector<s_route> m_routes;
+};
+
+s_http_response noop_handler(const s_http_request&) {
+    return {};
+}
+
+} // namespace
+
+int main() {
+    c_http_router router;
+    c_linear_router linear;
+    for (const auto& route : k_routes) {
+        router.add_route(route.method, route.path, noop_handler);
+        if (std::string_view(route.path).find('{') == std::string_view::npos) {
+            linear.add_route(route.method, route.path, noop_handler);
+        }
+    }
+
+    struct s_case {
+        const char* name;
+        std::string method;
+        std::string path;
+    };
+    const s_case cases[] = {
+        {"first route", k_routes[0].method, k_routes[0].path},
+        {"middle route", k_routes[std::size(k_routes) / 2].method, k_routes[std::size(k_routes) / 2].path},
+        {"last route", k_routes[std::size(k_routes) - 1].method, k_routes[std::size(k_routes) - 1].path},
+        {"unknown path", "GET", "/api/does/not/exist"},
+    };
+
+    std::printf("%zu routes registered\n\n", std::size(k_routes));
+    std::printf("%-22s %14s %14s %9s\n", "case", "linear ns/op", "table ns/op", "speedup");
+
+    constexpr size_t iterations = 2'000'000;
+    for (const auto& c : cases) {
+        auto linear_ns = bench::ns_per_op(iterations, [&] {
+            bench::do_not_optimize(linear.find(c.method, c.path));
+        });
+
+        s_http_request::view_pairs params;
+        auto table_ns = bench::ns_per_op(iterations, [&] {
+            bench::do_not_optimize(router.find(c.method, c.path, params));
+        });
+
+        std::printf("%-22s %14.1f %14.1f %8.1fx\n", c.name, linear_ns, table_ns, linear_ns / table_ns);
+    }
+
+    // Templated route: trie walk plus capturing the parameter
+    s_http_request::view_pairs params;
+    auto param_ns = bench::ns_per_op(iterations, [&] {
+        params.clear();
+        bench::do_not_optimize(router.find("GET", "/api/threads/1234", params));
+    });
+    std::printf("%-22s %14s %14.1f\n", "/api/threads/{id}", "n/a", param_ns);
+
+    // Full dispatch (lookup + handler call + exception guard)
+    s_http_request request;
+    request.method = "GET";
+    request.path = "/api/process/info";
+    auto dispatch_ns = bench::ns_per_op(iterations, [&] {
+        bench::do_not_optimize(router.dispatch(request));
+    });
+    std::printf("%-22s %14s %14.1f\n", "dispatch()", "", dispatch_ns);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "http/c_json_writer.h"
+
+// Stand-in for c_bridge_executor with canned answers, so the HTTP stack can
+// be load-tested without x64dbg. Payloads have the size and shape of what a
+// paused 64-bit target returns; their content is synthetic and deterministic.
+class c_stub_bridge {
+public:
+    static constexpr uint64_t IMAGE_BASE = 0x00007FF6A1B20000;
+
+    [[nodiscard]] static std::string format_address(uint64_t address) {
+        char text[24];
+        std::snprintf(text, sizeof(text), "0x%016llX", static_cast<unsigned long long>(address));
+        return text;
+    }
+
+    // Like c_bridge_executor::read_memory: `size` bytes starting at `address`
+    [[nodiscard]] std::vector<uint8_t> read_memory(uint64_t address, size_t size) const {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>((address + i) * 131 >> 3);
+        }
+        return bytes;
+    }
+
+    // The document /api/registers/all builds from a register dump
+    [[nodiscard]] nlohmann::json registers() const {
+        static const char* const gprs[] = {
+            "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+            "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "rip"
+        };
+        nlohmann::json regs;
+        uint64_t value = 0x000000C3D5AFF6E8;
+        for (const char* name : gprs) {
+            regs[name] = format_address(value);
+            value = value * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        regs["eflags"] = format_address(0x246);
+        for (const char* name : {"cs", "ds", "es", "fs", "gs", "ss"}) {
+            regs[name] = 0x2B;
+        }
+        for (const char* name : {"dr0", "dr1", "dr2", "dr3", "dr6", "dr7"}) {
+            regs[name] = format_address(0);
+        }
+        return regs;
+    }
+
+    // Like c_bridge_executor::s_instruction
+    struct s_instruction {
+        uint64_t address = 0;
+        const char* text = "";
+        int size = 0;
+        int type = 0;
+        bool is_branch = false;
+        bool is_call = false;
+        const char* label = "";
+        const char* comment = "";
+    };
+
+    // Like c_bridge_executor::for_each_instruction
+    template <typename F>
+    void for_each_instruction(uint64_t address, int count, F&& visit) const {
+        static const char* const listing[] = {
+            "push rbx", "sub rsp, 0x20", "mov rbx, rcx", "call 0x00007FF6A1B21460",
+            "test eax, eax", "je 0x00007FF6A1B2104A", "mov rcx, qword ptr ds:[rbx+0x10]",
+            "lea rdx, qword ptr ss:[rsp+0x30]", "xor r8d, r8d", "add rsp, 0x20", "pop rbx", "ret"
+        };
+        for (int i = 0; i < count; ++i) {
+            const char* text = listing[i % std::size(listing)];
+            const bool is_call = text[0] == 'c';
+            const bool is_branch = is_call || text[0] == 'j' || text[0] == 'r';
+            const int size = 3 + i % 5;
+            if (!visit(s_instruction{address, text, size, 1, is_branch, is_call, i == 0 ? "module.entry" : "", ""})) {
+                return;
+            }
+            address += static_cast<uint64_t>(size);
+        }
+    }
+
+    // One entry of a module's symbol listing
+    void symbol(size_t index, c_json_writer& out) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "module.sub_%zu", 0x1000 + index * 0x40);
+        out.begin_object()
+           .address_field("address", IMAGE_BASE + 0x1000 + index * 0x40)
+           .field("decorated", false)
+           .field("name",      name)
+           .field("type",      index % 7 == 0 ? "export" : "function")
+           .end_object();
+    }
+};
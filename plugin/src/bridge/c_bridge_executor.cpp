@@ -86,7 +86,7 @@ std::expected<std::vector<uint8_t>, std::string> c_bridge_executor::read_memory(
     return buffer;
 }
 
-std::expected<void, std::string> c_bridge_executor::write_memory(duint address, const std::vector<uint8_t>& data) {
+std::expected<void, std::string> c_bridge_executor::write_memory(duint address, std::span<const uint8_t> data) {
     if (data.empty()) {
         return std::unexpected("No data to write");
     }
@@ -112,31 +112,56 @@ std::expected<REGDUMP, std::string> c_bridge_executor::get_register_dump() {
 }
 
 std::expected<nlohmann::json, std::string> c_bridge_executor::get_memory_map() {
+    auto result = nlohmann::json::array();
+    auto visited = for_each_memory_region([&result](const s_memory_region& region) {
+        result.push_back({
+            {"base",             format_utils::format_address(region.base)},
+            {"allocation_base",  format_utils::format_address(region.allocation_base)},
+            {"size",             region.size},
+            {"size_hex",         format_utils::format_hex(region.size)},
+            {"state",            format_utils::format_mem_state(region.state)},
+            {"protect",          format_utils::format_protection(region.protect)},
+            {"type",             format_utils::format_mem_type(region.type)},
+            {"info",             region.info}
+        });
+        return true;
+    });
+    if (!visited.has_value()) {
+        return std::unexpected(visited.error());
+    }
+
+    return result;
+}
+
+std::expected<void, std::string> c_bridge_executor::for_each_memory_region(
+    const std::function<bool(const s_memory_region& region)>& visit
+) {
     MEMMAP memmap{};
     if (!DbgMemMap(&memmap)) {
         return std::unexpected("Failed to get memory map");
     }
 
-    auto result = nlohmann::json::array();
     for (int i = 0; i < memmap.count; ++i) {
         const auto& page = memmap.page[i];
-        result.push_back({
-            {"base",             format_utils::format_address(reinterpret_cast<duint>(page.mbi.BaseAddress))},
-            {"allocation_base",  format_utils::format_address(reinterpret_cast<duint>(page.mbi.AllocationBase))},
-            {"size",             static_cast<duint>(page.mbi.RegionSize)},
-            {"size_hex",         format_utils::format_hex(static_cast<duint>(page.mbi.RegionSize))},
-            {"state",            format_utils::format_mem_state(page.mbi.State)},
-            {"protect",          format_utils::format_protection(page.mbi.Protect)},
-            {"type",             format_utils::format_mem_type(page.mbi.Type)},
-            {"info",             page.info}
+        bool keep_going = visit({
+            reinterpret_cast<duint>(page.mbi.BaseAddress),
+            reinterpret_cast<duint>(page.mbi.AllocationBase),
+            static_cast<duint>(page.mbi.RegionSize),
+            page.mbi.State,
+            page.mbi.Protect,
+            page.mbi.Type,
+            page.info
         });
+        if (!keep_going) {
+            break;
+        }
     }
 
     if (memmap.page) {
         BridgeFree(memmap.page);
     }
 
-    return result;
+    return {};
 }
 
 std::expected<nlohmann::json, std::string> c_bridge_executor::get_breakpoint_list(BPXTYPE type) {
@@ -236,6 +261,26 @@ bool c_bridge_executor::set_bookmark_at(duint address, bool set) {
 
 std::expected<nlohmann::json, std::string> c_bridge_executor::disassemble_at(duint address, int count) {
     auto instructions = nlohmann::json::array();
+    for_each_instruction(address, count, [&instructions](const s_instruction& instr) {
+        instructions.push_back({
+            {"address",     format_utils::format_address(instr.address)},
+            {"instruction", instr.text},
+            {"size",        instr.size},
+            {"type",        instr.type},
+            {"is_branch",   instr.is_branch},
+            {"is_call",     instr.is_call},
+            {"label",       instr.label},
+            {"comment",     instr.comment}
+        });
+        return true;
+    });
+
+    return instructions;
+}
+
+void c_bridge_executor::for_each_instruction(
+    duint address, int count, const std::function<bool(const s_instruction& instr)>& visit
+) {
     auto current_addr = address;
 
     for (int i = 0; i < count; ++i) {
@@ -255,21 +300,22 @@ std::expected<nlohmann::json, std::string> c_bridge_executor::disassemble_at(dui
         char comment[MAX_COMMENT_SIZE] = {};
         DbgGetCommentAt(current_addr, comment);
 
-        instructions.push_back({
-            {"address",     format_utils::format_address(current_addr)},
-            {"instruction", instr.instruction},
-            {"size",        instr.instr_size},
-            {"type",        static_cast<int>(instr.type)},
-            {"is_branch",   basic.branch},
-            {"is_call",     basic.call},
-            {"label",       label},
-            {"comment",     comment}
+        bool keep_going = visit({
+            current_addr,
+            instr.instruction,
+            instr.instr_size,
+            static_cast<int>(instr.type),
+            static_cast<bool>(basic.branch),
+            static_cast<bool>(basic.call),
+            label,
+            comment
         });
+        if (!keep_going) {
+            break;
+        }
 
         current_addr += instr.instr_size;
     }
-
-    return instructions;
 }
 
 std::expected<nlohmann::json, std::string> c_bridge_executor::get_basic_info(duint address) {
@@ -2,8 +2,10 @@
 
 #include <string>
 #include <expected>
+#include <functional>
 #include <cstdint>
 #include <mutex>
+#include <span>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -38,15 +40,31 @@ public:
 
     // Memory operations
     [[nodiscard]] std::expected<std::vector<uint8_t>, std::string> read_memory(duint address, size_t size);
-    [[nodiscard]] std::expected<void, std::string> write_memory(duint address, const std::vector<uint8_t>& data);
+    [[nodiscard]] std::expected<void, std::string> write_memory(duint address, std::span<const uint8_t> data);
     [[nodiscard]] bool is_valid_read_ptr(duint address);
 
     // Register dump
     [[nodiscard]] std::expected<REGDUMP, std::string> get_register_dump();
 
+    // One memory map region; `info` is only valid during the visit
+    struct s_memory_region {
+        duint base = 0;
+        duint allocation_base = 0;
+        duint size = 0;
+        DWORD state = 0;
+        DWORD protect = 0;
+        DWORD type = 0;
+        const char* info = "";
+    };
+
     // Memory map
     [[nodiscard]] std::expected<nlohmann::json, std::string> get_memory_map();
 
+    // Visit each memory map region without building the whole list.
+    // The visitor returns false to stop early.
+    [[nodiscard]] std::expected<void, std::string> for_each_memory_region(
+        const std::function<bool(const s_memory_region& region)>& visit);
+
     // Breakpoint list
     [[nodiscard]] std::expected<nlohmann::json, std::string> get_breakpoint_list(BPXTYPE type);
 
@@ -60,8 +78,25 @@ public:
     [[nodiscard]] bool set_comment_at(duint address, const std::string& text);
     [[nodiscard]] bool set_bookmark_at(duint address, bool set);
 
+    // One decoded instruction; the strings are only valid during the visit
+    struct s_instruction {
+        duint address = 0;
+        const char* text = "";
+        int size = 0;
+        int type = 0;
+        bool is_branch = false;
+        bool is_call = false;
+        const char* label = "";
+        const char* comment = "";
+    };
+
     // Disassembly
     [[nodiscard]] std::expected<nlohmann::json, std::string> disassemble_at(duint address, int count);
+
+    // Decode up to `count` instructions from `address` without building
+    // JSON, stopping at the first undecodable one. The visitor returns false
+    // to stop early.
+    void for_each_instruction(duint address, int count, const std::function<bool(const s_instruction& instr)>& visit);
     [[nodiscard]] std::expected<nlohmann::json, std::string> get_basic_info(duint address);
 
     // Function analysis
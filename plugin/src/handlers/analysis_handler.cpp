@@ -1,9 +1,12 @@
 #include "http/c_http_router.h"
+#include "http/c_json_stream.h"
 #include "bridge/c_bridge_executor.h"
+#include "util/c_job_manager.h"
 #include "util/format_utils.h"
 
 #include <cstdlib>
 #include <string>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include "bridgemain.h"
 #include "_dbgfunctions.h"
@@ -19,7 +22,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
         auto bounds = bridge.get_function_bounds(address);
@@ -45,7 +48,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -99,7 +102,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -144,7 +147,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
         // Get function boundaries first
@@ -229,7 +232,7 @@ void register_analysis_routes(c_http_router& router) {
 
     // GET /api/analysis/watch?id= - Check if watchdog triggered
     router.get("/api/analysis/watch", [](const s_http_request& req) -> s_http_response {
-        auto id_str = req.get_query("id", "0");
+        std::string id_str{req.get_query("id", "0")};
         auto id = static_cast<unsigned int>(std::stoul(id_str));
 
         auto triggered = DbgFunctions()->WatchIsWatchdogTriggered(id);
@@ -262,7 +265,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
         char source_file[MAX_PATH] = {};
@@ -284,7 +287,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -306,8 +309,8 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module_name = req.get_query("module");
-        auto offset_str = req.get_query("offset");
+        std::string module_name{req.get_query("module")};
+        std::string offset_str{req.get_query("offset")};
         if (module_name.empty() || offset_str.empty()) {
             return s_http_response::bad_request("Missing 'module' and/or 'offset' query parameters");
         }
@@ -325,7 +328,7 @@ void register_analysis_routes(c_http_router& router) {
 
     // GET /api/analysis/mnemonic_brief?mnemonic= - Get mnemonic brief description
     router.get("/api/analysis/mnemonic_brief", [](const s_http_request& req) -> s_http_response {
-        auto mnemonic = req.get_query("mnemonic");
+        std::string mnemonic{req.get_query("mnemonic")};
         if (mnemonic.empty()) {
             return s_http_response::bad_request("Missing 'mnemonic' query parameter");
         }
@@ -346,7 +349,7 @@ void register_analysis_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module_name = req.get_query("module");
+        std::string module_name{req.get_query("module")};
         if (module_name.empty()) {
             return s_http_response::bad_request("Missing 'module' query parameter");
         }
@@ -358,7 +361,7 @@ void register_analysis_routes(c_http_router& router) {
 
         // Minimum run length (default 4), parsed without throwing.
         int min_len = 4;
-        auto min_str = req.get_query("min_length", "");
+        std::string min_str{req.get_query("min_length", "")};
         if (!min_str.empty()) {
             int parsed = std::atoi(min_str.c_str());
             if (parsed >= 1 && parsed <= 1024) min_len = parsed;
@@ -368,72 +371,94 @@ void register_analysis_routes(c_http_router& router) {
         constexpr duint kMaxScan = 64ull * 1024 * 1024; // cap scan to 64MB
         if (mod_size == 0 || mod_size > kMaxScan) mod_size = kMaxScan;
 
-        constexpr size_t kMaxResults = 5000;
-        constexpr size_t kChunk = 1024 * 1024;
-        auto strings = nlohmann::json::array();
-        bool truncated = false;
-
-        auto is_printable = [](uint8_t c) { return c >= 0x20 && c <= 0x7E; };
-
-        for (duint off = 0; off < mod_size && !truncated; off += kChunk) {
-            size_t want = static_cast<size_t>(
-                (mod_size - off) < kChunk ? (mod_size - off) : kChunk);
-            auto buf = bridge.read_memory(base + off, want);
-            if (!buf.has_value()) continue; // unreadable page, skip
-            const auto& b = *buf;
-            const size_t n = b.size();
-
-            // ASCII runs
-            size_t run_start = 0;
-            bool in_run = false;
-            for (size_t i = 0; i < n; ++i) {
-                if (is_printable(b[i])) {
-                    if (!in_run) { in_run = true; run_start = i; }
-                } else if (in_run) {
-                    in_run = false;
-                    if (i - run_start >= static_cast<size_t>(min_len)) {
-                        strings.push_back({
-                            {"address", format_utils::format_address(base + off + run_start)},
-                            {"type",    "ascii"},
-                            {"value",   std::string(reinterpret_cast<const char*>(b.data() + run_start), i - run_start)}
-                        });
-                        if (strings.size() >= kMaxResults) { truncated = true; break; }
+        // Results are streamed as the module is scanned, so the first strings
+        // reach the client while the rest of the image is still being read.
+        return s_http_response::chunked([module_name, base, mod_size, min_len, cancel = req.cancel](const body_writer_t& write) {
+            auto& bridge = get_bridge();
+            constexpr size_t kMaxResults = 5000;
+            constexpr size_t kChunk = 1024 * 1024;
+
+            c_json_array_stream out(write, {
+                {"module",     module_name},
+                {"base",       format_utils::format_address(base)},
+                {"min_length", min_len}
+            }, "strings");
+            bool truncated = false;
+            auto stopped = c_cancel_token::e_reason::none;
+
+            auto is_printable = [](uint8_t c) { return c >= 0x20 && c <= 0x7E; };
+
+            for (duint off = 0; off < mod_size && !truncated && out.alive(); off += kChunk) {
+                if (cancel && (stopped = cancel->reason()) != c_cancel_token::e_reason::none) {
+                    break;
+                }
+                size_t want = static_cast<size_t>(
+                    (mod_size - off) < kChunk ? (mod_size - off) : kChunk);
+                c_job_manager::report_progress(off, mod_size);
+                auto buf = bridge.read_memory(base + off, want);
+                if (!buf.has_value()) continue; // unreadable page, skip
+                const auto& b = *buf;
+                const size_t n = b.size();
+
+                // ASCII runs
+                size_t run_start = 0;
+                bool in_run = false;
+                for (size_t i = 0; i < n; ++i) {
+                    if (is_printable(b[i])) {
+                        if (!in_run) { in_run = true; run_start = i; }
+                    } else if (in_run) {
+                        in_run = false;
+                        if (i - run_start >= static_cast<size_t>(min_len)) {
+                            out.emit([&](c_json_writer& item) {
+                                item.begin_object()
+                                    .address_field("address", base + off + run_start)
+                                    .field("type",  "ascii")
+                                    .field("value", std::string_view(reinterpret_cast<const char*>(b.data() + run_start), i - run_start))
+                                    .end_object();
+                            });
+                            if (out.count() >= kMaxResults) { truncated = true; break; }
+                        }
                     }
                 }
-            }
 
-            // UTF-16LE runs (printable ASCII char followed by 0x00)
-            for (size_t i = 0; i + 1 < n && !truncated; ) {
-                if (is_printable(b[i]) && b[i + 1] == 0) {
-                    size_t start = i;
-                    std::string s;
-                    while (i + 1 < n && is_printable(b[i]) && b[i + 1] == 0) {
-                        s += static_cast<char>(b[i]);
-                        i += 2;
+                // UTF-16LE runs (printable ASCII char followed by 0x00)
+                for (size_t i = 0; i + 1 < n && !truncated; ) {
+                    if (is_printable(b[i]) && b[i + 1] == 0) {
+                        size_t start = i;
+                        std::string s;
+                        while (i + 1 < n && is_printable(b[i]) && b[i + 1] == 0) {
+                            s += static_cast<char>(b[i]);
+                            i += 2;
+                        }
+                        if (s.size() >= static_cast<size_t>(min_len)) {
+                            out.emit([&](c_json_writer& item) {
+                                item.begin_object()
+                                    .address_field("address", base + off + start)
+                                    .field("type",  "utf16")
+                                    .field("value", s)
+                                    .end_object();
+                            });
+                            if (out.count() >= kMaxResults) { truncated = true; break; }
+                        }
+                    } else {
+                        ++i;
                     }
-                    if (s.size() >= static_cast<size_t>(min_len)) {
-                        strings.push_back({
-                            {"address", format_utils::format_address(base + off + start)},
-                            {"type",    "utf16"},
-                            {"value",   s}
-                        });
-                        if (strings.size() >= kMaxResults) { truncated = true; break; }
-                    }
-                } else {
-                    ++i;
                 }
             }
-        }
 
-        return s_http_response::ok({
-            {"module",    module_name},
-            {"base",      format_utils::format_address(base)},
-            {"strings",   strings},
-            {"count",     strings.size()},
-            {"min_length", min_len},
-            {"truncated", truncated}
+            if (stopped == c_cancel_token::e_reason::none) {
+                c_job_manager::report_progress(mod_size, mod_size);
+            }
+            out.finish({
+                {"count",     out.count()},
+                {"truncated", truncated},
+                {"truncated_by_deadline", stopped == c_cancel_token::e_reason::deadline},
+                {"cancelled", stopped == c_cancel_token::e_reason::cancelled}
+            });
         });
     });
+
+    router.assign_lane("/api/analysis/strings", e_lane::bulk);
 }
 
 } // namespace handlers
@@ -14,7 +14,7 @@ void register_annotation_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -60,7 +60,7 @@ void register_annotation_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -123,6 +123,10 @@ void register_annotation_routes(c_http_router& router) {
             {"bookmarked", set}
         });
     });
+
+    router.mutating("/api/labels/set");
+    router.mutating("/api/comments/set");
+    router.mutating("/api/bookmarks/set");
 }
 
 } // namespace handlers
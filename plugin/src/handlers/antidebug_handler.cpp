@@ -16,7 +16,7 @@ void register_antidebug_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto pid_str = req.get_query("pid", "");
+        std::string pid_str{req.get_query("pid", "")};
         DWORD pid = 0;
         if (pid_str.empty()) {
             pid = static_cast<DWORD>(bridge.eval_expression("$pid"));
@@ -77,7 +77,7 @@ void register_antidebug_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto tid_str = req.get_query("tid", "");
+        std::string tid_str{req.get_query("tid", "")};
         DWORD tid = 0;
         if (tid_str.empty()) {
             tid = static_cast<DWORD>(bridge.eval_expression("$tid"));
@@ -192,6 +192,8 @@ void register_antidebug_routes(c_http_router& router) {
             {"dep_enabled", dep_enabled}
         });
     });
+
+    router.mutating("/api/antidebug/hide_debugger");
 }
 
 } // namespace handlers
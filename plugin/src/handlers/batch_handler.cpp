@@ -0,0 +1,174 @@
+#include "http/c_http_router.h"
+#include "util/c_worker_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+constexpr size_t MAX_BATCH_ENTRIES = 64;
+constexpr size_t BATCH_HELPERS = 4;         // threads shared by every parallel batch
+constexpr size_t MAX_QUEUED_HELPERS = 16;   // helper tasks waiting for one of them
+constexpr size_t MAX_HELPERS_PER_BATCH = 3; // besides the batch's own worker
+
+// Runs entries of parallel batches next to the workers that handle them, so
+// parallel batches add at most BATCH_HELPERS threads however many run
+c_worker_pool g_batch_helpers;
+
+// Routes that run other requests: a shared-memory fetch runs a batch, and
+// a job any request. As entries they would nest batches without limit.
+constexpr std::array<std::string_view, 2> NESTING_PREFIXES = {"/api/shm/", "/api/jobs/"};
+
+std::expected<s_http_request, std::string> build_entry(const nlohmann::json& spec) {
+    auto request = s_http_request::from_spec(spec);
+    if (!request) {
+        return request;
+    }
+    if (request->path == "/api/batch") {
+        return std::unexpected("Batches cannot be nested");
+    }
+    for (auto prefix : NESTING_PREFIXES) {
+        if (request->path.starts_with(prefix)) {
+            return std::unexpected(std::string(request->path) + " cannot run inside a batch");
+        }
+    }
+    return request;
+}
+
+// Entries share the batch's cancel token: cancelling the batch, or its
+// deadline passing, stops whichever entry is running
+nlohmann::json run_entry(const c_http_router& router, const nlohmann::json& spec,
+                         const std::shared_ptr<c_cancel_token>& cancel) {
+    auto request = build_entry(spec);
+    if (!request) {
+        return *s_http_response::bad_request(request.error()).document;
+    }
+    request->cancel = cancel;
+
+    try {
+        return s_http_response::to_envelope(router.dispatch(*request));
+    } catch (const std::exception& e) {
+        return *s_http_response::internal_error(std::string("Handler exception: ") + e.what()).document;
+    }
+}
+
+bool is_failure(const nlohmann::json& envelope) {
+    return !envelope.value("success", false);
+}
+
+// One batch's entries and results. Helpers hold it, so one that starts
+// after the batch has finished finds nothing left and touches nothing else.
+struct s_batch {
+    s_batch(const c_http_router& batch_router, nlohmann::json entries,
+            std::shared_ptr<c_cancel_token> token, bool stop_early)
+        : router(batch_router), specs(std::move(entries)), cancel(std::move(token)),
+          stop_on_error(stop_early), results(specs.size()) {}
+
+    const c_http_router& router;
+    const nlohmann::json specs;
+    const std::shared_ptr<c_cancel_token> cancel;
+    const bool stop_on_error;
+    const nlohmann::json skipped = *s_http_response::error(424, "Skipped: an earlier request failed").document;
+
+    std::vector<nlohmann::json> results;
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+
+    std::mutex mutex;
+    std::condition_variable finished_cv;
+    size_t finished = 0; // entries with a result
+
+    // Take entries in order until none are left; once one fails, entries
+    // not yet started are skipped
+    void drain() {
+        for (size_t i = next.fetch_add(1); i < specs.size(); i = next.fetch_add(1)) {
+            if (stop_on_error && failed.load()) {
+                results[i] = skipped;
+            } else {
+                results[i] = run_entry(router, specs[i], cancel);
+                if (is_failure(results[i])) {
+                    failed.store(true);
+                }
+            }
+
+            std::lock_guard lock(mutex);
+            if (++finished == specs.size()) {
+                finished_cv.notify_all();
+            }
+        }
+    }
+
+    // Entries taken by helpers may still be running after drain() returns
+    void wait() {
+        std::unique_lock lock(mutex);
+        finished_cv.wait(lock, [this] { return finished == specs.size(); });
+    }
+};
+
+} // namespace
+
+namespace handlers {
+
+void register_batch_routes(c_http_router& router) {
+    // POST /api/batch - Run several requests in one round trip
+    // Body: {"requests": [{"method":"GET","path":"/api/registers/get","query":{..},"body":{..}}, ...],
+    //        "parallel": false, "stop_on_error": false}
+    // Returns the entries' envelopes in order. "parallel" runs entries that do
+    // not depend on each other concurrently; with "stop_on_error", entries
+    // after a failure are not run and report 424. Entries cannot be batches,
+    // shared-memory or job routes.
+    router.post("/api/batch", [&router](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object() || !body.contains("requests") || !body["requests"].is_array()) {
+            return s_http_response::bad_request("Missing 'requests' array");
+        }
+
+        if (body["requests"].size() > MAX_BATCH_ENTRIES) {
+            return s_http_response::bad_request("At most " + std::to_string(MAX_BATCH_ENTRIES) + " requests per batch");
+        }
+        bool parallel = body.value("parallel", false);
+        bool stop_on_error = body.value("stop_on_error", false);
+
+        auto batch = std::make_shared<s_batch>(router, std::move(body["requests"]), req.cancel, stop_on_error);
+        const size_t count = batch->specs.size();
+
+        // Helpers join in when the shared pool has room; this worker runs
+        // whatever they do not get to, so a busy pool only costs parallelism
+        if (parallel && count > 1) {
+            g_batch_helpers.start(BATCH_HELPERS, MAX_QUEUED_HELPERS);
+            for (size_t h = 0; h < std::min(MAX_HELPERS_PER_BATCH, count - 1); ++h) {
+                if (!g_batch_helpers.try_submit([batch] { batch->drain(); })) {
+                    break;
+                }
+            }
+        }
+        batch->drain();
+        batch->wait();
+
+        auto& results = batch->results;
+        size_t failures = std::count_if(results.begin(), results.end(), is_failure);
+        return s_http_response::ok({
+            {"results", std::move(results)},
+            {"count",   count},
+            {"failed",  failures}
+        });
+    });
+
+    // Entries run inline, so a batch can hold its worker for a long time
+    router.assign_lane("/api/batch", e_lane::bulk);
+}
+
+void stop_batch_helpers() {
+    g_batch_helpers.stop();
+}
+
+} // namespace handlers
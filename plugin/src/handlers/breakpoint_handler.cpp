@@ -82,7 +82,7 @@ void register_breakpoint_routes(c_http_router& router) {
     // GET /api/breakpoints/get?address=0x... - Get breakpoint at address
     router.get("/api/breakpoints/get", [](const s_http_request& req) -> s_http_response {
         auto& bridge = get_bridge();
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -437,6 +437,19 @@ void register_breakpoint_routes(c_http_router& router) {
             {"hit_count", 0}
         });
     });
+
+    router.mutating("/api/breakpoints/set");
+    router.mutating("/api/breakpoints/set_hardware");
+    router.mutating("/api/breakpoints/set_memory");
+    router.mutating("/api/breakpoints/delete");
+    router.mutating("/api/breakpoints/enable");
+    router.mutating("/api/breakpoints/disable");
+    router.mutating("/api/breakpoints/toggle");
+    router.mutating("/api/breakpoints/set_condition");
+    router.mutating("/api/breakpoints/set_log");
+    router.mutating("/api/breakpoints/configure");
+    router.mutating("/api/breakpoints/configure_batch");
+    router.mutating("/api/breakpoints/reset_hit_count");
 }
 
 } // namespace handlers
@@ -154,6 +154,12 @@ void register_command_routes(c_http_router& router) {
             {"failed",    failed}
         });
     });
+
+    router.mutating("/api/command/exec");
+    router.mutating("/api/command/eval");
+    router.mutating("/api/command/format");
+    router.mutating("/api/command/init_script");
+    router.mutating("/api/command/script");
 }
 
 } // namespace handlers
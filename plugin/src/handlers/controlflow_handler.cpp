@@ -1,7 +1,9 @@
 #include "http/c_http_router.h"
+#include "http/c_json_writer.h"
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include "bridgemain.h"
 #include "_dbgfunctions.h"
@@ -9,6 +11,23 @@
 
 namespace handlers {
 
+namespace {
+
+// format_utils::format_bytes_hex() without the stream, for the instruction
+// bytes of every node
+std::string_view bytes_hex(const uint8_t* data, size_t size, char* out) {
+    static constexpr char digits[] = "0123456789ABCDEF";
+    char* p = out;
+    for (size_t i = 0; i < size; ++i) {
+        if (i > 0) *p++ = ' ';
+        *p++ = digits[data[i] >> 4];
+        *p++ = digits[data[i] & 0xF];
+    }
+    return {out, static_cast<size_t>(p - out)};
+}
+
+} // namespace
+
 void register_controlflow_routes(c_http_router& router) {
     // GET /api/cfg/function?address= - Get control flow graph
     router.get("/api/cfg/function", [](const s_http_request& req) -> s_http_response {
@@ -17,7 +36,7 @@ void register_controlflow_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
         BridgeCFGraphList graph_list{};
@@ -27,39 +46,42 @@ void register_controlflow_routes(c_http_router& router) {
 
         BridgeCFGraph graph(&graph_list, true);
 
-        auto nodes = nlohmann::json::array();
+        // Large functions have thousands of instructions across their nodes;
+        // write them straight into the body
+        c_json_envelope out(16 * 1024);
+        auto& data = out.data();
+        data.begin_object()
+            .address_field("entry_point", graph.entryPoint)
+            .field("node_count", graph.nodes.size())
+            .key("nodes").begin_array();
         for (const auto& [start, node] : graph.nodes) {
-            auto exits = nlohmann::json::array();
+            data.begin_object()
+                .address_field("brfalse", node.brfalse)
+                .address_field("brtrue",  node.brtrue)
+                .address_field("end",     node.end)
+                .key("exits").begin_array();
             for (auto exit_addr : node.exits) {
-                exits.push_back(format_utils::format_address(exit_addr));
+                data.address(exit_addr);
             }
-
-            auto instrs = nlohmann::json::array();
+            data.end_array()
+                .field("indirectcall", node.indirectcall)
+                .key("instructions").begin_array();
             for (const auto& instr : node.instrs) {
-                instrs.push_back({
-                    {"address", format_utils::format_address(instr.addr)},
-                    {"data",    format_utils::format_bytes_hex(instr.data, sizeof(instr.data))}
-                });
+                char hex[sizeof(instr.data) * 3];
+                data.begin_object()
+                    .address_field("address", instr.addr)
+                    .field("data", bytes_hex(instr.data, sizeof(instr.data), hex))
+                    .end_object();
             }
-
-            nodes.push_back({
-                {"start",          format_utils::format_address(node.start)},
-                {"end",            format_utils::format_address(node.end)},
-                {"brtrue",         format_utils::format_address(node.brtrue)},
-                {"brfalse",        format_utils::format_address(node.brfalse)},
-                {"terminal",       node.terminal},
-                {"split",          node.split},
-                {"indirectcall",   node.indirectcall},
-                {"exits",          exits},
-                {"instructions",   instrs}
-            });
+            data.end_array()
+                .field("split",    node.split)
+                .address_field("start", node.start)
+                .field("terminal", node.terminal)
+                .end_object();
         }
-
-        return s_http_response::ok({
-            {"entry_point", format_utils::format_address(graph.entryPoint)},
-            {"nodes",       nodes},
-            {"node_count",  nodes.size()}
-        });
+        data.end_array()
+            .end_object();
+        return out.finish();
     });
 
     // GET /api/cfg/branch_dest?address= - Get branch destination
@@ -69,7 +91,7 @@ void register_controlflow_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
         auto dest = DbgGetBranchDestination(address);
 
@@ -92,7 +114,7 @@ void register_controlflow_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
         auto will_execute = DbgIsJumpGoingToExecute(address);
 
@@ -109,7 +131,7 @@ void register_controlflow_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
         auto loops = nlohmann::json::array();
@@ -185,7 +207,7 @@ void register_controlflow_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
         auto func_type = DbgGetFunctionTypeAt(address);
 
@@ -205,6 +227,9 @@ void register_controlflow_routes(c_http_router& router) {
             {"type_id",   static_cast<int>(func_type)}
         });
     });
+
+    router.mutating("/api/cfg/add_function");
+    router.mutating("/api/cfg/delete_function");
 }
 
 } // namespace handlers
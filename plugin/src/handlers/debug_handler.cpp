@@ -209,6 +209,20 @@ void register_debug_routes(c_http_router& router) {
             {"target", address_str}
         });
     });
+
+    // Must answer while scans hold the bulk workers
+    router.assign_lane("/api/debug/state", e_lane::control);
+    router.assign_lane("/api/debug/pause", e_lane::control);
+    router.assign_lane("/api/debug/force_pause", e_lane::control);
+    router.mutating("/api/debug/run");
+    router.mutating("/api/debug/pause");
+    router.mutating("/api/debug/step_into");
+    router.mutating("/api/debug/step_over");
+    router.mutating("/api/debug/step_out");
+    router.mutating("/api/debug/stop");
+    router.mutating("/api/debug/restart");
+    router.mutating("/api/debug/force_pause");
+    router.mutating("/api/debug/run_to");
 }
 
 } // namespace handlers
@@ -1,4 +1,5 @@
 #include "http/c_http_router.h"
+#include "http/c_json_writer.h"
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
@@ -6,6 +7,25 @@
 
 namespace handlers {
 
+namespace {
+
+// Same fields, in the same order, as c_bridge_executor::disassemble_at()
+// dumps them
+void write_instruction(c_json_writer& out, const c_bridge_executor::s_instruction& instr) {
+    out.begin_object()
+       .address_field("address", instr.address)
+       .field("comment",     instr.comment)
+       .field("instruction", instr.text)
+       .field("is_branch",   instr.is_branch)
+       .field("is_call",     instr.is_call)
+       .field("label",       instr.label)
+       .field("size",        instr.size)
+       .field("type",        instr.type)
+       .end_object();
+}
+
+} // namespace
+
 void register_disasm_routes(c_http_router& router) {
     // GET /api/disasm/at?address=0x...&count=10 - Disassemble N instructions
     router.get("/api/disasm/at", [](const s_http_request& req) -> s_http_response {
@@ -14,8 +34,8 @@ void register_disasm_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
-        auto count_str = req.get_query("count", "10");
+        std::string address_str{req.get_query("address", "cip")};
+        std::string count_str{req.get_query("count", "10")};
 
         auto address = bridge.eval_expression(address_str);
         auto count = std::stoi(count_str);
@@ -23,16 +43,22 @@ void register_disasm_routes(c_http_router& router) {
         if (count < 1) count = 1;
         if (count > 1000) count = 1000;
 
-        auto result = bridge.disassemble_at(address, count);
-        if (!result.has_value()) {
-            return s_http_response::internal_error(result.error());
-        }
-
-        return s_http_response::ok({
-            {"address",      format_utils::format_address(address)},
-            {"count",        result->size()},
-            {"instructions", result.value()}
+        // Written straight into the body: listings run to 1000 instructions
+        c_json_envelope out(256 + static_cast<size_t>(count) * 192);
+        auto& data = out.data();
+        data.begin_object()
+            .address_field("address", address)
+            .key("instructions").begin_array();
+        size_t written = 0;
+        bridge.for_each_instruction(address, count, [&](const c_bridge_executor::s_instruction& instr) {
+            write_instruction(data, instr);
+            ++written;
+            return true;
         });
+        data.end_array()
+            .field("count", written)
+            .end_object();
+        return out.finish();
     });
 
     // GET /api/disasm/function?address=0x...&max_instructions=N - Disassemble entire function
@@ -44,10 +70,10 @@ void register_disasm_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
-        auto max_instr_str = req.get_query("max_instructions", "50");
+        std::string max_instr_str{req.get_query("max_instructions", "50")};
         auto fallback_count = std::stoi(max_instr_str);
         if (fallback_count < 1)    fallback_count = 1;
         if (fallback_count > 5000) fallback_count = 5000;
@@ -57,17 +83,21 @@ void register_disasm_routes(c_http_router& router) {
         if (!bounds.has_value()) {
             // No function boundary found - common with VMP/packed modules
             // Use max_instructions parameter so caller can control how much to see
-            auto result = bridge.disassemble_at(address, fallback_count);
-            if (!result.has_value()) {
-                return s_http_response::internal_error(result.error());
-            }
-            return s_http_response::ok({
-                {"address",          format_utils::format_address(address)},
-                {"note",             "No function boundary found (try running 'analyze' first). Showing " +
-                                     std::to_string(fallback_count) + " instructions from address."},
-                {"fallback_count",   fallback_count},
-                {"instructions",     result.value()}
+            c_json_envelope out(512 + static_cast<size_t>(fallback_count) * 192);
+            auto& data = out.data();
+            data.begin_object()
+                .address_field("address", address)
+                .field("fallback_count", fallback_count)
+                .key("instructions").begin_array();
+            bridge.for_each_instruction(address, fallback_count, [&data](const c_bridge_executor::s_instruction& instr) {
+                write_instruction(data, instr);
+                return true;
             });
+            data.end_array()
+                .field("note", "No function boundary found (try running 'analyze' first). Showing " +
+                               std::to_string(fallback_count) + " instructions from address.")
+                .end_object();
+            return out.finish();
         }
 
         auto start = format_utils::parse_address(bounds.value()["start"].get<std::string>());
@@ -77,26 +107,28 @@ void register_disasm_routes(c_http_router& router) {
         auto estimated_count = static_cast<int>((end_addr - start) / 2) + 1;
         if (estimated_count > 5000) estimated_count = 5000;
 
-        auto result = bridge.disassemble_at(start, estimated_count);
-        if (!result.has_value()) {
-            return s_http_response::internal_error(result.error());
-        }
-
-        // Filter to only instructions within the function
-        auto filtered = nlohmann::json::array();
-        for (const auto& instr : result.value()) {
-            auto instr_addr = format_utils::parse_address(instr["address"].get<std::string>());
-            if (instr_addr > end_addr) break;
-            filtered.push_back(instr);
-        }
-
-        return s_http_response::ok({
-            {"function_start", bounds.value()["start"]},
-            {"function_end",   bounds.value()["end"]},
-            {"function_size",  bounds.value()["size"]},
-            {"count",          filtered.size()},
-            {"instructions",   filtered}
+        c_json_envelope out(512 + static_cast<size_t>(estimated_count) * 192);
+        auto& data = out.data();
+        data.begin_object()
+            .field("function_end",   bounds.value()["end"])
+            .field("function_size",  bounds.value()["size"])
+            .field("function_start", bounds.value()["start"])
+            .key("instructions").begin_array();
+
+        // Only instructions within the function
+        size_t written = 0;
+        bridge.for_each_instruction(start, estimated_count, [&](const c_bridge_executor::s_instruction& instr) {
+            if (instr.address > end_addr) {
+                return false;
+            }
+            write_instruction(data, instr);
+            ++written;
+            return true;
         });
+        data.end_array()
+            .field("count", written)
+            .end_object();
+        return out.finish();
     });
 
     // GET /api/disasm/basic?address=0x... - Fast instruction info
@@ -106,7 +138,7 @@ void register_disasm_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "cip");
+        std::string address_str{req.get_query("address", "cip")};
         auto address = bridge.eval_expression(address_str);
 
         auto result = bridge.get_basic_info(address);
@@ -142,6 +174,8 @@ void register_disasm_routes(c_http_router& router) {
             {"instruction", instruction}
         });
     });
+
+    router.mutating("/api/disasm/assemble");
 }
 
 } // namespace handlers
@@ -115,7 +115,7 @@ void register_dumping_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address", "");
+        std::string address_str{req.get_query("address", "")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -220,7 +220,7 @@ void register_dumping_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module_name = req.get_query("module", "");
+        std::string module_name{req.get_query("module", "")};
         if (module_name.empty()) {
             return s_http_response::bad_request("Missing 'module' query parameter");
         }
@@ -297,7 +297,7 @@ void register_dumping_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module_name = req.get_query("module", "");
+        std::string module_name{req.get_query("module", "")};
         if (module_name.empty()) {
             return s_http_response::bad_request("Missing 'module' query parameter");
         }
@@ -390,7 +390,7 @@ void register_dumping_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module_name = req.get_query("module", "");
+        std::string module_name{req.get_query("module", "")};
         if (module_name.empty()) {
             return s_http_response::bad_request("Missing 'module' query parameter");
         }
@@ -497,7 +497,7 @@ void register_dumping_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address", "");
+        std::string address_str{req.get_query("address", "")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -578,7 +578,7 @@ void register_dumping_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module_name = req.get_query("module", "");
+        std::string module_name{req.get_query("module", "")};
         if (module_name.empty()) {
             return s_http_response::bad_request("Missing 'module' query parameter");
         }
@@ -597,6 +597,9 @@ void register_dumping_routes(c_http_router& router) {
             {"rva", format_utils::format_address(entry - base)}
         });
     });
+
+    router.assign_lane("/api/dump/module", e_lane::bulk);
+    router.mutating("/api/dump/fix_iat");
 }
 
 } // namespace handlers
@@ -0,0 +1,173 @@
+#include "http/c_http_router.h"
+#include "util/c_event_hub.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Each SSE stream holds a worker thread for as long as the client listens,
+// so only a few may run at once
+constexpr int MAX_EVENT_STREAMS = 4;
+constexpr auto STREAM_POLL_INTERVAL = std::chrono::milliseconds(500);  // liveness check while idle
+constexpr auto STREAM_KEEPALIVE_INTERVAL = std::chrono::seconds(15);  // comment line while idle
+constexpr int STREAM_RETRY_MS = 2000;                                 // client reconnect delay
+
+std::atomic<int> g_event_streams{0};
+
+// Holds one of the MAX_EVENT_STREAMS slots until the response is gone
+struct s_stream_slot {
+    ~s_stream_slot() { g_event_streams.fetch_sub(1); }
+};
+
+// ?events=breakpoint,exception -> {"breakpoint", "exception"}; empty = all
+std::vector<std::string> parse_event_filter(std::string_view list) {
+    std::vector<std::string> wanted;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        auto name = list.substr(0, comma);
+        list = (comma == std::string_view::npos) ? std::string_view{} : list.substr(comma + 1);
+        if (!name.empty()) {
+            wanted.emplace_back(name);
+        }
+    }
+    return wanted;
+}
+
+bool is_wanted(const std::vector<std::string>& wanted, const std::string& type) {
+    return wanted.empty() || std::find(wanted.begin(), wanted.end(), type) != wanted.end();
+}
+
+void append_sse_event(std::string& out, uint64_t id, std::string_view type, std::string_view data) {
+    out += "id: ";
+    out += std::to_string(id);
+    out += "\nevent: ";
+    out += type;
+    out += "\ndata: ";
+    out += data;
+    out += "\n\n";
+}
+
+} // namespace
+
+namespace handlers {
+
+void register_event_routes(c_http_router& router) {
+    // GET /api/events - Server-Sent Events stream of debugger events; same
+    // events and filter as /api/events/ws. Each event is sent as
+    //   id: <N>\nevent: <type>\ndata: {"id":N,"event":..,"time":..,"data":{..}}\n\n
+    // A client reconnecting with Last-Event-ID (or ?last_event_id=N) first
+    // gets everything after N still in the history; if some of it is gone,
+    // a "dropped" event with the missing id range comes first.
+    router.get("/api/events", [](const s_http_request& req) {
+        // HTTP/1.0 has no chunked encoding, and a never-ending body cannot be
+        // collected into a Content-Length one
+        if (req.version == "HTTP/1.0") {
+            return s_http_response::bad_request("Event stream requires HTTP/1.1");
+        }
+
+        if (g_event_streams.fetch_add(1) >= MAX_EVENT_STREAMS) {
+            g_event_streams.fetch_sub(1);
+            return s_http_response::service_unavailable("Too many event streams open", 5);
+        }
+        auto slot = std::make_shared<s_stream_slot>();
+
+        auto& hub = get_event_hub();
+        uint64_t after = hub.last_id();
+
+        std::string_view resume = req.get_header("last-event-id");
+        if (resume.empty()) {
+            resume = req.get_query("last_event_id");
+        }
+        uint64_t resume_id = 0;
+        auto [end, ec] = std::from_chars(resume.data(), resume.data() + resume.size(), resume_id);
+        // An id from the future belongs to an earlier plugin session: start live
+        if (!resume.empty() && ec == std::errc{} && end == resume.data() + resume.size() && resume_id <= after) {
+            after = resume_id;
+        }
+
+        auto response = s_http_response::chunked(
+            [slot, after, wanted = parse_event_filter(req.get_query("events"))](const body_writer_t& write) {
+                auto& hub = get_event_hub();
+                uint64_t next = after + 1;
+
+                if (!write("retry: " + std::to_string(STREAM_RETRY_MS) + "\n\n")) {
+                    return;
+                }
+
+                auto last_write = std::chrono::steady_clock::now();
+                while (true) {
+                    std::string out;
+                    while (true) {
+                        if (auto event = hub.find(next)) {
+                            if (is_wanted(wanted, event->type)) {
+                                append_sse_event(out, event->id, event->type, event->json);
+                            }
+                            ++next;
+                            continue;
+                        }
+
+                        // Fell behind the history: say what was lost, carry on
+                        uint64_t newest = hub.last_id();
+                        if (newest >= next + c_event_hub::HISTORY_SIZE) {
+                            uint64_t oldest = newest - c_event_hub::HISTORY_SIZE + 1;
+                            append_sse_event(out, oldest - 1, "dropped",
+                                "{\"from\":" + std::to_string(next) + ",\"to\":" + std::to_string(oldest - 1) + "}");
+                            next = oldest;
+                            continue;
+                        }
+                        break;
+                    }
+
+                    auto now = std::chrono::steady_clock::now();
+                    if (!out.empty()) {
+                        if (!write(std::move(out))) {
+                            return;
+                        }
+                        last_write = now;
+                    } else if (now - last_write >= STREAM_KEEPALIVE_INTERVAL) {
+                        if (!write(": keep-alive\n\n")) {
+                            return;
+                        }
+                        last_write = now;
+                    } else if (!write({})) {
+                        return; // server stopping or client gone
+                    }
+
+                    hub.wait(next, STREAM_POLL_INTERVAL);
+                }
+            },
+            "text/event-stream");
+        response.headers.emplace_back("Cache-Control", "no-cache");
+        return response;
+    });
+
+    // GET /api/events/ws - WebSocket push channel for debugger events
+    // (paused, resumed, breakpoint, exception, dll_loaded, dll_unloaded,
+    // trace_started, trace_stopped). Each message is one JSON event:
+    //   {"id":N,"event":"breakpoint","time":<unix ms>,"data":{...}}
+    // Optional: ?events=breakpoint,exception to receive only those types.
+    router.websocket("/api/events/ws", [](const s_http_request& req, const std::shared_ptr<c_websocket_session>& session) {
+        // The hub holds the session weakly; the connection owns it
+        auto token = get_event_hub().subscribe(
+            [weak = std::weak_ptr<c_websocket_session>(session), wanted = parse_event_filter(req.get_query("events"))]
+            (const c_event_hub::event_ptr& event) {
+                if (!is_wanted(wanted, event->type)) {
+                    return;
+                }
+                if (auto s = weak.lock()) {
+                    s->send_text(event->json);
+                }
+            });
+
+        session->on_close = [token] { get_event_hub().unsubscribe(token); };
+    });
+}
+
+} // namespace handlers
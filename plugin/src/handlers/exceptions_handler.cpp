@@ -115,6 +115,10 @@ void register_exception_routes(c_http_router& router) {
             {"message", "Exception skipped"}
         });
     });
+
+    router.mutating("/api/exceptions/set_bp");
+    router.mutating("/api/exceptions/delete_bp");
+    router.mutating("/api/exceptions/skip");
 }
 
 } // namespace handlers
@@ -55,7 +55,7 @@ void register_handles_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto handle_str = req.get_query("handle");
+        std::string handle_str{req.get_query("handle")};
         if (handle_str.empty()) {
             return s_http_response::bad_request("Missing 'handle' query parameter");
         }
@@ -200,6 +200,8 @@ void register_handles_routes(c_http_router& router) {
             {"handle", handle}
         });
     });
+
+    router.mutating("/api/handles/close");
 }
 
 } // namespace handlers
@@ -0,0 +1,181 @@
+#include "http/c_http_router.h"
+#include "util/c_job_manager.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+std::optional<uint64_t> parse_id(std::string_view text) {
+    uint64_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace
+
+namespace handlers {
+
+void register_job_routes(c_http_router& router) {
+    // POST /api/jobs/submit - Run a request in the background
+    // Body: {"method": "POST", "path": "/api/search/pattern", "query": {..}, "body": {..},
+    //        "deadline_ms": N (optional, counted from submission, at most an hour)}
+    // Returns 202 with the job's id at once; poll /api/jobs/status for the
+    // outcome. Meant for routes that can outlast a client timeout (full-memory
+    // pattern search, string scans of large modules, module dumps).
+    router.post("/api/jobs/submit", [&router](const s_http_request& req) {
+        auto spec = nlohmann::json::parse(req.body, nullptr, false);
+        if (spec.is_discarded()) {
+            return s_http_response::bad_request("Body must be a request object");
+        }
+
+        auto request = s_http_request::from_spec(spec);
+        if (!request) {
+            return s_http_response::bad_request(request.error());
+        }
+        if (request->path.starts_with("/api/jobs/")) {
+            return s_http_response::bad_request("Jobs cannot start other jobs");
+        }
+        s_http_request::view_pairs params;
+        if (!router.find(request->method, request->path, params)) {
+            return s_http_response::not_found("No route for " + std::string(request->method) + " " +
+                                              std::string(request->path));
+        }
+
+        std::shared_ptr<c_cancel_token> cancel;
+        if (spec.contains("deadline_ms")) {
+            if (!spec["deadline_ms"].is_number_unsigned()) {
+                return s_http_response::bad_request("'deadline_ms' must be a non-negative integer");
+            }
+            // Clamped as X-Deadline-Ms is: a huge value would wrap negative
+            // in milliseconds or overflow the addition
+            auto ms = std::min(spec["deadline_ms"].get<uint64_t>(), c_cancel_token::MAX_DEADLINE_MS);
+            cancel = std::make_shared<c_cancel_token>(
+                std::chrono::steady_clock::now() + std::chrono::milliseconds(ms));
+        } else {
+            cancel = std::make_shared<c_cancel_token>();
+        }
+        request->cancel = cancel;
+
+        // Listed without the body, which may be large
+        nlohmann::json summary = {
+            {"method", std::string(request->method)},
+            {"path",   std::string(request->path)},
+            {"query",  std::string(request->query_string)}
+        };
+        // dispatch() invalidates the response cache around mutating routes
+        // here as it does for the server
+        auto id = get_job_manager().submit(std::move(summary), std::move(cancel),
+                                           [&router, request = std::move(*request)] {
+            return s_http_response::to_envelope(router.dispatch(request));
+        });
+        if (!id) {
+            return s_http_response::service_unavailable(id.error(), 5);
+        }
+
+        auto resp = s_http_response::ok({
+            {"id",    *id},
+            {"state", "queued"}
+        });
+        resp.status_code = 202;
+        return resp;
+    });
+
+    // GET /api/jobs/status?id=N&since=K - Progress and outcome of a job
+    // While the job runs: state, progress {done, total} and the partial
+    // result items from index K on (pass the number already seen). Once it
+    // has finished: the route's response envelope as "result".
+    router.get("/api/jobs/status", [](const s_http_request& req) {
+        auto id = parse_id(req.get_query("id"));
+        if (!id) {
+            return s_http_response::bad_request("Missing or invalid 'id' query parameter");
+        }
+        auto since = parse_id(req.get_query("since", "0"));
+        if (!since) {
+            return s_http_response::bad_request("Invalid 'since' query parameter");
+        }
+
+        auto status = get_job_manager().describe(*id, static_cast<size_t>(*since));
+        if (!status) {
+            return s_http_response::not_found("No job " + std::to_string(*id) + " (finished jobs are kept for " +
+                                              std::to_string(c_job_manager::MAX_FINISHED_AGE.count()) + " minutes)");
+        }
+        return s_http_response::ok(std::move(*status));
+    });
+
+    // GET /api/jobs/list - Every job still held, oldest first
+    router.get("/api/jobs/list", [](const s_http_request&) {
+        auto jobs = get_job_manager().list();
+        size_t count = jobs.size();
+        return s_http_response::ok({
+            {"jobs",  std::move(jobs)},
+            {"count", count}
+        });
+    });
+
+    // POST /api/jobs/cancel - Stop a queued or running job
+    // Body: {"id": N}
+    // Scans stop at the next chunk and finish with the results found so far
+    // (flagged "cancelled"); a queued job fails without running.
+    router.post("/api/jobs/cancel", [](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.contains("id") || !body["id"].is_number_unsigned()) {
+            return s_http_response::bad_request("Missing 'id' field");
+        }
+
+        auto id = body["id"].get<uint64_t>();
+        switch (get_job_manager().cancel(id)) {
+            case c_job_manager::e_cancel_result::not_found:
+                return s_http_response::not_found("No job " + std::to_string(id));
+            case c_job_manager::e_cancel_result::finished:
+                return s_http_response::conflict("Job " + std::to_string(id) + " has already finished");
+            case c_job_manager::e_cancel_result::cancelled:
+                break;
+        }
+        return s_http_response::ok({
+            {"id",        id},
+            {"cancelled", true}
+        });
+    });
+
+    // POST /api/jobs/delete - Forget a finished job and its result
+    // Body: {"id": N}
+    router.post("/api/jobs/delete", [](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.contains("id") || !body["id"].is_number_unsigned()) {
+            return s_http_response::bad_request("Missing 'id' field");
+        }
+
+        auto id = body["id"].get<uint64_t>();
+        switch (get_job_manager().remove(id)) {
+            case c_job_manager::e_remove_result::not_found:
+                return s_http_response::not_found("No job " + std::to_string(id));
+            case c_job_manager::e_remove_result::unfinished:
+                return s_http_response::conflict("Job " + std::to_string(id) + " has not finished");
+            case c_job_manager::e_remove_result::removed:
+                break;
+        }
+        return s_http_response::ok({
+            {"id",      id},
+            {"deleted", true}
+        });
+    });
+
+    // Quick bookkeeping; the job itself runs on the job manager's pool
+    router.assign_lane("/api/jobs/submit", e_lane::control);
+    router.assign_lane("/api/jobs/status", e_lane::control);
+    router.assign_lane("/api/jobs/list", e_lane::control);
+    router.assign_lane("/api/jobs/cancel", e_lane::control);
+    router.assign_lane("/api/jobs/delete", e_lane::control);
+}
+
+} // namespace handlers
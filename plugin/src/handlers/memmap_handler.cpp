@@ -1,7 +1,9 @@
 #include "http/c_http_router.h"
+#include "http/c_json_stream.h"
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
+#include <stdexcept>
 #include <nlohmann/json.hpp>
 #include "bridgemain.h"
 
@@ -15,16 +17,35 @@ void register_memmap_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto result = bridge.get_memory_map();
-        if (!result.has_value()) {
-            return s_http_response::internal_error(result.error());
-        }
+        // Regions are streamed as they are formatted (processes can map
+        // thousands of them)
+        return s_http_response::chunked([](const body_writer_t& write) {
+            c_json_array_stream out(write, nlohmann::json::object(), "regions");
+            // Same fields as c_bridge_executor::get_memory_map()
+            auto result = get_bridge().for_each_memory_region([&out](const c_bridge_executor::s_memory_region& region) {
+                return out.emit([&region](c_json_writer& item) {
+                    item.begin_object()
+                        .address_field("allocation_base", region.allocation_base)
+                        .address_field("base", region.base)
+                        .field("info",     region.info)
+                        .field("protect",  format_utils::format_protection(region.protect))
+                        .field("size",     region.size)
+                        .field("size_hex", format_utils::format_hex(region.size))
+                        .field("state",    format_utils::format_mem_state(region.state))
+                        .field("type",     format_utils::format_mem_type(region.type))
+                        .end_object();
+                });
+            });
+            if (!result.has_value()) {
+                // Headers are already out; dropping the connection is the only
+                // way left to report the failure.
+                throw std::runtime_error(result.error());
+            }
 
-        return s_http_response::ok({
-            {"regions", result.value()},
-            {"count",   result->size()}
+            out.finish({{"count", out.count()}});
         });
     });
+    router.cacheable("/api/memmap/list");
 
     // GET /api/memmap/at?address=0x... - Region containing address
     router.get("/api/memmap/at", [](const s_http_request& req) -> s_http_response {
@@ -33,7 +54,7 @@ void register_memmap_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -1,22 +1,198 @@
 #include "http/c_http_router.h"
+#include "http/c_json_writer.h"
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
 #include <nlohmann/json.hpp>
 #include "_dbgfunctions.h"
 
+#include <algorithm>
+#include <charconv>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
 namespace handlers {
 
+namespace {
+
+// Reads above this size are streamed: the hex column (3x the read size) is
+// formatted piece by piece as the socket drains instead of being built up
+// front.
+constexpr size_t STREAM_READ_THRESHOLD = 64 * 1024;
+constexpr size_t STREAM_PIECE_BYTES = 16 * 1024; // source bytes per written piece
+
+// Printable ASCII as is, '.' for every other byte
+std::string ascii_column(std::span<const uint8_t> bytes) {
+    std::string ascii;
+    ascii.reserve(bytes.size());
+    for (auto b : bytes) {
+        ascii += (b >= 0x20 && b < 0x7F) ? static_cast<char>(b) : '.';
+    }
+    return ascii;
+}
+
+// A read's payload; returns where the hex column's text starts in the buffer
+size_t write_memory_read(c_json_writer& out, duint address, size_t size,
+                         std::string_view hex, std::string_view ascii) {
+    out.begin_object()
+       .address_field("address", address)
+       .field("size", size)
+       .key("hex");
+    const size_t hex_at = out.buffer().size() + 1; // past the opening quote
+    out.value(hex)
+       .field("ascii", ascii)
+       .end_object();
+    return hex_at;
+}
+
+// The envelope is written with an empty hex column, and the hex digits (which
+// never need escaping) are streamed in between its quotes.
+s_http_response stream_memory_read(duint address, std::vector<uint8_t> bytes) {
+    auto data = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+    const size_t count = data->size();
+
+    c_json_envelope out(256 + count + count / 8);
+    const size_t hex_at = write_memory_read(out.data(), address, count, {}, ascii_column(*data));
+    auto envelope = out.finish().body;
+    auto suffix = envelope.substr(hex_at);
+    envelope.resize(hex_at);
+
+    const size_t hex_length = count ? count * 3 - 1 : 0;
+    const size_t total = envelope.size() + hex_length + suffix.size();
+
+    return s_http_response::stream(total, [data, prefix = std::move(envelope), suffix](const body_writer_t& write) {
+        static constexpr char digits[] = "0123456789ABCDEF";
+        const auto& bytes = *data;
+
+        if (!write(prefix)) return;
+
+        for (size_t offset = 0; offset < bytes.size(); offset += STREAM_PIECE_BYTES) {
+            size_t end = std::min(bytes.size(), offset + STREAM_PIECE_BYTES);
+            std::string piece;
+            piece.reserve((end - offset) * 3);
+            for (size_t i = offset; i < end; ++i) {
+                if (i > 0) piece += ' ';
+                piece += digits[bytes[i] >> 4];
+                piece += digits[bytes[i] & 0x0F];
+            }
+            if (!write(std::move(piece))) return;
+        }
+
+        write(suffix);
+    });
+}
+
+// One byte range within a read, from a Range header
+struct s_byte_range {
+    size_t offset;
+    size_t length;
+};
+
+bool parse_size(std::string_view text, size_t& value) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && ec == std::errc() && end == text.data() + text.size();
+}
+
+// Resolve a single "bytes=first-last", "bytes=first-" or "bytes=-suffix"
+// range against `total` bytes. Returns nullopt when there is no usable Range
+// header (absent, malformed, another unit, or several ranges): the whole read
+// is served then, as RFC 9110 allows. Unexpected means 416.
+std::expected<std::optional<s_byte_range>, std::string> parse_byte_range(std::string_view header, size_t total) {
+    constexpr std::string_view unit = "bytes=";
+    if (header.substr(0, unit.size()) != unit) {
+        return std::nullopt;
+    }
+
+    auto spec = header.substr(unit.size());
+    auto dash = spec.find('-');
+    if (dash == std::string_view::npos || spec.find(',') != std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    auto first_str = spec.substr(0, dash);
+    auto last_str = spec.substr(dash + 1);
+    size_t first = 0;
+    size_t last = total - 1;
+
+    if (first_str.find_first_not_of(' ') == std::string_view::npos) {
+        // Suffix range: the final N bytes
+        size_t suffix = 0;
+        if (!parse_size(last_str, suffix)) {
+            return std::nullopt;
+        }
+        if (suffix == 0) {
+            return std::unexpected("Empty suffix range");
+        }
+        first = total - std::min(suffix, total);
+    } else {
+        if (!parse_size(first_str, first)) {
+            return std::nullopt;
+        }
+        if (last_str.find_first_not_of(' ') != std::string_view::npos) {
+            size_t requested_last = 0;
+            if (!parse_size(last_str, requested_last) || requested_last < first) {
+                return std::nullopt;
+            }
+            last = std::min(requested_last, total - 1);
+        }
+        if (first >= total) {
+            return std::unexpected("Range starts beyond the " + std::to_string(total) + " bytes requested");
+        }
+    }
+
+    return s_byte_range{first, last - first + 1};
+}
+
+// format=raw: the bytes themselves, with the address and size in headers.
+// A Range header selects part of [address, address + size); only that part
+// is read from the debuggee.
+s_http_response read_memory_raw(duint address, size_t size, std::string_view range_header) {
+    auto range = parse_byte_range(range_header, size);
+    if (!range.has_value()) {
+        auto resp = s_http_response::error(416, range.error());
+        resp.headers.emplace_back("Content-Range", "bytes */" + std::to_string(size));
+        return resp;
+    }
+
+    const auto slice = range.value().value_or(s_byte_range{0, size});
+    auto result = get_bridge().read_memory(address + static_cast<duint>(slice.offset), slice.length);
+    if (!result.has_value()) {
+        return s_http_response::internal_error(result.error());
+    }
+
+    const auto& bytes = result.value();
+    auto resp = s_http_response::binary(std::string(bytes.begin(), bytes.end()));
+    resp.headers.emplace_back("X-Memory-Address", format_utils::format_address(address + static_cast<duint>(slice.offset)));
+    resp.headers.emplace_back("X-Memory-Size", std::to_string(bytes.size()));
+    resp.headers.emplace_back("Accept-Ranges", "bytes");
+    if (range.value()) {
+        resp.status_code = 206;
+        resp.headers.emplace_back("Content-Range",
+            "bytes " + std::to_string(slice.offset) + "-" + std::to_string(slice.offset + slice.length - 1) +
+            "/" + std::to_string(size));
+    }
+    return resp;
+}
+
+} // namespace
+
 void register_memory_routes(c_http_router& router) {
     // GET /api/memory/read?address=0x...&size=N - Read memory bytes
+    // Add format=raw for an application/octet-stream body (X-Memory-Address /
+    // X-Memory-Size headers; honours a Range header within the N bytes).
     router.get("/api/memory/read", [](const s_http_request& req) -> s_http_response {
         auto& bridge = get_bridge();
         if (!bridge.require_debugging()) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
-        auto size_str = req.get_query("size", "256");
+        std::string address_str{req.get_query("address")};
+        std::string size_str{req.get_query("size", "256")};
 
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
@@ -25,26 +201,28 @@ void register_memory_routes(c_http_router& router) {
         auto address = bridge.eval_expression(address_str);
         auto size = static_cast<size_t>(std::stoull(size_str));
 
+        if (req.get_query("format") == "raw") {
+            if (size == 0) {
+                return s_http_response::bad_request("Invalid read size (must be 1 to 10MB)");
+            }
+            return read_memory_raw(address, size, req.get_header("range"));
+        }
+
         auto result = bridge.read_memory(address, size);
         if (!result.has_value()) {
             return s_http_response::internal_error(result.error());
         }
 
-        const auto& bytes = result.value();
-
-        // Build ASCII representation
-        std::string ascii;
-        ascii.reserve(bytes.size());
-        for (auto b : bytes) {
-            ascii += (b >= 0x20 && b < 0x7F) ? static_cast<char>(b) : '.';
+        if (result.value().size() > STREAM_READ_THRESHOLD) {
+            return stream_memory_read(address, std::move(result.value()));
         }
 
-        return s_http_response::ok({
-            {"address", format_utils::format_address(address)},
-            {"size",    bytes.size()},
-            {"hex",     format_utils::format_bytes_hex(bytes.data(), bytes.size())},
-            {"ascii",   ascii}
-        });
+        const auto& bytes = result.value();
+
+        c_json_envelope out(256 + bytes.size() * 5);
+        write_memory_read(out.data(), address, bytes.size(),
+                          format_utils::format_bytes_hex(bytes.data(), bytes.size()), ascii_column(bytes));
+        return out.finish();
     });
 
     // POST /api/memory/write - Write bytes to memory
@@ -99,6 +277,73 @@ void register_memory_routes(c_http_router& router) {
         return s_http_response::ok(data);
     });
 
+    // POST /api/memory/write?address=<expr>[&verify=true] - Write a raw body to memory
+    // Send the bytes as Content-Type: application/octet-stream (or chunked).
+    // They are written piece by piece as they arrive, so unlike the JSON form
+    // the size is not bounded by the 1MB request limit. With verify, each
+    // piece is read back; the first mismatch is reported.
+    router.upload("/api/memory/write", [](const s_http_request& req, c_request_body& body) -> s_http_response {
+        auto& bridge = get_bridge();
+        if (!bridge.require_debugging()) {
+            return s_http_response::conflict("No active debug session");
+        }
+
+        std::string address_str{req.get_query("address")};
+        if (address_str.empty()) {
+            return s_http_response::bad_request("Missing 'address' query parameter");
+        }
+        auto address = bridge.eval_expression(address_str);
+        const bool verify = req.get_query("verify") == "true";
+
+        uint64_t written = 0;
+        bool verified = true;
+        std::optional<duint> mismatch;
+        std::string piece;
+        while (body.read(piece)) {
+            std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(piece.data()), piece.size());
+            auto target = address + static_cast<duint>(written);
+            auto result = bridge.write_memory(target, bytes);
+            if (!result.has_value()) {
+                return s_http_response::internal_error(
+                    result.error() + " (" + std::to_string(written) + " bytes written before it)");
+            }
+
+            if (verify && !mismatch) {
+                auto readback = bridge.read_memory(target, bytes.size());
+                if (!readback.has_value()) {
+                    verified = false;
+                    mismatch = target;
+                } else if (!std::equal(bytes.begin(), bytes.end(), readback->begin())) {
+                    verified = false;
+                    auto differs = std::mismatch(bytes.begin(), bytes.end(), readback->begin());
+                    mismatch = target + static_cast<duint>(differs.first - bytes.begin());
+                }
+            }
+            written += piece.size();
+        }
+
+        if (auto error = body.error(); !error.empty()) {
+            return s_http_response::bad_request(error + " (" + std::to_string(written) + " bytes written)");
+        }
+        if (written == 0) {
+            return s_http_response::bad_request("No bytes to write");
+        }
+
+        nlohmann::json data = {
+            {"address",       format_utils::format_address(address)},
+            {"bytes_written", written}
+        };
+        if (verify) {
+            data["verified"] = verified;
+            if (mismatch) {
+                data["verify_error"] = "Read-back mismatch at " + format_utils::format_address(*mismatch) +
+                                       " - write may have failed (page may be write-protected or copy-on-write)";
+            }
+        }
+
+        return s_http_response::ok(data);
+    });
+
     // GET /api/memory/is_valid?address=0x... - Check pointer validity
     router.get("/api/memory/is_valid", [](const s_http_request& req) -> s_http_response {
         auto& bridge = get_bridge();
@@ -106,7 +351,7 @@ void register_memory_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -127,7 +372,7 @@ void register_memory_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -226,7 +471,7 @@ void register_memory_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -253,6 +498,12 @@ void register_memory_routes(c_http_router& router) {
             {"message", "Memory map updated"}
         });
     });
+
+    router.mutating("/api/memory/write");
+    router.mutating("/api/memory/allocate");
+    router.mutating("/api/memory/free");
+    router.mutating("/api/memory/protect");
+    router.mutating("/api/memory/update_map");
 }
 
 } // namespace handlers
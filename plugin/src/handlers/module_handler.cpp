@@ -57,6 +57,7 @@ void register_module_routes(c_http_router& router) {
             {"count",   result.size()}
         });
     });
+    router.cacheable("/api/modules/list");
 
     // GET /api/modules/get?name=... - Module info
     router.get("/api/modules/get", [](const s_http_request& req) -> s_http_response {
@@ -65,7 +66,7 @@ void register_module_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto name = req.get_query("name");
+        std::string name{req.get_query("name")};
         if (name.empty()) {
             return s_http_response::bad_request("Missing 'name' query parameter");
         }
@@ -95,7 +96,7 @@ void register_module_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto name = req.get_query("name");
+        std::string name{req.get_query("name")};
         if (name.empty()) {
             return s_http_response::bad_request("Missing 'name' query parameter");
         }
@@ -118,7 +119,7 @@ void register_module_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -141,7 +142,7 @@ void register_module_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto base_str = req.get_query("base");
+        std::string base_str{req.get_query("base")};
         if (base_str.empty()) {
             return s_http_response::bad_request("Missing 'base' query parameter");
         }
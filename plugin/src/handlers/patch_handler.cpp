@@ -2,6 +2,7 @@
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
+#include <span>
 #include <vector>
 #include <nlohmann/json.hpp>
 #include "bridgemain.h"
@@ -82,6 +83,65 @@ void register_patch_routes(c_http_router& router) {
         return s_http_response::ok(data);
     });
 
+    // POST /api/patches/apply?address=<expr> - Apply a patch sent as a raw body
+    // Content-Type: application/octet-stream (or chunked), written as it
+    // arrives. Reports how many bytes actually changed instead of echoing
+    // old and new bytes as hex, which would dwarf a large patch.
+    router.upload("/api/patches/apply", [](const s_http_request& req, c_request_body& body) -> s_http_response {
+        auto& bridge = get_bridge();
+        if (!bridge.require_debugging()) {
+            return s_http_response::conflict("No active debug session");
+        }
+
+        std::string address_str{req.get_query("address")};
+        if (address_str.empty()) {
+            return s_http_response::bad_request("Missing 'address' query parameter");
+        }
+        auto address = bridge.eval_expression(address_str);
+
+        uint64_t patched = 0;
+        uint64_t changed = 0;
+        bool originals_known = true;
+        std::string piece;
+        while (body.read(piece)) {
+            std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(piece.data()), piece.size());
+            auto target = address + static_cast<duint>(patched);
+
+            auto original = bridge.read_memory(target, bytes.size());
+            auto result = bridge.write_memory(target, bytes);
+            if (!result.has_value()) {
+                return s_http_response::internal_error(
+                    result.error() + " (" + std::to_string(patched) + " bytes patched before it)");
+            }
+
+            if (original.has_value()) {
+                for (size_t i = 0; i < bytes.size(); ++i) {
+                    changed += (*original)[i] != bytes[i];
+                }
+            } else {
+                originals_known = false;
+            }
+            patched += piece.size();
+        }
+
+        if (auto error = body.error(); !error.empty()) {
+            return s_http_response::bad_request(error + " (" + std::to_string(patched) + " bytes patched)");
+        }
+        if (patched == 0) {
+            return s_http_response::bad_request("No valid bytes to patch");
+        }
+
+        nlohmann::json data = {
+            {"address",       format_utils::format_address(address)},
+            {"bytes_patched", patched}
+        };
+        if (originals_known) {
+            data["bytes_changed"] = changed;
+        }
+
+        return s_http_response::ok(data);
+    });
+
     // POST /api/patches/restore - Restore original bytes
     router.post("/api/patches/restore", [](const s_http_request& req) -> s_http_response {
         auto& bridge = get_bridge();
@@ -137,6 +197,9 @@ void register_patch_routes(c_http_router& router) {
             {"message", "Module export initiated"}
         });
     });
+
+    router.mutating("/api/patches/apply");
+    router.mutating("/api/patches/restore");
 }
 
 } // namespace handlers
@@ -98,6 +98,8 @@ void register_process_routes(c_http_router& router) {
             {"version", version}
         });
     });
+
+    router.mutating("/api/process/set_cmdline");
 }
 
 } // namespace handlers
@@ -73,6 +73,7 @@ void register_register_routes(c_http_router& router) {
 
         return s_http_response::ok(regs);
     });
+    router.cacheable("/api/registers/all");
 
     // GET /api/registers/get?name=rax - Single register
     router.get("/api/registers/get", [](const s_http_request& req) -> s_http_response {
@@ -81,7 +82,7 @@ void register_register_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto name = req.get_query("name");
+        std::string name{req.get_query("name")};
         if (name.empty()) {
             return s_http_response::bad_request("Missing 'name' query parameter");
         }
@@ -194,6 +195,8 @@ void register_register_routes(c_http_router& router) {
 
         return s_http_response::ok(data);
     });
+
+    router.mutating("/api/registers/set");
 }
 
 } // namespace handlers
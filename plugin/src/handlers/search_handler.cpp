@@ -1,88 +1,22 @@
 #include "http/c_http_router.h"
+#include "http/c_json_stream.h"
 #include "bridge/c_bridge_executor.h"
+#include "util/c_job_manager.h"
 #include "util/format_utils.h"
+#include "util/pattern_utils.h"
 
+#include <memory>
 #include <nlohmann/json.hpp>
 #include "bridgemain.h"
 #include "_dbgfunctions.h"
 
-namespace handlers {
-
-// Parse a hex byte pattern string (e.g., "C4 CB 75 5B" or "C4CB755B" or "C4 ?? 75 5B")
-// Returns pairs of (byte_value, is_wildcard).
-// Returns empty vector if the pattern is malformed.
-struct pattern_byte {
-    uint8_t value = 0;
-    bool    is_wildcard = false;
-};
-
-static std::vector<pattern_byte> parse_byte_pattern(const std::string& pattern_str) {
-    // Strip all spaces to normalize
-    std::string cleaned;
-    cleaned.reserve(pattern_str.size());
-    for (char c : pattern_str) {
-        if (c != ' ') cleaned += c;
-    }
-
-    if (cleaned.empty() || (cleaned.size() % 2) != 0) {
-        return {};
-    }
-
-    std::vector<pattern_byte> result;
-    result.reserve(cleaned.size() / 2);
-
-    for (size_t i = 0; i + 1 < cleaned.size(); i += 2) {
-        char hi = cleaned[i];
-        char lo = cleaned[i + 1];
-
-        bool hi_wild = (hi == '?' || hi == '*');
-        bool lo_wild = (lo == '?' || lo == '*');
-
-        if (hi_wild || lo_wild) {
-            result.push_back({0, true});
-        } else {
-            // Validate hex chars
-            auto is_hex = [](char c) {
-                return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-            };
-            if (!is_hex(hi) || !is_hex(lo)) {
-                return {};  // Invalid pattern
-            }
-            char hex[3] = {hi, lo, '\0'};
-            result.push_back({static_cast<uint8_t>(std::stoul(hex, nullptr, 16)), false});
-        }
-    }
+namespace {
 
-    return result;
-}
+constexpr size_t SCAN_CHUNK_BYTES = 16 * 1024 * 1024; // read and scanned between cancel checks
 
-// Scan a memory buffer for a byte pattern starting at any offset.
-// Returns all offsets (relative to buffer start) where the pattern matches.
-static std::vector<size_t> scan_buffer(
-    const uint8_t* buf, size_t buf_size,
-    const std::vector<pattern_byte>& pattern
-) {
-    std::vector<size_t> hits;
-    if (pattern.empty() || buf_size < pattern.size()) return hits;
-
-    const size_t pat_len = pattern.size();
-    const size_t search_end = buf_size - pat_len + 1;
-
-    for (size_t i = 0; i < search_end; ++i) {
-        bool match = true;
-        for (size_t j = 0; j < pat_len; ++j) {
-            if (!pattern[j].is_wildcard && buf[i + j] != pattern[j].value) {
-                match = false;
-                break;
-            }
-        }
-        if (match) {
-            hits.push_back(i);
-        }
-    }
+} // namespace
 
-    return hits;
-}
+namespace handlers {
 
 void register_search_routes(c_http_router& router) {
     // POST /api/search/pattern - AOB/byte pattern scan
@@ -99,7 +33,7 @@ void register_search_routes(c_http_router& router) {
         }
 
         auto pattern_str = body["pattern"].get<std::string>();
-        auto pattern = parse_byte_pattern(pattern_str);
+        auto pattern = pattern_utils::parse_byte_pattern(pattern_str);
 
         if (pattern.empty()) {
             return s_http_response::bad_request(
@@ -114,94 +48,134 @@ void register_search_routes(c_http_router& router) {
         std::string address_str = body.value("address", "");
         std::string size_str    = body.value("size", "");
 
-        auto matches = nlohmann::json::array();
-
-        if (!address_str.empty() && !size_str.empty()) {
-            // Scan a specific range
-            auto base = bridge.eval_expression(address_str);
-            auto range_size = static_cast<size_t>(bridge.eval_expression(size_str));
-
-            if (range_size == 0 || range_size > 256 * 1024 * 1024) {
-                return s_http_response::bad_request("Invalid size (must be 1 byte - 256MB)");
-            }
-
-            auto mem = bridge.read_memory(base, range_size);
-            if (mem.has_value()) {
-                auto hits = scan_buffer(mem.value().data(), mem.value().size(), pattern);
-                for (auto offset : hits) {
-                    if (static_cast<int>(matches.size()) >= max_results) break;
-                    auto match_addr = base + static_cast<duint>(offset);
-                    matches.push_back(format_utils::format_address(match_addr));
-                }
-            }
-        } else {
-            // Scan all mapped memory pages (read + execute pages)
+        if (address_str.empty() || size_str.empty()) {
+            // Full-memory scan: matches are streamed as each region is scanned,
+            // so the first results arrive long before the last page is read.
             MEMMAP memmap{};
             if (!DbgMemMap(&memmap)) {
                 return s_http_response::internal_error("Failed to get memory map");
             }
+            std::shared_ptr<MEMPAGE> pages(memmap.page, [](MEMPAGE* p) {
+                if (p) BridgeFree(p);
+            });
+            const int page_count = memmap.count;
+
+            return s_http_response::chunked(
+                [pages, page_count, pattern, pattern_str, max_results, cancel = req.cancel](const body_writer_t& write) {
+                    auto& bridge = get_bridge();
+                    c_json_array_stream out(write, {{"pattern", pattern_str}}, "matches");
+                    std::string first_match;
+                    auto stopped = c_cancel_token::e_reason::none;
+
+                    auto emit = [&](duint match_addr) {
+                        auto formatted = format_utils::format_address(match_addr);
+                        if (first_match.empty()) first_match = formatted;
+                        out.push(formatted);
+                        return out.alive() && static_cast<int>(out.count()) < max_results;
+                    };
+
+                    // Read each page and scan it (with overlap to catch cross-page matches)
+                    const size_t overlap = pattern.size() - 1;
+                    std::vector<uint8_t> prev_tail;
+                    bool keep_going = true;
+
+                    for (int i = 0; i < page_count && keep_going; ++i) {
+                        if (cancel && (stopped = cancel->reason()) != c_cancel_token::e_reason::none) {
+                            break;
+                        }
+                        c_job_manager::report_progress(static_cast<uint64_t>(i), static_cast<uint64_t>(page_count));
+                        const auto& page = pages.get()[i];
+                        auto page_base = reinterpret_cast<duint>(page.mbi.BaseAddress);
+                        auto page_size = static_cast<size_t>(page.mbi.RegionSize);
+
+                        // Skip non-committed or non-readable pages
+                        if (page.mbi.State != MEM_COMMIT) {
+                            prev_tail.clear();
+                            continue;
+                        }
+                        if (page.mbi.Protect == PAGE_NOACCESS || page.mbi.Protect == 0) {
+                            prev_tail.clear();
+                            continue;
+                        }
+
+                        // Read the page (limit single reads to 64MB)
+                        const size_t read_size = (page_size > 64 * 1024 * 1024) ? 64 * 1024 * 1024 : page_size;
+                        auto mem = bridge.read_memory(page_base, read_size);
+                        if (!mem.has_value()) {
+                            prev_tail.clear();
+                            continue;
+                        }
+
+                        const auto& buf = mem.value();
+
+                        // Build combined buffer: overlap from previous page + current page
+                        // This catches patterns that straddle page boundaries
+                        if (!prev_tail.empty()) {
+                            std::vector<uint8_t> combined;
+                            combined.reserve(prev_tail.size() + buf.size());
+                            combined.insert(combined.end(), prev_tail.begin(), prev_tail.end());
+                            combined.insert(combined.end(), buf.begin(), buf.end());
+                            auto base_addr = page_base - static_cast<duint>(prev_tail.size());
+
+                            for (auto offset : pattern_utils::scan_buffer(combined.data(), combined.size(), pattern)) {
+                                if (!(keep_going = emit(base_addr + static_cast<duint>(offset)))) break;
+                            }
+                        } else {
+                            for (auto offset : pattern_utils::scan_buffer(buf.data(), buf.size(), pattern)) {
+                                if (!(keep_going = emit(page_base + static_cast<duint>(offset)))) break;
+                            }
+                        }
+
+                        // Save tail for next iteration (cross-page match detection)
+                        if (buf.size() >= overlap && overlap > 0) {
+                            prev_tail.assign(buf.end() - static_cast<ptrdiff_t>(overlap), buf.end());
+                        } else {
+                            prev_tail = buf;
+                        }
+                    }
 
-            // Read each page and scan it (with overlap to catch cross-page matches)
-            const size_t overlap = pattern.size() - 1;
-            std::vector<uint8_t> prev_tail;
+                    if (stopped == c_cancel_token::e_reason::none) {
+                        c_job_manager::report_progress(static_cast<uint64_t>(page_count), static_cast<uint64_t>(page_count));
+                    }
 
-            for (int i = 0; i < memmap.count && static_cast<int>(matches.size()) < max_results; ++i) {
-                const auto& page = memmap.page[i];
-                auto page_base = reinterpret_cast<duint>(page.mbi.BaseAddress);
-                auto page_size = static_cast<size_t>(page.mbi.RegionSize);
+                    // Backwards-compat: first_match field
+                    out.finish({
+                        {"found",       out.count() > 0},
+                        {"count",       out.count()},
+                        {"first_match", first_match},
+                        {"truncated_by_deadline", stopped == c_cancel_token::e_reason::deadline},
+                        {"cancelled",   stopped == c_cancel_token::e_reason::cancelled}
+                    });
+                });
+        }
 
-                // Skip non-committed or non-readable pages
-                if (page.mbi.State != MEM_COMMIT) {
-                    prev_tail.clear();
-                    continue;
-                }
-                if (page.mbi.Protect == PAGE_NOACCESS || page.mbi.Protect == 0) {
-                    prev_tail.clear();
-                    continue;
-                }
+        // Scan a specific range
+        auto matches = nlohmann::json::array();
+        auto base = bridge.eval_expression(address_str);
+        auto range_size = static_cast<size_t>(bridge.eval_expression(size_str));
 
-                // Read the page (limit single reads to 64MB)
-                const size_t read_size = (page_size > 64 * 1024 * 1024) ? 64 * 1024 * 1024 : page_size;
-                auto mem = bridge.read_memory(page_base, read_size);
-                if (!mem.has_value()) {
-                    prev_tail.clear();
-                    continue;
-                }
+        if (range_size == 0 || range_size > 256 * 1024 * 1024) {
+            return s_http_response::bad_request("Invalid size (must be 1 byte - 256MB)");
+        }
 
-                const auto& buf = mem.value();
-
-                // Build combined buffer: overlap from previous page + current page
-                // This catches patterns that straddle page boundaries
-                std::vector<uint8_t> combined;
-                if (!prev_tail.empty()) {
-                    combined.reserve(prev_tail.size() + buf.size());
-                    combined.insert(combined.end(), prev_tail.begin(), prev_tail.end());
-                    combined.insert(combined.end(), buf.begin(), buf.end());
-                    auto base_addr = page_base - static_cast<duint>(prev_tail.size());
-
-                    auto hits = scan_buffer(combined.data(), combined.size(), pattern);
-                    for (auto offset : hits) {
-                        if (static_cast<int>(matches.size()) >= max_results) break;
-                        matches.push_back(format_utils::format_address(base_addr + static_cast<duint>(offset)));
-                    }
-                } else {
-                    auto hits = scan_buffer(buf.data(), buf.size(), pattern);
-                    for (auto offset : hits) {
-                        if (static_cast<int>(matches.size()) >= max_results) break;
-                        matches.push_back(format_utils::format_address(page_base + static_cast<duint>(offset)));
-                    }
-                }
+        // Read and scan in chunks, so a cancel or deadline is noticed between
+        // them. Each read runs overlap bytes into the next chunk; a match is
+        // reported by the chunk it starts in.
+        const size_t overlap = pattern.size() - 1;
+        auto stopped = c_cancel_token::e_reason::none;
 
-                // Save tail for next iteration (cross-page match detection)
-                if (buf.size() >= overlap && overlap > 0) {
-                    prev_tail.assign(buf.end() - static_cast<ptrdiff_t>(overlap), buf.end());
-                } else {
-                    prev_tail = buf;
-                }
+        for (size_t off = 0; off < range_size && static_cast<int>(matches.size()) < max_results; off += SCAN_CHUNK_BYTES) {
+            if ((stopped = req.stop_reason()) != c_cancel_token::e_reason::none) {
+                break;
             }
-
-            if (memmap.page) {
-                BridgeFree(memmap.page);
+            size_t want = (range_size - off) < SCAN_CHUNK_BYTES + overlap ? (range_size - off) : SCAN_CHUNK_BYTES + overlap;
+            auto mem = bridge.read_memory(base + static_cast<duint>(off), want);
+            if (!mem.has_value()) continue;
+
+            for (auto offset : pattern_utils::scan_buffer(mem.value().data(), mem.value().size(), pattern)) {
+                if (offset >= SCAN_CHUNK_BYTES) break; // starts in the next chunk
+                if (static_cast<int>(matches.size()) >= max_results) break;
+                matches.push_back(format_utils::format_address(base + static_cast<duint>(off + offset)));
             }
         }
 
@@ -211,6 +185,8 @@ void register_search_routes(c_http_router& router) {
             {"found",        found},
             {"count",        matches.size()},
             {"matches",      matches},
+            {"truncated_by_deadline", stopped == c_cancel_token::e_reason::deadline},
+            {"cancelled",    stopped == c_cancel_token::e_reason::cancelled},
         };
 
         // Backwards-compat: first_match field
@@ -262,7 +238,7 @@ void register_search_routes(c_http_router& router) {
             byte_pattern.pop_back();
         }
 
-        auto pattern = parse_byte_pattern(byte_pattern);
+        auto pattern = pattern_utils::parse_byte_pattern(byte_pattern);
 
         // Determine search range
         duint base = 0;
@@ -281,7 +257,7 @@ void register_search_routes(c_http_router& router) {
         if (base != 0 && range != 0) {
             auto mem = bridge.read_memory(base, range);
             if (mem.has_value()) {
-                auto hits = scan_buffer(mem.value().data(), mem.value().size(), pattern);
+                auto hits = pattern_utils::scan_buffer(mem.value().data(), mem.value().size(), pattern);
                 for (auto offset : hits) {
                     if (static_cast<int>(matches.size()) >= 1000) break;
                     matches.push_back(format_utils::format_address(base + static_cast<duint>(offset)));
@@ -316,13 +292,13 @@ void register_search_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
 
-        auto encoding = req.get_query("encoding", "auto");
-        auto max_length_str = req.get_query("max_length", "256");
+        std::string encoding{req.get_query("encoding", "auto")};
+        std::string max_length_str{req.get_query("max_length", "256")};
         auto max_length = static_cast<size_t>(std::stoull(max_length_str));
         if (max_length < 1) max_length = 1;
         if (max_length > 4096) max_length = 4096;
@@ -438,12 +414,12 @@ void register_search_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
 
-        auto size_str = req.get_query("size", "1");
+        std::string size_str{req.get_query("size", "1")};
         auto address = bridge.eval_expression(address_str);
         auto size = bridge.eval_expression(size_str);
 
@@ -479,6 +455,9 @@ void register_search_routes(c_http_router& router) {
             {"type_id",     static_cast<int>(encode_type)}
         });
     });
+
+    router.assign_lane("/api/search/pattern", e_lane::bulk);
+    router.assign_lane("/api/search/string", e_lane::bulk);
 }
 
 } // namespace handlers
@@ -0,0 +1,250 @@
+#include "http/c_http_router.h"
+#include "util/c_shared_ring.h"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+constexpr size_t MAX_RINGS = 4;                       // open at once, across clients
+constexpr size_t DEFAULT_RING_SIZE = 32 * 1024 * 1024; // fits a 10MB raw memory read
+constexpr auto PUBLISH_TIMEOUT = std::chrono::seconds(5); // for the client to free space
+constexpr auto RING_IDLE_TIMEOUT = std::chrono::minutes(10); // unused this long: reclaimed by the next open
+
+struct s_ring_entry {
+    std::shared_ptr<c_shared_ring> ring;
+    std::chrono::steady_clock::time_point last_used;
+};
+
+// Rings are not tied to a connection (a client may fetch over several), so
+// one whose client crashed or never closed it is only noticed by going idle
+struct s_ring_registry {
+    std::mutex mutex;
+    std::map<uint64_t, s_ring_entry> rings;
+    uint64_t next_id = 1;
+};
+
+s_ring_registry& get_rings() {
+    static s_ring_registry registry;
+    return registry;
+}
+
+// The ring, marked as used now
+std::shared_ptr<c_shared_ring> find_ring(uint64_t id) {
+    auto& registry = get_rings();
+    std::lock_guard lock(registry.mutex);
+    auto it = registry.rings.find(id);
+    if (it == registry.rings.end()) {
+        return nullptr;
+    }
+    it->second.last_used = std::chrono::steady_clock::now();
+    return it->second.ring;
+}
+
+// Drop rings nobody has fetched into for RING_IDLE_TIMEOUT. A fetch still
+// writing into one keeps it mapped until it is done. Caller holds the mutex.
+void reclaim_idle_rings_locked(s_ring_registry& registry) {
+    auto now = std::chrono::steady_clock::now();
+    std::erase_if(registry.rings, [now](const auto& entry) {
+        return now - entry.second.last_used >= RING_IDLE_TIMEOUT;
+    });
+}
+
+// Hard to guess, so another local process cannot map a ring it was not given
+std::string make_ring_name() {
+    std::random_device random;
+    uint64_t nonce = (static_cast<uint64_t>(random()) << 32) | random();
+    char hex[17];
+    for (int i = 15; i >= 0; --i, nonce >>= 4) {
+        hex[i] = "0123456789abcdef"[nonce & 0xF];
+    }
+    hex[16] = '\0';
+    return std::string("x64dbg_mcp_ring_") + hex;
+}
+
+// Publish the sub-response's body into the ring. Streamed bodies of known
+// length are written straight into the shared region; others are collected
+// first.
+s_http_response publish_body(c_shared_ring& ring, uint64_t ring_id, s_http_response response) {
+    if (response.document) {
+        response.serialize(e_body_format::json);
+    }
+
+    // An event stream never ends
+    if (response.content_type.starts_with("text/event-stream")) {
+        return s_http_response::bad_request("Event streams cannot be delivered through shared memory");
+    }
+
+    if (response.body_stream && !response.stream_length) {
+        std::string body;
+        response.body_stream([&body](std::string piece) {
+            body += piece;
+            return true;
+        });
+        response.body = std::move(body);
+        response.body_stream = nullptr;
+    }
+
+    const size_t length = response.body_stream ? *response.stream_length : response.body.size();
+    if (length > ring.max_payload()) {
+        return s_http_response::error(413, "Response of " + std::to_string(length) +
+                                           " bytes exceeds the ring's limit of " +
+                                           std::to_string(ring.max_payload()) + "; use a larger ring or plain HTTP");
+    }
+
+    bool filled = false;
+    auto slot = ring.publish(length, [&](uint8_t* dest) {
+        filled = true;
+        if (!response.body_stream) {
+            std::memcpy(dest, response.body.data(), length);
+            return true;
+        }
+
+        size_t written = 0;
+        bool overflow = false;
+        response.body_stream([&](std::string piece) {
+            if (written + piece.size() > length) {
+                overflow = true;
+                return false;
+            }
+            std::memcpy(dest + written, piece.data(), piece.size());
+            written += piece.size();
+            return true;
+        });
+        return !overflow && written == length;
+    }, PUBLISH_TIMEOUT);
+
+    if (!slot) {
+        return filled ? s_http_response::internal_error("Response body did not match its declared length")
+                      : s_http_response::service_unavailable(slot.error());
+    }
+
+    nlohmann::json headers = nlohmann::json::object();
+    for (const auto& [name, value] : response.headers) {
+        headers[name] = value;
+    }
+
+    return s_http_response::ok({
+        {"ring",         ring_id},
+        {"offset",       slot->offset},
+        {"length",       slot->length},
+        {"end",          slot->end},
+        {"status",       response.status_code},
+        {"content_type", response.content_type},
+        {"headers",      std::move(headers)}
+    });
+}
+
+} // namespace
+
+namespace handlers {
+
+void register_shm_routes(c_http_router& router) {
+    // POST /api/shm/open - Create a shared-memory ring for bulk responses
+    // Body: {"size": bytes} (optional; rounded up to a power of two, at most 256MB)
+    // Returns the mapping's name and geometry; see c_shared_ring for the layout.
+    // A ring not fetched into for idle_timeout_s may be closed by a later open.
+    router.post("/api/shm/open", [](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body.empty() ? std::string_view("{}") : req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object()) {
+            return s_http_response::bad_request("Invalid JSON body");
+        }
+        if (body.contains("size") && !body["size"].is_number_unsigned()) {
+            return s_http_response::bad_request("'size' must be a positive integer");
+        }
+        // Read at full width so a size past SIZE_MAX on x32 is not truncated
+        uint64_t size = body.value("size", static_cast<uint64_t>(DEFAULT_RING_SIZE));
+        if (size > c_shared_ring::MAX_CAPACITY) {
+            return s_http_response::bad_request(
+                "'size' must be at most " + std::to_string(c_shared_ring::MAX_CAPACITY) + " bytes");
+        }
+
+        auto& registry = get_rings();
+        std::lock_guard lock(registry.mutex);
+        reclaim_idle_rings_locked(registry);
+        if (registry.rings.size() >= MAX_RINGS) {
+            return s_http_response::service_unavailable(
+                "At most " + std::to_string(MAX_RINGS) + " rings may be open; close one first");
+        }
+
+        auto ring = c_shared_ring::create(make_ring_name(), static_cast<size_t>(size));
+        if (!ring) {
+            return s_http_response::internal_error(ring.error());
+        }
+
+        uint64_t id = registry.next_id++;
+        auto& opened = registry.rings[id] = {std::move(ring.value()), std::chrono::steady_clock::now()};
+        return s_http_response::ok({
+            {"ring",           id},
+            {"name",           opened.ring->name()},
+            {"header_size",    c_shared_ring::HEADER_SIZE},
+            {"capacity",       opened.ring->capacity()},
+            {"max_payload",    opened.ring->max_payload()},
+            {"idle_timeout_s", std::chrono::duration_cast<std::chrono::seconds>(RING_IDLE_TIMEOUT).count()}
+        });
+    });
+
+    // POST /api/shm/fetch - Run a request and put its response body in a ring
+    // Body: {"ring": id, "method": "GET", "path": "/api/memory/read", "query": {..}, "body": ..}
+    // Returns {ring, offset, length, end, status, content_type, headers}: the
+    // body is at data[offset, offset + length); store `end` into the ring's
+    // tail once done with it. Bodies are placed in the order they are fetched.
+    router.post("/api/shm/fetch", [&router](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object() || !body.contains("ring") || !body["ring"].is_number_unsigned()) {
+            return s_http_response::bad_request("Missing 'ring' id");
+        }
+
+        auto ring_id = body["ring"].get<uint64_t>();
+        auto ring = find_ring(ring_id);
+        if (!ring) {
+            return s_http_response::not_found("No ring " + std::to_string(ring_id));
+        }
+
+        auto request = s_http_request::from_spec(body);
+        if (!request) {
+            return s_http_response::bad_request(request.error());
+        }
+        if (request->path.starts_with("/api/shm/")) {
+            return s_http_response::bad_request("Ring requests cannot be fetched through a ring");
+        }
+        // The fetch's X-Deadline-Ms / X-Request-Id reach the scan it runs
+        request->cancel = req.cancel;
+
+        s_http_response response;
+        try {
+            response = router.dispatch(*request);
+        } catch (const std::exception& e) {
+            return s_http_response::internal_error(std::string("Handler exception: ") + e.what());
+        }
+        return publish_body(*ring, ring_id, std::move(response));
+    });
+
+    // POST /api/shm/close - Unmap a ring
+    // Body: {"ring": id}
+    router.post("/api/shm/close", [](const s_http_request& req) {
+        auto body = nlohmann::json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object() || !body.contains("ring") || !body["ring"].is_number_unsigned()) {
+            return s_http_response::bad_request("Missing 'ring' id");
+        }
+
+        // A fetch still writing into the ring keeps it mapped until it is done
+        auto ring_id = body["ring"].get<uint64_t>();
+        auto& registry = get_rings();
+        std::lock_guard lock(registry.mutex);
+        if (registry.rings.erase(ring_id) == 0) {
+            return s_http_response::not_found("No ring " + std::to_string(ring_id));
+        }
+        return s_http_response::ok({{"ring", ring_id}, {"closed", true}});
+    });
+
+    router.assign_lane("/api/shm/fetch", e_lane::bulk);
+}
+
+} // namespace handlers
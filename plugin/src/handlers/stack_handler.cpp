@@ -1,4 +1,5 @@
 #include "http/c_http_router.h"
+#include "http/c_json_writer.h"
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
@@ -53,8 +54,8 @@ void register_stack_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address", "csp");
-        auto size_str = req.get_query("size", "256");
+        std::string address_str{req.get_query("address", "csp")};
+        std::string size_str{req.get_query("size", "256")};
 
         auto address = bridge.eval_expression(address_str);
         auto size = static_cast<size_t>(std::stoull(size_str));
@@ -65,31 +66,29 @@ void register_stack_routes(c_http_router& router) {
         }
 
         const auto& bytes = result.value();
-
-        // Build pointer-sized entries
-        auto entries = nlohmann::json::array();
         auto ptr_size = sizeof(duint);
+
+        // Pointer-sized entries, written straight into the body
+        c_json_envelope out(256 + bytes.size() / ptr_size * 96);
+        auto& data = out.data();
+        data.begin_object()
+            .address_field("base", address)
+            .key("entries").begin_array();
         for (size_t offset = 0; offset + ptr_size <= bytes.size(); offset += ptr_size) {
             duint value = 0;
             memcpy(&value, bytes.data() + offset, ptr_size);
 
-            auto entry_addr = address + offset;
-            auto label = bridge.get_label_at(value);
-            auto module_name = bridge.get_module_at(value);
-
-            entries.push_back({
-                {"address", format_utils::format_address(entry_addr)},
-                {"value",   format_utils::format_address(value)},
-                {"label",   label},
-                {"module",  module_name}
-            });
-        }
-
-        return s_http_response::ok({
-            {"base",    format_utils::format_address(address)},
-            {"size",    bytes.size()},
-            {"entries", entries}
-        });
+            data.begin_object()
+                .address_field("address", address + offset)
+                .field("label",  bridge.get_label_at(value))
+                .field("module", bridge.get_module_at(value))
+                .address_field("value", value)
+                .end_object();
+        }
+        data.end_array()
+            .field("size", bytes.size())
+            .end_object();
+        return out.finish();
     });
 
     // GET /api/stack/pointers - RSP/RBP values
@@ -120,7 +119,7 @@ void register_stack_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -144,7 +143,7 @@ void register_stack_routes(c_http_router& router) {
             return s_http_response::conflict("Debugger must be paused");
         }
 
-        auto handle_str = req.get_query("handle");
+        std::string handle_str{req.get_query("handle")};
         if (handle_str.empty()) {
             return s_http_response::bad_request("Missing 'handle' query parameter");
         }
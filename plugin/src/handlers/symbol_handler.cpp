@@ -1,10 +1,12 @@
 #include "http/c_http_router.h"
+#include "http/c_json_stream.h"
 #include "bridge/c_bridge_executor.h"
 #include "util/format_utils.h"
 
 #include <algorithm>
 #include <cctype>
 #include <string>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include "bridgemain.h"
 
@@ -13,9 +15,12 @@ namespace handlers {
 namespace {
 
 struct sym_collect {
-    nlohmann::json* arr = nullptr;
+    nlohmann::json* arr = nullptr;          // collect into an array...
     std::string filter; // lowercase substring; empty = no filter
     size_t limit = 0;
+    c_json_array_stream* stream = nullptr;  // ...or stream to the client instead
+
+    [[nodiscard]] size_t count() const { return stream ? stream->count() : arr->size(); }
 };
 
 std::string to_lower(std::string s) {
@@ -27,30 +32,43 @@ std::string to_lower(std::string s) {
 // Non-capturing callback so it converts to the C function pointer CBSYMBOLENUM.
 bool sym_enum_cb(const SYMBOLPTR* symbol, void* user) {
     auto* ctx = static_cast<sym_collect*>(user);
-    if (ctx->arr->size() >= ctx->limit) {
+    if (ctx->count() >= ctx->limit || (ctx->stream && !ctx->stream->alive())) {
         return false; // stop enumeration
     }
 
     SYMBOLINFOCPP info; // RAII: frees decorated/undecorated on scope exit
     DbgGetSymbolInfo(symbol, &info);
 
-    std::string decorated = info.decoratedSymbol ? info.decoratedSymbol : "";
-    std::string undecorated = info.undecoratedSymbol ? info.undecoratedSymbol : "";
+    std::string_view decorated = info.decoratedSymbol ? info.decoratedSymbol : "";
+    std::string_view undecorated = info.undecoratedSymbol ? info.undecoratedSymbol : "";
 
     if (!ctx->filter.empty()) {
-        auto hay = to_lower(decorated + " " + undecorated);
+        auto hay = to_lower(std::string(decorated) + " " + std::string(undecorated));
         if (hay.find(ctx->filter) == std::string::npos) {
             return true; // skip, keep going
         }
     }
 
-    ctx->arr->push_back({
-        {"address",     format_utils::format_address(info.addr)},
-        {"decorated",   decorated},
-        {"undecorated", undecorated},
-        {"type",        static_cast<int>(info.type)},
-        {"ordinal",     info.ordinal}
-    });
+    if (ctx->stream) {
+        // Listings run to thousands of entries: no DOM per symbol
+        ctx->stream->emit([&](c_json_writer& out) {
+            out.begin_object()
+               .address_field("address", info.addr)
+               .field("decorated",   decorated)
+               .field("ordinal",     info.ordinal)
+               .field("type",        static_cast<int>(info.type))
+               .field("undecorated", undecorated)
+               .end_object();
+        });
+    } else {
+        ctx->arr->push_back({
+            {"address",     format_utils::format_address(info.addr)},
+            {"decorated",   decorated},
+            {"undecorated", undecorated},
+            {"type",        static_cast<int>(info.type)},
+            {"ordinal",     info.ordinal}
+        });
+    }
     return true;
 }
 
@@ -64,7 +82,7 @@ void register_symbol_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto name = req.get_query("name");
+        std::string name{req.get_query("name")};
         if (name.empty()) {
             return s_http_response::bad_request("Missing 'name' query parameter");
         }
@@ -91,7 +109,7 @@ void register_symbol_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -114,8 +132,8 @@ void register_symbol_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto pattern = req.get_query("pattern");
-        auto module = req.get_query("module");
+        std::string pattern{req.get_query("pattern")};
+        std::string module{req.get_query("module")};
         if (pattern.empty()) {
             return s_http_response::bad_request("Missing 'pattern' query parameter");
         }
@@ -150,7 +168,7 @@ void register_symbol_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto module = req.get_query("module");
+        std::string module{req.get_query("module")};
         if (module.empty()) {
             return s_http_response::bad_request("Missing 'module' query parameter");
         }
@@ -163,19 +181,25 @@ void register_symbol_routes(c_http_router& router) {
         // Make sure symbols are loaded, then enumerate them.
         bridge.exec_command("symload " + module);
 
-        constexpr size_t kLimit = 5000;
-        auto symbols = nlohmann::json::array();
-        sym_collect ctx{&symbols, "", kLimit};
-        DbgSymbolEnum(base, sym_enum_cb, &ctx);
-
-        return s_http_response::ok({
-            {"module",    module},
-            {"base",      format_utils::format_address(base)},
-            {"symbols",   symbols},
-            {"count",     symbols.size()},
-            {"truncated", symbols.size() >= kLimit}
+        // Stream symbols to the client as the enumeration produces them
+        return s_http_response::chunked([module, base](const body_writer_t& write) {
+            constexpr size_t kLimit = 5000;
+            c_json_array_stream out(write, {
+                {"module", module},
+                {"base",   format_utils::format_address(base)}
+            }, "symbols");
+
+            sym_collect ctx{nullptr, "", kLimit, &out};
+            DbgSymbolEnum(base, sym_enum_cb, &ctx);
+
+            out.finish({
+                {"count",     out.count()},
+                {"truncated", out.count() >= kLimit}
+            });
         });
     });
+    router.cacheable("/api/symbols/list");
+    router.assign_lane("/api/symbols/list", e_lane::bulk);
 }
 
 } // namespace handlers
@@ -23,6 +23,7 @@ void register_thread_routes(c_http_router& router) {
 
         return s_http_response::ok(result.value());
     });
+    router.cacheable("/api/threads/list");
 
     // GET /api/threads/current - Current thread info
     router.get("/api/threads/current", [](const s_http_request&) -> s_http_response {
@@ -53,14 +54,14 @@ void register_thread_routes(c_http_router& router) {
         return s_http_response::not_found("No current thread");
     });
 
-    // GET /api/threads/get?id=N - Specific thread by ID
-    router.get("/api/threads/get", [](const s_http_request& req) -> s_http_response {
+    // GET /api/threads/get?id=N or /api/threads/{id} - Specific thread by ID
+    auto get_thread = [](const s_http_request& req) -> s_http_response {
         auto& bridge = get_bridge();
         if (!bridge.require_debugging()) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto id_str = req.get_query("id");
+        std::string id_str{req.get_param("id", req.get_query("id"))};
         if (id_str.empty()) {
             return s_http_response::bad_request("Missing 'id' query parameter");
         }
@@ -78,7 +79,9 @@ void register_thread_routes(c_http_router& router) {
         }
 
         return s_http_response::not_found("Thread not found: " + id_str);
-    });
+    };
+    router.get("/api/threads/get", get_thread);
+    router.get("/api/threads/{id}", get_thread);
 
     // POST /api/threads/switch - Switch active thread
     router.post("/api/threads/switch", [](const s_http_request& req) -> s_http_response {
@@ -162,7 +165,7 @@ void register_thread_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto tid_str = req.get_query("tid");
+        std::string tid_str{req.get_query("tid")};
         if (tid_str.empty()) {
             return s_http_response::bad_request("Missing 'tid' query parameter");
         }
@@ -184,7 +187,7 @@ void register_thread_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto tid_str = req.get_query("tid");
+        std::string tid_str{req.get_query("tid")};
         if (tid_str.empty()) {
             return s_http_response::bad_request("Missing 'tid' query parameter");
         }
@@ -199,6 +202,10 @@ void register_thread_routes(c_http_router& router) {
             {"found", found}
         });
     });
+
+    router.mutating("/api/threads/switch");
+    router.mutating("/api/threads/suspend");
+    router.mutating("/api/threads/resume");
 }
 
 } // namespace handlers
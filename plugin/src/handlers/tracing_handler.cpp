@@ -122,7 +122,7 @@ void register_tracing_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -143,7 +143,7 @@ void register_tracing_routes(c_http_router& router) {
             return s_http_response::conflict("No active debug session");
         }
 
-        auto address_str = req.get_query("address");
+        std::string address_str{req.get_query("address")};
         if (address_str.empty()) {
             return s_http_response::bad_request("Missing 'address' query parameter");
         }
@@ -311,6 +311,15 @@ void register_tracing_routes(c_http_router& router) {
             {"message",   "Trace log configured. Run a conditional trace to start logging."}
         });
     });
+
+    router.mutating("/api/trace/into");
+    router.mutating("/api/trace/over");
+    router.mutating("/api/trace/run");
+    router.mutating("/api/trace/stop");
+    router.mutating("/api/trace/record/set_type");
+    router.mutating("/api/trace/animate");
+    router.mutating("/api/trace/conditional_run");
+    router.mutating("/api/trace/log");
 }
 
 } // namespace handlers
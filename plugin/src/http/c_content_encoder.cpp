@@ -0,0 +1,263 @@
+#include "http/c_content_encoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include "lz4/lz4.h"   // x64dbg SDK; lz4.dll ships with the debugger
+#else
+#define LZ4_DISABLE_DEPRECATE_WARNINGS
+#include <lz4.h>       // system liblz4 (benchmarks)
+#endif
+
+namespace {
+
+constexpr int GZIP_LEVEL = 1;                    // speed over ratio: JSON still shrinks ~5x
+constexpr int GZIP_WINDOW_BITS = 15 + 16;        // +16 selects the gzip wrapper
+constexpr size_t LZ4_BLOCK_MAX = 4 * 1024 * 1024;
+
+// LZ4 frame descriptor: version 01, independent blocks, no checksums, no
+// content size (streamed bodies do not know it); 4MB maximum block size.
+constexpr uint8_t LZ4_FLG = 0x60;
+constexpr uint8_t LZ4_BD = 0x70;
+
+constexpr uint32_t rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+// XXH32 of a descriptor shorter than 4 bytes (all the frame header needs)
+constexpr uint32_t xxh32_short(const uint8_t* data, size_t len) {
+    constexpr uint32_t PRIME1 = 2654435761U, PRIME2 = 2246822519U, PRIME3 = 3266489917U, PRIME5 = 374761393U;
+    uint32_t h = PRIME5 + static_cast<uint32_t>(len);
+    for (size_t i = 0; i < len; ++i) {
+        h += data[i] * PRIME5;
+        h = rotl32(h, 11) * PRIME1;
+    }
+    h ^= h >> 15;
+    h *= PRIME2;
+    h ^= h >> 13;
+    h *= PRIME3;
+    h ^= h >> 16;
+    return h;
+}
+
+constexpr uint8_t lz4_header_checksum() {
+    constexpr uint8_t descriptor[] = {LZ4_FLG, LZ4_BD};
+    return static_cast<uint8_t>((xxh32_short(descriptor, sizeof(descriptor)) >> 8) & 0xFF);
+}
+
+void append_le32(std::string& out, uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>(value & 0xFF),
+        static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF),
+        static_cast<char>((value >> 24) & 0xFF)
+    };
+    out.append(bytes, sizeof(bytes));
+}
+
+char ascii_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (ascii_lower(a[i]) != b[i]) return false;
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// A q-value is zero unless it has a non-zero digit ("0", "0.000" vs "0.5", "1")
+bool q_is_zero(std::string_view params) {
+    while (!params.empty()) {
+        auto semi = params.find(';');
+        auto param = trim(params.substr(0, semi));
+        params = (semi == std::string_view::npos) ? std::string_view{} : params.substr(semi + 1);
+
+        if (param.size() >= 2 && ascii_lower(param[0]) == 'q' && param[1] == '=') {
+            auto value = param.substr(2);
+            return std::none_of(value.begin(), value.end(), [](char c) { return c >= '1' && c <= '9'; });
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+struct c_content_encoder::s_deflate_state {
+    z_stream stream{};
+    bool ready = false;
+
+    s_deflate_state() {
+        ready = deflateInit2(&stream, GZIP_LEVEL, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+
+    ~s_deflate_state() {
+        if (ready) {
+            deflateEnd(&stream);
+        }
+    }
+
+    // Feed data and collect everything deflate produces for the given flush mode
+    std::expected<std::string, std::string> run(std::string_view data, int flush) {
+        if (!ready) {
+            return std::unexpected("deflateInit2 failed");
+        }
+
+        std::string out;
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+
+        for (;;) {
+            size_t used = out.size();
+            size_t room = std::max<size_t>(deflateBound(&stream, stream.avail_in), 64);
+            out.resize(used + room);
+            stream.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+            stream.avail_out = static_cast<uInt>(room);
+
+            int rc = deflate(&stream, flush);
+            out.resize(out.size() - stream.avail_out);
+
+            if (rc == Z_STREAM_ERROR) {
+                return std::unexpected("deflate failed");
+            }
+            if (flush == Z_FINISH ? rc == Z_STREAM_END : stream.avail_out != 0) {
+                return out;
+            }
+        }
+    }
+};
+
+c_content_encoder::c_content_encoder(e_content_encoding encoding) : m_encoding(encoding) {
+    if (m_encoding == e_content_encoding::gzip) {
+        m_deflate = std::make_unique<s_deflate_state>();
+    }
+}
+
+c_content_encoder::~c_content_encoder() = default;
+
+std::expected<std::string, std::string> c_content_encoder::update(std::string_view data) {
+    switch (m_encoding) {
+        case e_content_encoding::gzip: return m_deflate->run(data, Z_SYNC_FLUSH);
+        case e_content_encoding::lz4:  return lz4_blocks(data);
+        default:                       return std::string(data);
+    }
+}
+
+std::expected<std::string, std::string> c_content_encoder::finish() {
+    switch (m_encoding) {
+        case e_content_encoding::gzip:
+            return m_deflate->run({}, Z_FINISH);
+        case e_content_encoding::lz4: {
+            auto out = lz4_blocks({});
+            append_le32(out, 0); // end mark
+            return out;
+        }
+        default:
+            return std::string();
+    }
+}
+
+std::expected<std::string, std::string> c_content_encoder::encode(
+    e_content_encoding encoding, std::string_view data
+) {
+    c_content_encoder encoder(encoding);
+    if (encoding == e_content_encoding::gzip) {
+        // One deflate call with Z_FINISH; no sync-flush markers needed
+        return encoder.m_deflate->run(data, Z_FINISH);
+    }
+
+    auto body = encoder.update(data);
+    auto tail = encoder.finish();
+    if (!body) return body;
+    if (!tail) return tail;
+    body->append(*tail);
+    return body;
+}
+
+std::string c_content_encoder::lz4_blocks(std::string_view data) {
+    std::string out;
+    if (!m_started) {
+        append_le32(out, 0x184D2204); // frame magic
+        out += static_cast<char>(LZ4_FLG);
+        out += static_cast<char>(LZ4_BD);
+        out += static_cast<char>(lz4_header_checksum());
+        m_started = true;
+    }
+
+    while (!data.empty()) {
+        auto block = data.substr(0, LZ4_BLOCK_MAX);
+        data.remove_prefix(block.size());
+
+        // Compress into the output in place; a block that does not shrink is
+        // stored as-is (high bit of the size word set)
+        size_t size_pos = out.size();
+        out.resize(size_pos + 4 + block.size());
+        int packed = LZ4_compress_limitedOutput(
+            block.data(), out.data() + size_pos + 4,
+            static_cast<int>(block.size()), static_cast<int>(block.size()) - 1
+        );
+
+        uint32_t size_word;
+        if (packed > 0) {
+            size_word = static_cast<uint32_t>(packed);
+            out.resize(size_pos + 4 + static_cast<size_t>(packed));
+        } else {
+            size_word = static_cast<uint32_t>(block.size()) | 0x80000000U;
+            std::memcpy(out.data() + size_pos + 4, block.data(), block.size());
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            out[size_pos + i] = static_cast<char>((size_word >> (8 * i)) & 0xFF);
+        }
+    }
+    return out;
+}
+
+e_content_encoding c_content_encoder::negotiate(std::string_view accept_encoding) {
+    bool lz4 = false;
+    bool gzip = false;
+    bool gzip_listed = false;
+    bool any = false;
+
+    while (!accept_encoding.empty()) {
+        auto comma = accept_encoding.find(',');
+        auto item = accept_encoding.substr(0, comma);
+        accept_encoding = (comma == std::string_view::npos) ? std::string_view{} : accept_encoding.substr(comma + 1);
+
+        auto semi = item.find(';');
+        auto name = trim(item.substr(0, semi));
+        bool accepted = (semi == std::string_view::npos) || !q_is_zero(item.substr(semi + 1));
+
+        if (iequals(name, "lz4")) {
+            lz4 = accepted;
+        } else if (iequals(name, "gzip") || iequals(name, "x-gzip")) {
+            gzip = accepted;
+            gzip_listed = true;
+        } else if (name == "*") {
+            any = accepted;
+        }
+    }
+
+    // "*" stands in for gzip only; lz4 must be asked for by name
+    if (lz4) return e_content_encoding::lz4;
+    if (gzip || (any && !gzip_listed)) return e_content_encoding::gzip;
+    return e_content_encoding::identity;
+}
+
+std::string_view c_content_encoder::token(e_content_encoding encoding) {
+    switch (encoding) {
+        case e_content_encoding::gzip: return "gzip";
+        case e_content_encoding::lz4:  return "lz4";
+        default:                       return "identity";
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Content codings the server can apply to a response body
+enum class e_content_encoding {
+    identity,
+    gzip,   // RFC 1952, via zlib
+    lz4     // LZ4 frame format (lz4 --decompress / lz4.frame), via the SDK's lz4
+};
+
+// Compresses one response body, either in one call or piece by piece for a
+// streamed body. Every piece is flushed, so the client can decode all bytes
+// received so far without waiting for the rest.
+class c_content_encoder {
+public:
+    explicit c_content_encoder(e_content_encoding encoding);
+    ~c_content_encoder();
+
+    c_content_encoder(const c_content_encoder&) = delete;
+    c_content_encoder& operator=(const c_content_encoder&) = delete;
+
+    // Encoded bytes for the next piece of the body
+    [[nodiscard]] std::expected<std::string, std::string> update(std::string_view data);
+
+    // Encoded trailer ending the body. Call once, after the last update().
+    [[nodiscard]] std::expected<std::string, std::string> finish();
+
+    // Whole body at once
+    [[nodiscard]] static std::expected<std::string, std::string> encode(
+        e_content_encoding encoding, std::string_view data
+    );
+
+    // Pick the coding to use from an Accept-Encoding header value. lz4 is
+    // preferred (much cheaper to produce), then gzip; q=0 excludes a coding.
+    [[nodiscard]] static e_content_encoding negotiate(std::string_view accept_encoding);
+
+    // Content-Encoding token ("gzip", "lz4", "identity")
+    [[nodiscard]] static std::string_view token(e_content_encoding encoding);
+
+private:
+    struct s_deflate_state;
+
+    e_content_encoding m_encoding;
+    std::unique_ptr<s_deflate_state> m_deflate; // gzip only
+    bool m_started = false;                     // lz4: frame header written
+
+    [[nodiscard]] std::string lz4_blocks(std::string_view data);
+};
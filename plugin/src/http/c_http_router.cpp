@@ -1,7 +1,70 @@
 #include "http/c_http_router.h"
 
+#include <chrono>
+
+#include "util/c_prometheus_writer.h"
+
+namespace {
+
+// Split off the first segment of a path ("a/b/c" -> "a", rest "b/c")
+std::string_view next_segment(std::string_view& rest) {
+    auto slash = rest.find('/');
+    auto segment = rest.substr(0, slash);
+    rest = (slash == std::string_view::npos) ? std::string_view{} : rest.substr(slash + 1);
+    return segment;
+}
+
+bool is_param_segment(std::string_view segment) {
+    return segment.size() > 2 && segment.front() == '{' && segment.back() == '}';
+}
+
+} // namespace
+
 void c_http_router::add_route(const std::string& method, const std::string& path, route_handler_t handler) {
-    m_routes.push_back({method, path, std::move(handler)});
+    auto route = std::make_unique<s_route>();
+    route->handler = std::move(handler);
+    route->method = method;
+    route->path = path;
+    m_routes.push_back(std::move(route));
+    const s_route* stored = m_routes.back().get();
+
+    if (path.find('{') == std::string::npos) {
+        // First registration wins, as with the old linear scan
+        m_exact[method].try_emplace(path, stored);
+        return;
+    }
+
+    auto& root = m_templates[method];
+    if (!root) {
+        root = std::make_unique<s_trie_node>();
+    }
+
+    s_trie_node* node = root.get();
+    std::string_view rest = path;
+    if (!rest.empty() && rest.front() == '/') {
+        rest.remove_prefix(1);
+    }
+
+    while (!rest.empty()) {
+        auto segment = next_segment(rest);
+        if (is_param_segment(segment)) {
+            if (!node->param_child) {
+                node->param_child = std::make_unique<s_trie_node>();
+                node->param_child->param_name = std::string(segment.substr(1, segment.size() - 2));
+            }
+            node = node->param_child.get();
+        } else {
+            auto& child = node->children[std::string(segment)];
+            if (!child) {
+                child = std::make_unique<s_trie_node>();
+            }
+            node = child.get();
+        }
+    }
+
+    if (!node->route) {
+        node->route = stored;
+    }
 }
 
 void c_http_router::get(const std::string& path, route_handler_t handler) {
@@ -12,6 +75,129 @@ void c_http_router::post(const std::string& path, route_handler_t handler) {
     add_route("POST", path, std::move(handler));
 }
 
+void c_http_router::websocket(const std::string& path, websocket_handler_t handler) {
+    m_websockets.try_emplace(path, std::move(handler));
+}
+
+const websocket_handler_t* c_http_router::find_websocket(std::string_view path) const {
+    auto it = m_websockets.find(path);
+    return (it != m_websockets.end()) ? &it->second : nullptr;
+}
+
+void c_http_router::upload(const std::string& path, upload_handler_t handler) {
+    m_uploads.try_emplace(path, std::move(handler));
+}
+
+const upload_handler_t* c_http_router::find_upload(std::string_view path) const {
+    auto it = m_uploads.find(path);
+    return (it != m_uploads.end()) ? &it->second : nullptr;
+}
+
+void c_http_router::cacheable(const std::string& path) {
+    m_cacheable.insert(path);
+}
+
+bool c_http_router::is_cacheable(std::string_view path) const {
+    return m_cacheable.find(path) != m_cacheable.end();
+}
+
+void c_http_router::mutating(const std::string& path) {
+    m_mutating.insert(path);
+}
+
+bool c_http_router::is_mutating(std::string_view path) const {
+    return m_mutating.find(path) != m_mutating.end();
+}
+
+void c_http_router::set_invalidate_hook(std::function<void()> hook) {
+    m_invalidate = std::move(hook);
+}
+
+void c_http_router::assign_lane(const std::string& path, e_lane lane) {
+    m_lanes.insert_or_assign(path, lane);
+}
+
+e_lane c_http_router::lane_of(std::string_view path) const {
+    auto it = m_lanes.find(path);
+    return (it != m_lanes.end()) ? it->second : e_lane::interactive;
+}
+
+const c_http_router::s_route* c_http_router::match(
+    const s_trie_node& node, std::string_view rest, s_http_request::view_pairs& params
+) {
+    if (rest.empty()) {
+        return node.route;
+    }
+
+    auto remaining = rest;
+    auto segment = next_segment(remaining);
+
+    // Literal segments take precedence over {param} at the same depth
+    auto it = node.children.find(segment);
+    if (it != node.children.end()) {
+        if (auto* route = match(*it->second, remaining, params)) {
+            return route;
+        }
+    }
+
+    if (node.param_child && !segment.empty()) {
+        if (auto* route = match(*node.param_child, remaining, params)) {
+            params.emplace_back(node.param_child->param_name, segment);
+            return route;
+        }
+    }
+
+    return nullptr;
+}
+
+const route_handler_t* c_http_router::find(
+    std::string_view method, std::string_view path, s_http_request::view_pairs& params
+) const {
+    const s_route* route = find_route(method, path, params);
+    return route ? &route->handler : nullptr;
+}
+
+const c_http_router::s_route* c_http_router::find_route(
+    std::string_view method, std::string_view path, s_http_request::view_pairs& params
+) const {
+    auto method_it = m_exact.find(method);
+    if (method_it != m_exact.end()) {
+        auto path_it = method_it->second.find(path);
+        if (path_it != method_it->second.end()) {
+            return path_it->second;
+        }
+    }
+
+    auto template_it = m_templates.find(method);
+    if (template_it == m_templates.end()) {
+        return nullptr;
+    }
+
+    if (!path.empty() && path.front() == '/') {
+        path.remove_prefix(1);
+    }
+    return match(*template_it->second, path, params);
+}
+
+s_http_response c_http_router::invoke(const s_route& route, const s_http_request& request,
+                                      s_http_request::view_pairs params) {
+    try {
+        if (params.empty()) {
+            return route.handler(request);
+        }
+        // Templated route: hand the handler a copy carrying the captured segments
+        s_http_request with_params = request;
+        with_params.params = std::move(params);
+        return route.handler(with_params);
+    } catch (const std::exception& e) {
+        return s_http_response::internal_error(
+            std::string("Handler exception: ") + e.what()
+        );
+    } catch (...) {
+        return s_http_response::internal_error("Unknown handler exception");
+    }
+}
+
 s_http_response c_http_router::dispatch(const s_http_request& request) const {
     // Handle CORS preflight
     if (request.method == "OPTIONS") {
@@ -21,22 +207,66 @@ s_http_response c_http_router::dispatch(const s_http_request& request) const {
         return resp;
     }
 
-    // Linear scan through routes (78 routes, negligible cost)
+    s_http_request::view_pairs params;
+    const s_route* route = find_route(request.method, request.path, params);
+    if (!route) {
+        m_unmatched.fetch_add(1, std::memory_order_relaxed);
+        return s_http_response::not_found(
+            "No route for " + std::string(request.method) + " " + std::string(request.path)
+        );
+    }
+
+    // Invalidate on both sides, so nothing computed while it ran stays
+    // cached either. invoke() does not throw.
+    const bool invalidate = m_invalidate && request.method != "GET" && is_mutating(request.path);
+    if (invalidate) {
+        m_invalidate();
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    s_http_response response = invoke(*route, request, std::move(params));
+    // A streamed body is produced later, by the server: this is the time to
+    // the response head
+    route->latency.record(std::chrono::steady_clock::now() - started);
+    size_t status_class = static_cast<size_t>(response.status_code / 100);
+    if (status_class < route->responses.size()) {
+        route->responses[status_class].fetch_add(1, std::memory_order_relaxed);
+    }
+    if (invalidate) {
+        m_invalidate();
+    }
+    return response;
+}
+
+void c_http_router::write_metrics(c_prometheus_writer& out) const {
+    static constexpr std::string_view classes[] = {"", "1xx", "2xx", "3xx", "4xx", "5xx"};
+
+    std::vector<std::pair<const s_route*, c_latency_histogram::s_snapshot>> active;
     for (const auto& route : m_routes) {
-        if (route.method == request.method && route.path == request.path) {
-            try {
-                return route.handler(request);
-            } catch (const std::exception& e) {
-                return s_http_response::internal_error(
-                    std::string("Handler exception: ") + e.what()
-                );
-            } catch (...) {
-                return s_http_response::internal_error("Unknown handler exception");
+        auto snapshot = route->latency.snapshot();
+        if (snapshot.count > 0) {
+            active.emplace_back(route.get(), std::move(snapshot));
+        }
+    }
+
+    out.family("x64dbg_mcp_http_request_duration_seconds", "histogram",
+               "Time spent in the route handler, until the response (or its stream) is returned.");
+    for (const auto& [route, snapshot] : active) {
+        out.histogram("x64dbg_mcp_http_request_duration_seconds",
+                      {{"method", route->method}, {"route", route->path}}, snapshot);
+    }
+
+    out.family("x64dbg_mcp_http_responses_total", "counter", "Responses by route and status class.");
+    for (const auto& [route, snapshot] : active) {
+        for (size_t i = 1; i < route->responses.size(); ++i) {
+            uint64_t count = route->responses[i].load(std::memory_order_relaxed);
+            if (count > 0) {
+                out.sample("x64dbg_mcp_http_responses_total",
+                           {{"method", route->method}, {"route", route->path}, {"status", classes[i]}}, count);
             }
         }
     }
 
-    return s_http_response::not_found(
-        "No route for " + request.method + " " + request.path
-    );
+    out.family("x64dbg_mcp_http_unmatched_requests_total", "counter", "Requests that matched no route (404).");
+    out.sample("x64dbg_mcp_http_unmatched_requests_total", {}, m_unmatched.load(std::memory_order_relaxed));
 }
@@ -1,33 +1,164 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
 #include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
+#include "http/c_request_body.h"
+#include "http/c_websocket.h"
 #include "http/s_http_request.h"
 #include "http/s_http_response.h"
+#include "util/c_latency_histogram.h"
+
+class c_prometheus_writer;
+
+// Execution lanes: each has its own workers and queue in the server, so
+// requests in one never wait for workers busy in another
+enum class e_lane : uint8_t {
+    control,     // pause, state, health, cancel: must answer at once
+    interactive, // everything not assigned elsewhere
+    bulk,        // scans, dumps and batches that can run for seconds
+    count
+};
 
 // Route handler function signature
 using route_handler_t = std::function<s_http_response(const s_http_request&)>;
 
+// Called once a GET on a WebSocket route has been upgraded. The handler sets
+// the session's callbacks and may start sending right away.
+using websocket_handler_t = std::function<void(const s_http_request&, const std::shared_ptr<c_websocket_session>&)>;
+
+// Handles a POST whose body is streamed rather than buffered: the handler
+// pulls it from `body` as it arrives (request.body is empty).
+using upload_handler_t = std::function<s_http_response(const s_http_request&, c_request_body&)>;
+
 class c_http_router {
 public:
-    // Register a route
+    // Register a route. Path segments written as {name} match any single
+    // segment and are exposed to the handler via s_http_request::get_param.
     void add_route(const std::string& method, const std::string& path, route_handler_t handler);
 
     // Convenience helpers
     void get(const std::string& path, route_handler_t handler);
     void post(const std::string& path, route_handler_t handler);
 
-    // Dispatch a request to the appropriate handler
+    // Register a WebSocket endpoint (exact path, GET with Upgrade: websocket)
+    void websocket(const std::string& path, websocket_handler_t handler);
+
+    // The WebSocket handler for a path, or nullptr
+    [[nodiscard]] const websocket_handler_t* find_websocket(std::string_view path) const;
+
+    // Register a streaming upload endpoint (exact path, POST). Requests with
+    // Content-Type: application/octet-stream or a chunked body go here; any
+    // other POST to the same path still goes to its ordinary route.
+    void upload(const std::string& path, upload_handler_t handler);
+
+    // The upload handler for a path, or nullptr
+    [[nodiscard]] const upload_handler_t* find_upload(std::string_view path) const;
+
+    // Mark a GET route (exact path) whose response depends only on the
+    // debuggee's state, so the server may answer repeats from its response
+    // cache while that state holds (see c_response_cache)
+    void cacheable(const std::string& path);
+
+    [[nodiscard]] bool is_cacheable(std::string_view path) const;
+
+    // Mark a route (exact path, any method but GET) that may change the
+    // debuggee or the debugger's database. dispatch() runs the invalidate
+    // hook before and after it, wherever the request came from (the server,
+    // a batch, a shared-memory fetch or a job); other routes leave the
+    // response cache alone.
+    void mutating(const std::string& path);
+
+    [[nodiscard]] bool is_mutating(std::string_view path) const;
+
+    // Called around every mutating route, for the embedder to drop responses
+    // cached from the state the route changes. Set before serving requests.
+    void set_invalidate_hook(std::function<void()> hook);
+
+    // Run requests for a path (exact, any method) in this lane. Paths not
+    // assigned one run in e_lane::interactive.
+    void assign_lane(const std::string& path, e_lane lane);
+
+    [[nodiscard]] e_lane lane_of(std::string_view path) const;
+
+    // Dispatch a request to the appropriate handler. Records the handler's
+    // latency and response status against the route.
     [[nodiscard]] s_http_response dispatch(const s_http_request& request) const;
 
+    // Resolve a route without invoking it. Fills params (views into path and
+    // the route table) for templated routes.
+    // Returns nullptr when nothing matches.
+    [[nodiscard]] const route_handler_t* find(
+        std::string_view method, std::string_view path, s_http_request::view_pairs& params
+    ) const;
+
+    // Per-route latency histograms and response counts (routes that have
+    // served requests), plus requests that matched no route
+    void write_metrics(c_prometheus_writer& out) const;
+
 private:
+    // Hash lookup for string keys without building a temporary std::string
+    struct s_string_hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+    };
+    template <typename T>
+    using string_map = std::unordered_map<std::string, T, s_string_hash, std::equal_to<>>;
+
+    // A registered route and its counters. The counters are atomics that
+    // dispatch() updates through a const route.
     struct s_route {
-        std::string method;
-        std::string path;
         route_handler_t handler;
+        std::string method;
+        std::string path;                                      // as registered: "/api/threads/{id}"
+        mutable c_latency_histogram latency;                   // time in the handler
+        mutable std::array<std::atomic<uint64_t>, 6> responses{}; // by status class (status / 100)
+    };
+
+    // Segment trie for templated paths, one per method
+    struct s_trie_node {
+        string_map<std::unique_ptr<s_trie_node>> children; // literal segments
+        std::unique_ptr<s_trie_node> param_child;          // {name} segment
+        std::string param_name;
+        const s_route* route = nullptr;
     };
 
-    std::vector<s_route> m_routes;
+    // Routes are heap-allocated so the pointers below survive later add_route calls
+    std::vector<std::unique_ptr<s_route>> m_routes;
+
+    // Exact routes: method -> path -> route (the common case, one hash probe each)
+    string_map<string_map<const s_route*>> m_exact;
+
+    // Templated routes: method -> trie root
+    string_map<std::unique_ptr<s_trie_node>> m_templates;
+
+    string_map<websocket_handler_t> m_websockets;
+    string_map<upload_handler_t> m_uploads;
+    std::unordered_set<std::string, s_string_hash, std::equal_to<>> m_cacheable;
+    std::unordered_set<std::string, s_string_hash, std::equal_to<>> m_mutating;
+    std::function<void()> m_invalidate;
+    string_map<e_lane> m_lanes;
+
+    mutable std::atomic<uint64_t> m_unmatched{0};
+
+    [[nodiscard]] const s_route* find_route(
+        std::string_view method, std::string_view path, s_http_request::view_pairs& params
+    ) const;
+
+    // Runs the handler, turning an exception into a 500
+    [[nodiscard]] static s_http_response invoke(
+        const s_route& route, const s_http_request& request, s_http_request::view_pairs params
+    );
+
+    [[nodiscard]] static const s_route* match(
+        const s_trie_node& node, std::string_view rest, s_http_request::view_pairs& params
+    );
 };
@@ -1,18 +1,30 @@
 #include "http/c_http_server.h"
+#include "util/c_prometheus_writer.h"
 
 #include <algorithm>
 #include <cctype>
 #include <charconv>
 #include <chrono>
-#include <sstream>
-#include <mstcpip.h>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
 
+#ifdef _WIN32
 #pragma comment(lib, "ws2_32.lib")
+#endif
 
 c_http_server::~c_http_server() {
     stop();
 }
 
+c_http_server::s_connection::~s_connection() {
+    // The wheel links straight into this object. on_closed disarms it and
+    // nothing re-arms a closed connection, so this is only a backstop.
+    std::lock_guard lock(server.m_timers_mutex);
+    server.disarm_deadline_locked(*this);
+}
+
 std::expected<void, std::string> c_http_server::start(
     const std::string& host, uint16_t port, c_http_router* router
 ) {
@@ -21,27 +33,78 @@ std::expected<void, std::string> c_http_server::start(
     }
 
     m_router = router;
+    m_router->set_invalidate_hook([this] { m_cache.invalidate(); });
     m_port = port;
 
     // Initialize Winsock
-    WSADATA wsa_data{};
-    auto wsa_result = WSAStartup(MAKEWORD(2, 2), &wsa_data);
-    if (wsa_result != 0) {
-        return std::unexpected("WSAStartup failed with error: " + std::to_string(wsa_result));
+    auto startup_error = net::startup();
+    if (!startup_error.empty()) {
+        return std::unexpected(startup_error);
+    }
+
+    auto sock = open_tcp_listener(host, port);
+    if (!sock) {
+        net::cleanup();
+        return std::unexpected(sock.error());
+    }
+
+    // Port 0 binds an ephemeral port; report the one actually chosen
+    if (port == 0) {
+        sockaddr_in bound{};
+        socklen_t bound_len = sizeof(bound);
+        if (getsockname(*sock, reinterpret_cast<sockaddr*>(&bound), &bound_len) == 0) {
+            m_port = ntohs(bound.sin_port);
+        }
     }
 
+    socket_t unix_sock = INVALID_SOCKET;
+    if (!m_unix_socket_path.empty()) {
+        auto opened = open_unix_listener(m_unix_socket_path);
+        if (!opened) {
+            net::close_socket(*sock);
+            net::cleanup();
+            return std::unexpected(opened.error());
+        }
+        unix_sock = *opened;
+    }
+
+    m_reactor = c_io_reactor::create();
+    auto reactor_result = m_reactor->start(IO_THREADS);
+    if (!reactor_result.has_value()) {
+        m_reactor.reset();
+        net::close_socket(*sock);
+        if (unix_sock != INVALID_SOCKET) {
+            net::close_socket(unix_sock);
+            net::remove_socket_file(m_unix_socket_path);
+        }
+        net::cleanup();
+        return std::unexpected(reactor_result.error());
+    }
+
+    m_listen_socket.store(*sock);
+    m_unix_listen_socket.store(unix_sock);
+    m_running.store(true);
+    for (size_t i = 0; i < m_lanes.size(); ++i) {
+        m_lanes[i].pool.start(LANE_CONFIG[i].workers, LANE_CONFIG[i].queue_capacity);
+    }
+    m_timer_thread = std::thread(&c_http_server::timer_loop, this);
+    m_listener_thread = std::thread([this] { listener_loop(m_listen_socket, true); });
+    if (unix_sock != INVALID_SOCKET) {
+        m_unix_listener_thread = std::thread([this] { listener_loop(m_unix_listen_socket, false); });
+    }
+
+    return {};
+}
+
+std::expected<socket_t, std::string> c_http_server::open_tcp_listener(const std::string& host, uint16_t port) {
     // Create listening socket
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    socket_t sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (sock == INVALID_SOCKET) {
-        auto err = WSAGetLastError();
-        WSACleanup();
-        return std::unexpected("socket() failed with error: " + std::to_string(err));
+        return std::unexpected("socket() failed with error: " + std::to_string(net::last_error()));
     }
 
     // Allow address reuse
-    int opt_val = 1;
-    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR,
-               reinterpret_cast<const char*>(&opt_val), sizeof(opt_val));
+    net::set_option(sock, SOL_SOCKET, SO_REUSEADDR, 1);
 
     // Bind to localhost only
     sockaddr_in addr{};
@@ -50,24 +113,63 @@ std::expected<void, std::string> c_http_server::start(
     inet_pton(AF_INET, host.c_str(), &addr.sin_addr);
 
     if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
-        auto err = WSAGetLastError();
-        closesocket(sock);
-        WSACleanup();
+        auto err = net::last_error();
+        net::close_socket(sock);
         return std::unexpected("bind() failed with error: " + std::to_string(err));
     }
 
     if (listen(sock, SOMAXCONN) == SOCKET_ERROR) {
-        auto err = WSAGetLastError();
-        closesocket(sock);
-        WSACleanup();
+        auto err = net::last_error();
+        net::close_socket(sock);
         return std::unexpected("listen() failed with error: " + std::to_string(err));
     }
 
-    m_listen_socket.store(sock);
-    m_running.store(true);
-    m_listener_thread = std::thread(&c_http_server::listener_loop, this);
+    return sock;
+}
 
-    return {};
+std::expected<socket_t, std::string> c_http_server::open_unix_listener(const std::string& path) {
+    sockaddr_un addr{};
+    if (!net::make_unix_address(path, addr)) {
+        return std::unexpected("Unix socket path is empty or longer than " +
+                               std::to_string(sizeof(addr.sun_path) - 1) + " characters");
+    }
+
+    socket_t sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET) {
+        return std::unexpected("socket(AF_UNIX) failed with error: " + std::to_string(net::last_error()));
+    }
+
+    // A socket file outlives its listener. If nobody answers on it, it was
+    // left by a crashed instance and can go; if somebody does, keep out.
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+        socket_t probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool in_use = probe != INVALID_SOCKET &&
+                      connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != SOCKET_ERROR;
+        if (probe != INVALID_SOCKET) {
+            net::close_socket(probe);
+        }
+        if (in_use) {
+            net::close_socket(sock);
+            return std::unexpected("Unix socket " + path + " is in use by another server");
+        }
+
+        net::remove_socket_file(path);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+            auto err = net::last_error();
+            net::close_socket(sock);
+            return std::unexpected("bind(" + path + ") failed with error: " + std::to_string(err));
+        }
+    }
+    net::restrict_to_owner(path);
+
+    if (listen(sock, SOMAXCONN) == SOCKET_ERROR) {
+        auto err = net::last_error();
+        net::close_socket(sock);
+        net::remove_socket_file(path);
+        return std::unexpected("listen(" + path + ") failed with error: " + std::to_string(err));
+    }
+
+    return sock;
 }
 
 void c_http_server::stop() {
@@ -77,58 +179,59 @@ void c_http_server::stop() {
 
     m_running.store(false);
 
-    // Close the listening socket to unblock accept()
-    SOCKET ls = m_listen_socket.exchange(INVALID_SOCKET);
-    if (ls != INVALID_SOCKET) {
-        closesocket(ls);
+    // Close the listening sockets to unblock accept()
+    for (auto* listen_socket : {&m_listen_socket, &m_unix_listen_socket}) {
+        socket_t ls = listen_socket->exchange(INVALID_SOCKET);
+        if (ls != INVALID_SOCKET) {
+            net::shutdown_both(ls);
+            net::close_socket(ls);
+        }
     }
 
-    // Wait for the listener thread to finish
+    // Wait for the listener threads to finish
     if (m_listener_thread.joinable()) {
         m_listener_thread.join();
     }
+    if (m_unix_listener_thread.joinable()) {
+        m_unix_listener_thread.join();
+        net::remove_socket_file(m_unix_socket_path);
+    }
 
-    // Drain in-flight detached connection threads before WSACleanup, so they
-    // don't operate on a torn-down Winsock or the soon-to-be-freed router.
-    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DRAIN_TIMEOUT_MS);
-    while (m_active_connections.load() > 0 && std::chrono::steady_clock::now() < deadline) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    m_timer_thread_cv.notify_all();
+    if (m_timer_thread.joinable()) {
+        m_timer_thread.join();
     }
 
-    WSACleanup();
+    // Let in-flight handlers finish (queued requests are answered with 503),
+    // then tear down every socket. Both happen before WSACleanup, so nothing
+    // touches a torn-down Winsock or the soon-to-be-freed router.
+    for (auto& lane : m_lanes) {
+        lane.pool.stop();
+    }
+    m_reactor->stop();
+    m_reactor.reset();
+
+    {
+        std::lock_guard lock(m_connections_mutex);
+        m_connections.clear();
+    }
+
+    net::cleanup();
 }
 
-void c_http_server::listener_loop() {
-    // Use select() with timeout so we can check m_running periodically
-    // instead of blocking forever in accept()
+void c_http_server::listener_loop(std::atomic<socket_t>& listen_socket, bool tcp) {
+    // Blocking accept: stop() closes the listening socket, which wakes us up.
     while (m_running.load()) {
-        SOCKET ls = m_listen_socket.load();
+        socket_t ls = listen_socket.load();
         if (ls == INVALID_SOCKET) {
             break;
         }
 
-        fd_set read_set;
-        FD_ZERO(&read_set);
-        FD_SET(ls, &read_set);
+        // Large enough for either address family
+        sockaddr_storage client_addr{};
+        socklen_t client_addr_len = sizeof(client_addr);
 
-        timeval tv{};
-        tv.tv_sec = 1;  // 1 second poll interval
-        tv.tv_usec = 0;
-
-        auto sel_result = select(0, &read_set, nullptr, nullptr, &tv);
-        if (sel_result == SOCKET_ERROR) {
-            if (!m_running.load()) break;
-            continue;
-        }
-        if (sel_result == 0) {
-            // Timeout - just loop and check m_running
-            continue;
-        }
-
-        sockaddr_in client_addr{};
-        int client_addr_len = sizeof(client_addr);
-
-        SOCKET client_socket = accept(
+        socket_t client_socket = accept(
             ls,
             reinterpret_cast<sockaddr*>(&client_addr),
             &client_addr_len
@@ -136,115 +239,508 @@ void c_http_server::listener_loop() {
 
         if (client_socket == INVALID_SOCKET) {
             if (!m_running.load()) break;
+            // Out of descriptors or similar: back off instead of spinning
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
             continue;
         }
 
-        // Handle each connection on a detached thread
-        std::thread(&c_http_server::handle_connection, this, client_socket).detach();
+        accept_connection(client_socket, tcp);
     }
 }
 
-bool c_http_server::is_authorized(const s_http_request& request) const {
-    if (m_auth_token.empty()) {
-        return true; // auth disabled
+void c_http_server::timer_loop() {
+    while (m_running.load()) {
+        {
+            std::unique_lock lock(m_timer_thread_mutex);
+            m_timer_thread_cv.wait_for(lock, std::chrono::milliseconds(TIMER_TICK_MS),
+                                       [this] { return !m_running.load(); });
+        }
+
+        // Collect first: connection locks come before m_timers_mutex
+        std::vector<connection_ptr> expired;
+        {
+            std::lock_guard lock(m_timers_mutex);
+            m_timers.advance(std::chrono::steady_clock::now(), [&](c_timer_wheel::s_timer& timer) {
+                auto& deadline = static_cast<s_deadline&>(timer);
+                m_deadlines_pending[static_cast<size_t>(deadline.kind)].fetch_sub(1, std::memory_order_relaxed);
+                if (auto conn = deadline.conn.lock()) {
+                    expired.push_back(std::move(conn));
+                }
+            });
+        }
+
+        for (const auto& conn : expired) {
+            expire_deadline(conn);
+        }
     }
+}
 
-    // Accept either "Authorization: Bearer <token>" or "X-Auth-Token: <token>".
-    // Header keys are stored lowercased by parse_request.
-    auto it = request.headers.find("authorization");
-    if (it != request.headers.end()) {
-        static const std::string prefix = "Bearer ";
-        const std::string& v = it->second;
-        if (v.size() > prefix.size() &&
-            v.compare(0, prefix.size(), prefix) == 0 &&
-            v.substr(prefix.size()) == m_auth_token) {
-            return true;
+std::optional<std::pair<c_http_server::e_deadline, std::chrono::steady_clock::time_point>>
+c_http_server::next_deadline_locked(const connection_ptr& conn) {
+    using std::chrono::milliseconds;
+    if (conn->closing || !conn->channel || conn->channel_closed.load()) {
+        return std::nullopt;
+    }
+
+    if (conn->busy) {
+        // The handler has the request; only a streamed upload body is still
+        // coming from the client
+        if (conn->upload && conn->upload->receiving()) {
+            return std::pair{e_deadline::body, conn->last_activity + milliseconds(BODY_TIMEOUT_MS)};
         }
+        return std::nullopt;
     }
 
-    auto it2 = request.headers.find("x-auth-token");
-    if (it2 != request.headers.end() && it2->second == m_auth_token) {
-        return true;
+    if (conn->websocket) {
+        auto idle = conn->last_activity + milliseconds(WS_IDLE_TIMEOUT_MS);
+        auto ping = std::max(conn->last_activity, conn->last_ping) + milliseconds(WS_PING_INTERVAL_MS);
+        return std::pair{e_deadline::websocket, std::min(idle, ping)};
     }
 
-    return false;
+    if (conn->buffer.empty()) {
+        return std::pair{e_deadline::idle, conn->last_activity + milliseconds(KEEP_ALIVE_TIMEOUT_MS)};
+    }
+    if (conn->buffer.find("\r\n\r\n") == std::string::npos) {
+        return std::pair{e_deadline::header, conn->request_started + milliseconds(HEADER_TIMEOUT_MS)};
+    }
+    return std::pair{e_deadline::body, conn->last_activity + milliseconds(BODY_TIMEOUT_MS)};
 }
 
-void c_http_server::handle_connection(SOCKET client_socket) {
-    // Track this connection so stop() can drain in-flight requests before WSACleanup.
-    m_active_connections.fetch_add(1);
+void c_http_server::update_deadline_locked(const connection_ptr& conn) {
+    auto next = next_deadline_locked(conn);
 
-    s_http_response response;
+    std::lock_guard lock(m_timers_mutex);
 
-    // Everything below runs on a detached thread. A single uncaught exception
-    // here would call std::terminate() and crash all of x64dbg, so the entire
-    // body is wrapped: any throw becomes a 500 instead of a process kill.
-    try {
-        // Set receive/send timeouts
-        DWORD timeout = RECV_TIMEOUT_MS;
-        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO,
-                   reinterpret_cast<const char*>(&timeout), sizeof(timeout));
-        setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO,
-                   reinterpret_cast<const char*>(&timeout), sizeof(timeout));
-
-        int nodelay = 1;
-        setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY,
-                   reinterpret_cast<const char*>(&nodelay), sizeof(nodelay));
-
-        int keepalive = 1;
-        setsockopt(client_socket, SOL_SOCKET, SO_KEEPALIVE,
-                   reinterpret_cast<const char*>(&keepalive), sizeof(keepalive));
-
-        // Read the full request
-        std::string raw_data;
-        raw_data.reserve(4096);
-
-        char buffer[4096];
-        size_t content_length = 0;
-        bool headers_complete = false;
-        bool too_large = false;
-        size_t header_end_pos = std::string::npos;
-
-        while (true) {
-            auto bytes_read = recv(client_socket, buffer, sizeof(buffer), 0);
-            if (bytes_read <= 0) break;
-
-            raw_data.append(buffer, static_cast<size_t>(bytes_read));
-
-            if (!headers_complete) {
-                header_end_pos = raw_data.find("\r\n\r\n");
-                if (header_end_pos != std::string::npos) {
-                    headers_complete = true;
-                    content_length = parse_content_length(raw_data, header_end_pos, too_large);
-                    if (too_large) break;
-                }
-            }
+    // on_closed does not take conn->mutex, so the channel may have closed
+    // since next_deadline_locked looked. It sets channel_closed before
+    // disarming under m_timers_mutex: checking here means either it sees
+    // the timer armed below, or we see the flag and arm nothing.
+    if (conn->channel_closed.load()) {
+        disarm_deadline_locked(*conn);
+        return;
+    }
+
+    auto& deadline = conn->deadline;
+    if (deadline.armed()) {
+        if (next && next->first == deadline.kind) {
+            return; // still due no later than it will fire
+        }
+        disarm_deadline_locked(*conn);
+    }
+    if (next) {
+        deadline.kind = next->first;
+        m_timers.schedule(deadline, next->second);
+        m_deadlines_pending[static_cast<size_t>(deadline.kind)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-            if (headers_complete) {
-                auto body_start = header_end_pos + 4;
-                auto body_received = raw_data.size() - body_start;
-                if (body_received >= content_length) break;
+void c_http_server::disarm_deadline_locked(s_connection& conn) {
+    if (conn.deadline.armed()) {
+        m_timers.cancel(conn.deadline);
+        m_deadlines_pending[static_cast<size_t>(conn.deadline.kind)].fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void c_http_server::expire_deadline(const connection_ptr& conn) {
+    std::lock_guard lock(conn->mutex);
+    auto next = next_deadline_locked(conn);
+    auto now = std::chrono::steady_clock::now();
+    if (next && next->second <= now) {
+        m_deadlines_expired[static_cast<size_t>(next->first)].fetch_add(1, std::memory_order_relaxed);
+
+        switch (next->first) {
+        case e_deadline::header:
+        case e_deadline::body:
+            m_rejected_timeout.fetch_add(1, std::memory_order_relaxed);
+            if (conn->busy) {
+                // The upload handler sees the failure and responds
+                conn->upload->abort("Timed out waiting for the request body");
+            } else {
+                respond_locked(conn, s_http_response::bad_request("Incomplete request (timed out)"), false);
             }
+            break;
 
-            // Safety: never buffer more than MAX_REQUEST_SIZE
-            if (raw_data.size() > MAX_REQUEST_SIZE) {
-                too_large = true;
-                break;
+        case e_deadline::idle:
+            conn->closing = true;
+            conn->channel->close_after_send();
+            break;
+
+        case e_deadline::websocket:
+            // WebSocket clients may legitimately stay quiet: probe them with
+            // pings and drop only those that stop answering
+            if (now - conn->last_activity >= std::chrono::milliseconds(WS_IDLE_TIMEOUT_MS)) {
+                conn->closing = true;
+                conn->channel->close();
+            } else {
+                conn->websocket->ping();
+                conn->last_ping = now;
             }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Not due yet (activity moved it), or a new one after acting
+    update_deadline_locked(conn);
+}
+
+void c_http_server::accept_connection(socket_t client_socket, bool tcp) {
+    if (tcp) {
+        net::set_option(client_socket, IPPROTO_TCP, TCP_NODELAY, 1);
+        net::set_option(client_socket, SOL_SOCKET, SO_KEEPALIVE, 1);
+    }
+
+    auto conn = std::make_shared<s_connection>(*this);
+    {
+        std::lock_guard lock(m_connections_mutex);
+        m_connections.insert(conn);
+    }
+    m_connections_accepted.fetch_add(1, std::memory_order_relaxed);
+
+    // Hold the connection lock across attach(): data can arrive on an I/O
+    // thread before conn->channel is assigned.
+    std::lock_guard lock(conn->mutex);
+
+    s_io_callbacks callbacks;
+    callbacks.on_data = [this, conn](std::string_view data) { on_data(conn, data); };
+    callbacks.on_eof = [this, conn] { on_eof(conn); };
+    callbacks.on_closed = [this, conn] { on_closed(conn); };
+
+    conn->channel = m_reactor->attach(client_socket, std::move(callbacks));
+    if (!conn->channel) {
+        std::lock_guard connections_lock(m_connections_mutex);
+        m_connections.erase(conn);
+        return;
+    }
+
+    conn->deadline.conn = conn;
+    update_deadline_locked(conn);
+}
+
+void c_http_server::on_data(const connection_ptr& conn, std::string_view data) {
+    std::lock_guard lock(conn->mutex);
+    if (conn->closing) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (conn->buffer.empty()) {
+        conn->request_started = now;
+    }
+    conn->last_activity = now;
+    m_bytes_received.fetch_add(data.size(), std::memory_order_relaxed);
+
+    if (conn->upload) {
+        // Body of the upload in progress; a pipelined request may follow it
+        data.remove_prefix(conn->upload->feed(data));
+        if (data.empty()) {
+            update_deadline_locked(conn);
+            return;
         }
+    }
+    conn->buffer.append(data);
+
+    if (conn->websocket) {
+        // While the upgrade handler runs (busy), frames wait in the buffer
+        if (!conn->busy) {
+            feed_websocket_locked(conn);
+        }
+        return; // the ping deadline is re-armed lazily when it fires
+    }
+
+    // A client pipelining far ahead of a slow handler: refuse to buffer it all.
+    if (conn->busy && conn->buffer.size() > 2 * MAX_REQUEST_SIZE) {
+        m_rejected_overflow.fetch_add(1, std::memory_order_relaxed);
+        conn->closing = true;
+        conn->channel->close();
+        return;
+    }
+
+    start_next_request_locked(conn);
+    update_deadline_locked(conn);
+}
+
+void c_http_server::on_eof(const connection_ptr& conn) {
+    std::lock_guard lock(conn->mutex);
+    conn->peer_eof = true;
+    if (conn->upload) {
+        conn->upload->abort("Connection closed before the request body was complete");
+    }
+    if (conn->websocket && !conn->closing) {
+        conn->closing = true;
+        conn->channel->close_after_send();
+        return;
+    }
+    start_next_request_locked(conn);
+    update_deadline_locked(conn);
+}
+
+void c_http_server::on_closed(const connection_ptr& conn) {
+    // No conn->mutex here: channel->close() runs this inline, usually with the
+    // mutex held. Mid-upgrade, upgrade_websocket reports the close once the
+    // handler is done; whichever of the two comes second does it.
+    conn->channel_closed.store(true);
+    if (conn->websocket_ready.load()) {
+        conn->websocket->closed();
+    }
+
+    {
+        std::lock_guard lock(m_timers_mutex);
+        disarm_deadline_locked(*conn);
+    }
+
+    std::lock_guard lock(m_connections_mutex);
+    m_connections.erase(conn);
+}
+
+void c_http_server::start_next_request_locked(const connection_ptr& conn) {
+    if (conn->busy || conn->closing || !conn->channel) {
+        return;
+    }
+
+    conn->upload.reset();
+    if (try_start_upload_locked(conn)) {
+        return;
+    }
+
+    size_t request_len = 0;
+    auto framing = find_request(conn->buffer, request_len);
+
+    if (framing == e_framing::incomplete) {
+        if (conn->peer_eof) {
+            // Nothing more will arrive: done with this connection
+            conn->closing = true;
+            conn->channel->close_after_send();
+        }
+        return;
+    }
+
+    if (framing == e_framing::too_large) {
+        m_rejected_too_large.fetch_add(1, std::memory_order_relaxed);
+        respond_locked(conn, s_http_response::bad_request("Request exceeds maximum size"), false);
+        return;
+    }
+
+    // Where this request ends is unknown, so nothing after it can be trusted
+    if (framing == e_framing::bad_length) {
+        m_rejected_malformed.fetch_add(1, std::memory_order_relaxed);
+        respond_locked(conn, s_http_response::bad_request("Invalid Content-Length"), false);
+        return;
+    }
+    if (framing == e_framing::unsupported) {
+        m_rejected_malformed.fetch_add(1, std::memory_order_relaxed);
+        respond_locked(conn, s_http_response::error(411, "Transfer-Encoding is only accepted by upload routes; "
+                                                         "send a Content-Length"), false);
+        return;
+    }
+
+    // The request takes ownership of its bytes. Without pipelining it is the
+    // whole buffer, which is handed over without a copy.
+    std::string raw;
+    if (request_len == conn->buffer.size()) {
+        raw = std::move(conn->buffer);
+        conn->buffer.clear();
+    } else {
+        raw.assign(conn->buffer, 0, request_len);
+        conn->buffer.erase(0, request_len);
+    }
+
+    auto parse_result = parse_request(std::move(raw));
+    conn->request_started = std::chrono::steady_clock::now();
+    ++conn->served;
+
+    if (!parse_result.has_value()) {
+        m_rejected_malformed.fetch_add(1, std::memory_order_relaxed);
+        respond_locked(conn, s_http_response::bad_request(parse_result.error()), false);
+        return;
+    }
 
-        if (too_large) {
-            response = s_http_response::bad_request("Request exceeds maximum size");
+    const bool keep_alive = !conn->peer_eof
+                         && wants_keep_alive(parse_result.value())
+                         && conn->served < MAX_REQUESTS_PER_CONNECTION;
+
+    // The deadline counts from here, so time spent queued for a worker is in
+    // it, and /api/cancel can reach the request while it waits for one
+    attach_cancel_token(parse_result.value());
+    auto cancel = parse_result.value().cancel;
+    std::string request_id(cancel ? parse_result.value().get_header("x-request-id") : std::string_view{});
+
+    // Handlers may block (stepping, scans), so they never run on an I/O
+    // thread, and only share workers with requests of the same lane.
+    const e_lane lane = m_router->lane_of(parse_result.value().path);
+    conn->busy = true;
+    auto submitted = submit_to_lane(lane,
+        [this, conn, request = std::move(parse_result.value()), keep_alive] {
+            handle_request(conn, request, keep_alive);
+        });
+
+    if (!submitted) {
+        m_rejected_busy.fetch_add(1, std::memory_order_relaxed);
+        conn->busy = false;
+        untrack_cancellable(request_id, cancel);
+        respond_locked(conn, s_http_response::service_unavailable(
+            std::string("Server busy: all ") + LANE_CONFIG[static_cast<size_t>(lane)].name +
+            " workers are occupied, retry shortly"), false);
+    }
+}
+
+bool c_http_server::try_start_upload_locked(const connection_ptr& conn) {
+    // Only the request line and headers are needed to decide
+    if (!conn->buffer.starts_with("POST ")) {
+        return false;
+    }
+    auto header_end_pos = conn->buffer.find("\r\n\r\n");
+    if (header_end_pos == std::string::npos) {
+        return false;
+    }
+    std::string_view target(conn->buffer.data() + 5, header_end_pos - 5);
+    target = target.substr(0, target.find_first_of(" ?\r"));
+    const upload_handler_t* handler = m_router->find_upload(target);
+    if (!handler) {
+        return false;
+    }
+
+    auto head_len = header_end_pos + 4;
+    auto parse_result = parse_request(conn->buffer.substr(0, head_len));
+    if (!parse_result.has_value()) {
+        return false; // the ordinary path reports it
+    }
+    auto& request = parse_result.value();
+
+    // Values are case-insensitive; the octet-stream type may carry parameters
+    auto lowercase = [](std::string_view value) {
+        std::string out(value);
+        for (auto& c : out) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return out;
+    };
+    const bool chunked = lowercase(request.get_header("transfer-encoding")).find("chunked") != std::string::npos;
+    if (!chunked && !lowercase(request.get_header("content-type")).starts_with("application/octet-stream")) {
+        return false; // a JSON body for the route's ordinary handler
+    }
+
+    const size_t length_headers = count_header(std::string_view(conn->buffer).substr(0, header_end_pos),
+                                               "content-length");
+
+    conn->buffer.erase(0, head_len);
+    conn->request_started = std::chrono::steady_clock::now();
+    ++conn->served;
+
+    // As in find_request: more than one length leaves the body's end in doubt
+    if (length_headers > 1) {
+        m_rejected_malformed.fetch_add(1, std::memory_order_relaxed);
+        respond_locked(conn, s_http_response::bad_request("Invalid Content-Length"), false);
+        return true;
+    }
+
+    std::optional<uint64_t> length;
+    if (!chunked) {
+        auto declared = request.get_header("content-length");
+        uint64_t value = 0;
+        auto res = std::from_chars(declared.data(), declared.data() + declared.size(), value);
+        if (declared.empty() || res.ec != std::errc{} || res.ptr != declared.data() + declared.size()) {
+            m_rejected_malformed.fetch_add(1, std::memory_order_relaxed);
+            respond_locked(conn, s_http_response::error(411, "Upload needs a Content-Length or chunked encoding"), false);
+            return true;
+        }
+        length = value;
+    }
+    if (length.value_or(0) > MAX_UPLOAD_SIZE) {
+        m_rejected_too_large.fetch_add(1, std::memory_order_relaxed);
+        respond_locked(conn, s_http_response::error(413, "Upload exceeds " + std::to_string(MAX_UPLOAD_SIZE) +
+                                                         " bytes"), false);
+        return true;
+    }
+
+    // The client may be holding the body back until told to go ahead
+    if (request.version != "HTTP/1.0" && lowercase(request.get_header("expect")) == "100-continue") {
+        std::string go_ahead = "HTTP/1.1 100 Continue\r\n\r\n";
+        m_bytes_sent.fetch_add(go_ahead.size(), std::memory_order_relaxed);
+        conn->channel->send(std::move(go_ahead));
+    }
+
+    // The body must not keep the connection alive: it lives in conn->upload
+    std::weak_ptr<s_connection> weak_conn = conn;
+    conn->upload = std::make_shared<c_request_body>(
+        length, MAX_UPLOAD_SIZE,
+        [channel = conn->channel](bool enabled) { channel->set_reading(enabled); },
+        [this, weak_conn] {
+            auto locked = weak_conn.lock();
+            return m_running.load() && locked && !locked->channel_closed.load();
+        });
+
+    // Body bytes that came in with the head
+    auto consumed = conn->upload->feed(conn->buffer);
+    conn->buffer.erase(0, consumed);
+
+    const bool keep_alive = !conn->peer_eof
+                         && wants_keep_alive(request)
+                         && conn->served < MAX_REQUESTS_PER_CONNECTION;
+
+    const e_lane lane = m_router->lane_of(target);
+    conn->busy = true;
+    auto submitted = submit_to_lane(lane,
+        [this, conn, request = std::move(request), body = conn->upload, handler, keep_alive] {
+            handle_upload(conn, request, body, *handler, keep_alive);
+        });
+
+    if (!submitted) {
+        m_rejected_busy.fetch_add(1, std::memory_order_relaxed);
+        conn->busy = false;
+        conn->upload->abort("Server busy");
+        respond_locked(conn, s_http_response::service_unavailable(
+            std::string("Server busy: all ") + LANE_CONFIG[static_cast<size_t>(lane)].name +
+            " workers are occupied, retry shortly"), false);
+    }
+    return true;
+}
+
+void c_http_server::handle_request(const connection_ptr& conn, const s_http_request& request, bool keep_alive) {
+    m_requests_in_flight.fetch_add(1, std::memory_order_relaxed);
+    struct s_in_flight_guard {
+        std::atomic<uint64_t>& count;
+        ~s_in_flight_guard() { count.fetch_sub(1, std::memory_order_relaxed); }
+    } in_flight{m_requests_in_flight};
+
+    // Cancellable since attach_cancel_token, until the response (streamed
+    // body included) is out or the request is turned away below
+    struct s_cancellable_guard {
+        c_http_server& server;
+        const s_http_request& request;
+        ~s_cancellable_guard() {
+            server.untrack_cancellable(request.get_header("x-request-id"), request.cancel);
+        }
+    } cancellable{*this, request};
+
+    s_http_response response;
+    const websocket_handler_t* upgrade = nullptr;
+    std::optional<c_response_cache::s_ticket> cache_ticket;
+
+    // Runs on a pool worker: any throw becomes a 500 instead of escaping.
+    try {
+        if (!m_running.load()) {
+            response = s_http_response::service_unavailable("Server is shutting down");
+            keep_alive = false;
+        } else if (!is_authorized(request)) {
+            response = s_http_response::unauthorized(
+                "Missing or invalid auth token (Authorization: Bearer <token>)");
+        } else if (auto reason = request.stop_reason(); reason != c_cancel_token::e_reason::none) {
+            // Waited out its deadline in the queue, or was cancelled there
+            response = s_http_response::error(503, reason == c_cancel_token::e_reason::deadline
+                ? "Deadline passed before a worker was free"
+                : "Request was cancelled before it started");
+        } else if (request.method == "GET" &&
+                   c_websocket_session::is_upgrade_request(request.get_header("upgrade")) &&
+                   (upgrade = m_router->find_websocket(request.path)) != nullptr) {
+            // Handled below, outside the 500 fallback: the 101 may already be out
+        } else if (request.method == "GET" && m_router->is_cacheable(request.path) && m_cache.active()) {
+            response = dispatch_cached(request, cache_ticket);
         } else {
-            auto parse_result = parse_request(raw_data);
-            if (!parse_result.has_value()) {
-                response = s_http_response::bad_request(parse_result.error());
-            } else if (!is_authorized(parse_result.value())) {
-                response = s_http_response::unauthorized(
-                    "Missing or invalid auth token (Authorization: Bearer <token>)");
-            } else {
-                response = m_router->dispatch(parse_result.value());
-            }
+            // Invalidates the response cache around routes marked mutating
+            response = m_router->dispatch(request);
         }
     } catch (const std::exception& e) {
         response = s_http_response::internal_error(std::string("Server exception: ") + e.what());
@@ -252,197 +748,821 @@ void c_http_server::handle_connection(SOCKET client_socket) {
         response = s_http_response::internal_error("Unknown server exception");
     }
 
-    // Send response (best effort, handle partial sends)
-    auto response_str = response.serialize();
-    auto total = static_cast<int>(response_str.size());
-    int sent = 0;
-    while (sent < total) {
-        auto result = send(client_socket, response_str.c_str() + sent, total - sent, 0);
-        if (result == SOCKET_ERROR) break;
-        sent += result;
+    if (upgrade) {
+        upgrade_websocket(conn, request, *upgrade);
+        return;
     }
 
-    shutdown(client_socket, SD_SEND);
-    closesocket(client_socket);
-
-    m_active_connections.fetch_sub(1);
+    finish_request(conn, request, std::move(response), keep_alive, cache_ticket ? &*cache_ticket : nullptr);
 }
 
-size_t c_http_server::parse_content_length(
-    const std::string& raw_data, size_t header_end_pos, bool& too_large
-) {
-    too_large = false;
+bool c_http_server::submit_to_lane(e_lane lane, c_worker_pool::task_t task) {
+    auto& target = m_lanes[static_cast<size_t>(lane)];
+    auto queued_at = std::chrono::steady_clock::now();
+    bool submitted = target.pool.try_submit([&target, queued_at, task = std::move(task)] {
+        target.queue_wait.record(std::chrono::steady_clock::now() - queued_at);
+        task();
+    });
+    if (!submitted) {
+        target.rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    return submitted;
+}
 
-    auto cl_pos = raw_data.find("Content-Length:");
-    if (cl_pos == std::string::npos) {
-        cl_pos = raw_data.find("content-length:");
+std::array<c_http_server::s_lane_stats, static_cast<size_t>(e_lane::count)> c_http_server::lane_stats() const {
+    std::array<s_lane_stats, static_cast<size_t>(e_lane::count)> stats;
+    for (size_t i = 0; i < m_lanes.size(); ++i) {
+        stats[i].name = LANE_CONFIG[i].name;
+        stats[i].workers = LANE_CONFIG[i].workers;
+        stats[i].busy = m_lanes[i].pool.busy();
+        stats[i].queued = m_lanes[i].pool.queued();
+        stats[i].rejected = m_lanes[i].rejected.load(std::memory_order_relaxed);
+        stats[i].queue_wait = m_lanes[i].queue_wait.snapshot();
     }
-    if (cl_pos == std::string::npos || cl_pos > header_end_pos) {
-        return 0; // no body declared
+    return stats;
+}
+
+void c_http_server::attach_cancel_token(s_http_request& request) {
+    auto budget = request.get_header("x-deadline-ms");
+    uint64_t ms = 0;
+    auto res = std::from_chars(budget.data(), budget.data() + budget.size(), ms);
+    if (!budget.empty() && res.ec == std::errc{} && res.ptr == budget.data() + budget.size()) {
+        request.cancel = std::make_shared<c_cancel_token>(
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(std::min(ms, c_cancel_token::MAX_DEADLINE_MS)));
+    } else if (!request.get_header("x-request-id").empty()) {
+        request.cancel = std::make_shared<c_cancel_token>();
     }
+    track_cancellable(request.get_header("x-request-id"), request.cancel);
+}
 
-    auto val_start = cl_pos + 15; // length of "Content-Length:"
-    auto val_end = raw_data.find("\r\n", val_start);
-    if (val_end == std::string::npos || val_end > header_end_pos + 2) {
-        val_end = header_end_pos;
+void c_http_server::track_cancellable(std::string_view id, const std::shared_ptr<c_cancel_token>& token) {
+    if (!token || id.empty()) {
+        return;
     }
+    std::lock_guard lock(m_cancellable_mutex);
+    m_cancellable.emplace(std::string(id), token);
+}
 
-    // Trim surrounding whitespace, then parse without throwing.
-    auto begin = raw_data.find_first_not_of(" \t", val_start);
-    if (begin == std::string::npos || begin >= val_end) {
-        return 0;
+void c_http_server::untrack_cancellable(std::string_view id, const std::shared_ptr<c_cancel_token>& token) {
+    if (!token || id.empty()) {
+        return;
     }
-    auto last = raw_data.find_last_not_of(" \t\r", val_end - 1);
-    if (last == std::string::npos || last < begin) {
-        return 0;
+    std::lock_guard lock(m_cancellable_mutex);
+    auto [first, last] = m_cancellable.equal_range(std::string(id));
+    for (auto it = first; it != last; ++it) {
+        if (it->second == token) {
+            m_cancellable.erase(it);
+            return;
+        }
     }
+}
 
-    unsigned long long value = 0;
-    auto res = std::from_chars(raw_data.data() + begin, raw_data.data() + last + 1, value);
-    if (res.ec != std::errc{}) {
-        return 0; // malformed Content-Length -> treat as no body, never throw
+size_t c_http_server::cancel_request(std::string_view request_id) {
+    std::lock_guard lock(m_cancellable_mutex);
+    auto [first, last] = m_cancellable.equal_range(std::string(request_id));
+    size_t count = 0;
+    for (auto it = first; it != last; ++it, ++count) {
+        it->second->cancel();
     }
+    return count;
+}
 
-    if (value > MAX_REQUEST_SIZE) {
-        too_large = true;
-        return 0;
+s_http_response c_http_server::dispatch_cached(const s_http_request& request,
+                                              std::optional<c_response_cache::s_ticket>& ticket) {
+    // One entry per representation: the envelope format and content coding
+    // finish_request will pick for this client
+    std::string variant(c_content_encoder::token(c_content_encoder::negotiate(request.get_header("accept-encoding"))));
+    variant += '/';
+    variant += std::to_string(static_cast<int>(s_http_response::negotiate_format(request.get_header("accept"))));
+
+    auto current = m_cache.ticket(request, variant);
+    if (auto entry = m_cache.find(current)) {
+        auto if_none_match = request.get_header("if-none-match");
+        if (!if_none_match.empty() && c_response_cache::matches(if_none_match, current.etag)) {
+            m_cache.record_not_modified();
+            return s_http_response::not_modified(std::move(current.etag));
+        }
+        m_cache.record_hit();
+
+        // Only the head is copied; the body goes out from the entry itself
+        s_http_response hit;
+        hit.status_code = entry->status_code;
+        hit.content_type = entry->content_type;
+        hit.headers = entry->headers;
+        hit.shared_body = std::shared_ptr<const std::string>(entry, &entry->body);
+        return hit;
     }
 
-    return static_cast<size_t>(value);
+    ticket = std::move(current);
+    return m_router->dispatch(request);
 }
 
-std::expected<s_http_request, std::string> c_http_server::parse_request(
-    const std::string& raw_data
-) {
-    if (raw_data.empty()) {
-        return std::unexpected("Empty request");
+void c_http_server::handle_upload(const connection_ptr& conn, const s_http_request& request,
+                                  const std::shared_ptr<c_request_body>& body, const upload_handler_t& handler,
+                                  bool keep_alive) {
+    m_requests_in_flight.fetch_add(1, std::memory_order_relaxed);
+    struct s_in_flight_guard {
+        std::atomic<uint64_t>& count;
+        ~s_in_flight_guard() { count.fetch_sub(1, std::memory_order_relaxed); }
+    } in_flight{m_requests_in_flight};
+
+    s_http_response response;
+    bool mutating = false;
+    try {
+        if (!m_running.load()) {
+            response = s_http_response::service_unavailable("Server is shutting down");
+            keep_alive = false;
+        } else if (!is_authorized(request)) {
+            response = s_http_response::unauthorized(
+                "Missing or invalid auth token (Authorization: Bearer <token>)");
+        } else {
+            // Uploads bypass dispatch(): invalidate here as it would
+            mutating = m_router->is_mutating(request.path);
+            if (mutating) {
+                m_cache.invalidate();
+            }
+            response = handler(request, *body);
+        }
+    } catch (const std::exception& e) {
+        response = s_http_response::internal_error(std::string("Handler exception: ") + e.what());
+    } catch (...) {
+        response = s_http_response::internal_error("Unknown handler exception");
+    }
+    if (mutating) {
+        m_cache.invalidate();
     }
 
-    s_http_request req;
+    // Whatever of the body the handler left unread is still on the wire, in
+    // the way of the next request: swallow it and close after responding
+    if (!body->complete()) {
+        body->abort("Handler finished before the request body");
+        keep_alive = false;
+    }
 
-    // Find end of request line
-    auto line_end = raw_data.find("\r\n");
-    if (line_end == std::string::npos) {
-        return std::unexpected("Malformed request line");
+    finish_request(conn, request, std::move(response), keep_alive);
+}
+
+void c_http_server::finish_request(const connection_ptr& conn, const s_http_request& request,
+                                   s_http_response response, bool keep_alive,
+                                   const c_response_cache::s_ticket* cache_ticket) {
+    keep_alive = keep_alive && m_running.load();
+
+    // Still on the pool worker and past handle_request's fallback: a throw
+    // here would leave the connection busy with no response ever sent
+    auto format = s_http_response::negotiate_format(request.get_header("accept"));
+    try {
+        response.serialize(format);
+        encode_response(response, request);
+        if (cache_ticket && response.status_code == 200) {
+            cache_response(response, *cache_ticket);
+        }
+    } catch (const std::exception& e) {
+        response = s_http_response::internal_error(std::string("Server exception: ") + e.what());
+        response.serialize(format);
+    }
+    if (response.body_stream) {
+        if (response.stream_length || request.version != "HTTP/1.0") {
+            stream_response(conn, response, keep_alive);
+            return;
+        }
+        // HTTP/1.0 has no chunked encoding: collect the body instead
+        response = collect_body(std::move(response));
     }
 
-    auto request_line = raw_data.substr(0, line_end);
+    std::lock_guard lock(conn->mutex);
+    conn->busy = false;
+    conn->last_activity = std::chrono::steady_clock::now();
+    respond_locked(conn, std::move(response), keep_alive);
 
-    // Parse: METHOD PATH HTTP/1.x
-    auto first_space = request_line.find(' ');
-    if (first_space == std::string::npos) {
-        return std::unexpected("Malformed request line: no method");
+    // Serve the next pipelined request, if it is already buffered
+    start_next_request_locked(conn);
+    update_deadline_locked(conn);
+}
+
+void c_http_server::cache_response(s_http_response& response, const c_response_cache::s_ticket& ticket) {
+    // Clients revalidate with If-None-Match rather than reuse blindly: the
+    // next debugger step changes the answer
+    response.headers.emplace_back("ETag", ticket.etag);
+    response.headers.emplace_back("Cache-Control", "no-cache");
+    if (!response.body_stream) {
+        m_cache.store(ticket, response);
+        return;
     }
-    req.method = request_line.substr(0, first_space);
 
-    auto second_space = request_line.find(' ', first_space + 1);
-    if (second_space == std::string::npos) {
-        return std::unexpected("Malformed request line: no path");
+    // Keep a copy of what the stream sends, up to the entry size limit, and
+    // store it only if the whole body went out
+    s_http_response head_only = response;
+    head_only.body_stream = nullptr;
+    head_only.stream_length.reset();
+    response.body_stream = [this, ticket, head_only = std::move(head_only),
+                            producer = std::move(response.body_stream)](const body_writer_t& write) mutable {
+        std::string copy;
+        bool keep = true;
+        bool alive = true;
+        producer([&](std::string piece) {
+            if (keep && copy.size() + piece.size() > c_response_cache::MAX_ENTRY_BYTES) {
+                keep = false;
+                std::string().swap(copy);
+            } else if (keep) {
+                copy += piece;
+            }
+            alive = write(std::move(piece));
+            return alive;
+        });
+        if (keep && alive) {
+            head_only.body = std::move(copy);
+            m_cache.store(ticket, std::move(head_only));
+        }
+    };
+}
+
+void c_http_server::upgrade_websocket(const connection_ptr& conn, const s_http_request& request,
+                                     const websocket_handler_t& handler) {
+    if (!c_websocket_session::has_upgrade_token(request.get_header("connection"))) {
+        std::lock_guard lock(conn->mutex);
+        conn->busy = false;
+        respond_locked(conn, s_http_response::bad_request("WebSocket upgrade needs Connection: Upgrade"), false);
+        return;
     }
-    auto full_path = request_line.substr(first_space + 1, second_space - first_space - 1);
 
-    // Split path and query string
-    auto query_pos = full_path.find('?');
-    if (query_pos != std::string::npos) {
-        req.path = full_path.substr(0, query_pos);
-        req.query_string = full_path.substr(query_pos + 1);
-        parse_query_string(req.query_string, req.query);
-    } else {
-        req.path = full_path;
+    auto key = request.get_header("sec-websocket-key");
+    if (key.empty() || request.get_header("sec-websocket-version") != "13") {
+        auto response = s_http_response::error(426, "WebSocket upgrade needs Sec-WebSocket-Key and version 13");
+        response.headers.emplace_back("Sec-WebSocket-Version", "13");
+
+        std::lock_guard lock(conn->mutex);
+        conn->busy = false;
+        respond_locked(conn, std::move(response), false);
+        return;
     }
 
-    // Parse headers
-    auto header_end = raw_data.find("\r\n\r\n");
-    if (header_end == std::string::npos) {
-        return std::unexpected("Malformed headers");
+    std::shared_ptr<c_websocket_session> session;
+    {
+        std::lock_guard lock(conn->mutex);
+        if (conn->closing || !conn->channel) {
+            conn->busy = false;
+            return;
+        }
+
+        conn->channel->send(c_websocket_session::handshake_response(key));
+        session = std::make_shared<c_websocket_session>(conn->channel);
+        conn->websocket = session;
+        conn->last_activity = std::chrono::steady_clock::now();
+        conn->last_ping = conn->last_activity;
+        // Still busy: frames arriving now are buffered until the handler has
+        // installed its callbacks
     }
 
-    auto headers_section = raw_data.substr(line_end + 2, header_end - line_end - 2);
-    std::istringstream header_stream(headers_section);
-    std::string header_line;
+    try {
+        handler(request, session);
+    } catch (...) {
+        session->close(1011, "Internal error");
+    }
 
-    while (std::getline(header_stream, header_line)) {
-        // Remove trailing \r
-        if (!header_line.empty() && header_line.back() == '\r') {
-            header_line.pop_back();
+    {
+        std::lock_guard lock(conn->mutex);
+        conn->busy = false;
+        if (!conn->channel_closed.load() && !conn->closing) {
+            feed_websocket_locked(conn);
         }
-        if (header_line.empty()) continue;
+        update_deadline_locked(conn);
+    }
 
-        auto colon = header_line.find(':');
-        if (colon == std::string::npos) continue;
+    // Pairs with on_closed: at least one of the two sees the other's flag
+    conn->websocket_ready.store(true);
+    if (conn->channel_closed.load()) {
+        session->closed(); // runs on_close once, whoever calls it
+    }
+}
 
-        auto key = header_line.substr(0, colon);
-        auto value = header_line.substr(colon + 1);
+void c_http_server::feed_websocket_locked(const connection_ptr& conn) {
+    if (!conn->websocket->feed(conn->buffer)) {
+        // The session has sent its close frame
+        conn->closing = true;
+        conn->buffer.clear();
+    }
+}
 
-        // Lowercase the key
-        std::transform(key.begin(), key.end(), key.begin(),
-                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+void c_http_server::encode_response(s_http_response& response, const s_http_request& request) {
+    // Streams of unknown length are the large listings, so they always qualify
+    size_t length = response.body_stream ? response.stream_length.value_or(SIZE_MAX) : response.body.size();
+    if (length < COMPRESSION_THRESHOLD) {
+        return;
+    }
+    for (const auto& [name, value] : response.headers) {
+        if (name == "Content-Encoding") {
+            return; // the handler encoded the body itself
+        }
+    }
 
-        // Trim leading whitespace from value
-        auto val_start = value.find_first_not_of(" \t");
-        if (val_start != std::string::npos) {
-            value = value.substr(val_start);
+    auto encoding = c_content_encoder::negotiate(request.get_header("accept-encoding"));
+    if (encoding == e_content_encoding::identity) {
+        return;
+    }
+
+    // An encoded stream goes out chunked, which HTTP/1.0 lacks: compress it whole
+    if (response.body_stream && request.version == "HTTP/1.0") {
+        response = collect_body(std::move(response));
+    }
+
+    if (!response.body_stream) {
+        auto started = std::chrono::steady_clock::now();
+        auto encoded = c_content_encoder::encode(encoding, response.body);
+        if (!encoded || encoded->size() >= response.body.size()) {
+            return;
         }
+        record_compression(response.body.size(), encoded->size(), std::chrono::steady_clock::now() - started);
+        response.body = std::move(*encoded);
+    } else {
+        // Compress each piece as the producer writes it. The encoded length is
+        // not known up front, so the body is sent chunked.
+        response.body_stream = [this, encoding, producer = std::move(response.body_stream)](const body_writer_t& write) {
+            c_content_encoder encoder(encoding);
+            size_t bytes_in = 0;
+            size_t bytes_out = 0;
+            std::chrono::steady_clock::duration elapsed{};
+            bool failed = false;
+
+            auto encode_piece = [&](std::string_view piece, bool last) -> std::optional<std::string> {
+                auto started = std::chrono::steady_clock::now();
+                auto encoded = last ? encoder.finish() : encoder.update(piece);
+                elapsed += std::chrono::steady_clock::now() - started;
+                if (!encoded) {
+                    failed = true;
+                    return std::nullopt;
+                }
+                bytes_in += piece.size();
+                bytes_out += encoded->size();
+                return std::move(*encoded);
+            };
+
+            bool alive = true;
+            producer([&](std::string piece) {
+                if (piece.empty()) {
+                    return write({}); // liveness probe, nothing to encode
+                }
+                auto encoded = encode_piece(piece, false);
+                alive = encoded && write(std::move(*encoded));
+                return alive;
+            });
+
+            auto tail = alive ? encode_piece({}, true) : std::nullopt;
+            if (failed) {
+                // Ending the chunked body normally would pass off a truncated stream as complete
+                throw std::runtime_error("response compression failed");
+            }
+            if (tail && write(std::move(*tail))) {
+                record_compression(bytes_in, bytes_out, elapsed);
+            }
+        };
+        response.stream_length.reset();
+    }
+
+    response.headers.emplace_back("Content-Encoding", std::string(c_content_encoder::token(encoding)));
+    response.headers.emplace_back("Vary", "Accept-Encoding");
+}
+
+void c_http_server::record_compression(size_t bytes_in, size_t bytes_out, std::chrono::steady_clock::duration elapsed) {
+    m_compressed_responses.fetch_add(1, std::memory_order_relaxed);
+    m_compressed_bytes_in.fetch_add(bytes_in, std::memory_order_relaxed);
+    m_compressed_bytes_out.fetch_add(bytes_out, std::memory_order_relaxed);
+    m_compression_time_us.fetch_add(
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+        std::memory_order_relaxed
+    );
+}
+
+c_http_server::s_compression_stats c_http_server::compression_stats() const {
+    return {
+        m_compressed_responses.load(std::memory_order_relaxed),
+        m_compressed_bytes_in.load(std::memory_order_relaxed),
+        m_compressed_bytes_out.load(std::memory_order_relaxed),
+        m_compression_time_us.load(std::memory_order_relaxed)
+    };
+}
+
+void c_http_server::write_metrics(c_prometheus_writer& out) const {
+    auto counter = [&](std::string_view name, std::string_view help, const std::atomic<uint64_t>& value) {
+        out.family(name, "counter", help);
+        out.sample(name, {}, value.load(std::memory_order_relaxed));
+    };
 
-        req.headers[key] = value;
+    size_t open_connections = 0;
+    {
+        std::lock_guard lock(m_connections_mutex);
+        open_connections = m_connections.size();
+    }
+    out.family("x64dbg_mcp_http_connections_open", "gauge", "Client connections currently open.");
+    out.sample("x64dbg_mcp_http_connections_open", {}, static_cast<uint64_t>(open_connections));
+    counter("x64dbg_mcp_http_connections_accepted_total", "Client connections accepted.", m_connections_accepted);
+
+    out.family("x64dbg_mcp_http_requests_in_flight", "gauge", "Requests being handled, including streaming bodies.");
+    out.sample("x64dbg_mcp_http_requests_in_flight", {}, m_requests_in_flight.load(std::memory_order_relaxed));
+
+    counter("x64dbg_mcp_http_received_bytes_total", "Request bytes received.", m_bytes_received);
+    counter("x64dbg_mcp_http_sent_bytes_total", "HTTP response bytes sent, after compression.", m_bytes_sent);
+
+    out.family("x64dbg_mcp_http_rejected_requests_total", "counter", "Requests refused before reaching a handler.");
+    out.sample("x64dbg_mcp_http_rejected_requests_total", {{"reason", "busy"}},
+               m_rejected_busy.load(std::memory_order_relaxed));
+    out.sample("x64dbg_mcp_http_rejected_requests_total", {{"reason", "malformed"}},
+               m_rejected_malformed.load(std::memory_order_relaxed));
+    out.sample("x64dbg_mcp_http_rejected_requests_total", {{"reason", "too_large"}},
+               m_rejected_too_large.load(std::memory_order_relaxed));
+    out.sample("x64dbg_mcp_http_rejected_requests_total", {{"reason", "timeout"}},
+               m_rejected_timeout.load(std::memory_order_relaxed));
+    out.sample("x64dbg_mcp_http_rejected_requests_total", {{"reason", "pipeline_overflow"}},
+               m_rejected_overflow.load(std::memory_order_relaxed));
+
+    auto lanes = lane_stats();
+    out.family("x64dbg_mcp_http_lane_workers_busy", "gauge", "Workers running a request, by execution lane.");
+    for (const auto& lane : lanes) {
+        out.sample("x64dbg_mcp_http_lane_workers_busy", {{"lane", lane.name}}, static_cast<uint64_t>(lane.busy));
+    }
+    out.family("x64dbg_mcp_http_lane_queued_requests", "gauge", "Requests waiting for a worker, by execution lane.");
+    for (const auto& lane : lanes) {
+        out.sample("x64dbg_mcp_http_lane_queued_requests", {{"lane", lane.name}}, static_cast<uint64_t>(lane.queued));
+    }
+    out.family("x64dbg_mcp_http_lane_rejected_requests_total", "counter",
+               "Requests refused with 503 because their lane's queue was full.");
+    for (const auto& lane : lanes) {
+        out.sample("x64dbg_mcp_http_lane_rejected_requests_total", {{"lane", lane.name}}, lane.rejected);
+    }
+    out.family("x64dbg_mcp_http_lane_queue_wait_seconds", "histogram",
+               "Time from a request being parsed to a worker of its lane starting it.");
+    for (const auto& lane : lanes) {
+        out.histogram("x64dbg_mcp_http_lane_queue_wait_seconds", {{"lane", lane.name}}, lane.queue_wait);
     }
 
-    // Extract body
-    auto body_start = header_end + 4;
-    if (body_start < raw_data.size()) {
-        req.body = raw_data.substr(body_start);
+    constexpr std::array<const char*, static_cast<size_t>(e_deadline::count)> deadline_kinds = {
+        "header", "body", "idle", "websocket"
+    };
+    out.family("x64dbg_mcp_http_deadlines_pending", "gauge", "Connections with an armed deadline, by what they wait for.");
+    for (size_t i = 0; i < deadline_kinds.size(); ++i) {
+        out.sample("x64dbg_mcp_http_deadlines_pending", {{"kind", deadline_kinds[i]}},
+                   m_deadlines_pending[i].load(std::memory_order_relaxed));
+    }
+    out.family("x64dbg_mcp_http_deadlines_expired_total", "counter", "Deadlines that expired, by what was waited for.");
+    for (size_t i = 0; i < deadline_kinds.size(); ++i) {
+        out.sample("x64dbg_mcp_http_deadlines_expired_total", {{"kind", deadline_kinds[i]}},
+                   m_deadlines_expired[i].load(std::memory_order_relaxed));
     }
 
-    return req;
+    counter("x64dbg_mcp_http_compressed_responses_total", "Responses sent with a Content-Encoding.",
+            m_compressed_responses);
+    counter("x64dbg_mcp_http_compression_input_bytes_total", "Body bytes of compressed responses, before compression.",
+            m_compressed_bytes_in);
+    counter("x64dbg_mcp_http_compression_output_bytes_total", "Body bytes of compressed responses, after compression.",
+            m_compressed_bytes_out);
+    out.family("x64dbg_mcp_http_compression_seconds_total", "counter", "Time spent compressing responses.");
+    out.sample("x64dbg_mcp_http_compression_seconds_total", {},
+               static_cast<double>(m_compression_time_us.load(std::memory_order_relaxed)) / 1e6);
+
+    m_cache.write_metrics(out);
+
+    if (m_router) {
+        m_router->write_metrics(out);
+    }
 }
 
-void c_http_server::parse_query_string(
-    const std::string& query_string,
-    std::unordered_map<std::string, std::string>& out
-) {
-    std::istringstream stream(query_string);
-    std::string pair;
-
-    while (std::getline(stream, pair, '&')) {
-        auto eq = pair.find('=');
-        if (eq != std::string::npos) {
-            auto key = url_decode(pair.substr(0, eq));
-            auto value = url_decode(pair.substr(eq + 1));
-            out[key] = value;
-        } else {
-            out[url_decode(pair)] = "";
+void c_http_server::stream_response(const connection_ptr& conn, const s_http_response& response, bool keep_alive) {
+    std::shared_ptr<c_io_channel> channel;
+    {
+        std::lock_guard lock(conn->mutex);
+        if (!conn->closing && conn->channel) {
+            channel = conn->channel;
+            auto head = response.head(keep_alive);
+            m_bytes_sent.fetch_add(head.size(), std::memory_order_relaxed);
+            channel->send(std::move(head));
         }
     }
+
+    // Produce the body without the connection lock: the producer waits on the
+    // socket. Later pipelined requests stay buffered (busy) until it is done.
+    bool complete = channel && produce_body(*channel, response);
+
+    std::lock_guard lock(conn->mutex);
+    conn->busy = false;
+    conn->last_activity = std::chrono::steady_clock::now();
+    if (!channel || conn->closing) {
+        return;
+    }
+
+    if (!complete) {
+        // A short or aborted body breaks the framing: drop the connection
+        conn->closing = true;
+        channel->close();
+        return;
+    }
+
+    if (!keep_alive) {
+        conn->closing = true;
+        channel->close_after_send();
+        return;
+    }
+
+    start_next_request_locked(conn);
+    update_deadline_locked(conn);
 }
 
-std::string c_http_server::url_decode(const std::string& encoded) {
-    auto hex_value = [](char c) -> int {
-        if (c >= '0' && c <= '9') return c - '0';
-        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-        return -1;
+bool c_http_server::produce_body(c_io_channel& channel, const s_http_response& response) {
+    const bool chunked = !response.stream_length.has_value();
+    size_t written = 0;
+    bool alive = true;
+
+    body_writer_t write = [&](std::string piece) {
+        if (!alive || (!chunked && piece.size() > *response.stream_length - written)) {
+            alive = false;
+            return false;
+        }
+        if (piece.empty()) {
+            // Nothing to send (an empty chunk would end the body): just report
+            // whether to go on, so an idle producer notices a shutdown or a
+            // client that has gone away
+            alive = m_running.load() && channel.wait_writable(SIZE_MAX, std::chrono::milliseconds(0));
+            return alive;
+        }
+
+        // Pace the producer to the client: wait while too much is queued, in
+        // slices so a shutdown is not held up by a stalled reader.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(STREAM_STALL_TIMEOUT_MS);
+        while (!channel.wait_writable(STREAM_HIGH_WATERMARK, std::chrono::milliseconds(STREAM_WAIT_SLICE_MS))) {
+            if (!m_running.load() || std::chrono::steady_clock::now() >= deadline) {
+                alive = false;
+                return false;
+            }
+        }
+
+        if (!chunked) {
+            written += piece.size();
+            m_bytes_sent.fetch_add(piece.size(), std::memory_order_relaxed);
+            alive = channel.send(std::move(piece));
+            return alive;
+        }
+
+        // Chunk header, with the previous chunk's closing CRLF in front of it,
+        // so the payload itself goes out untouched.
+        char header[32];
+        char* out = header;
+        if (written > 0) {
+            *out++ = '\r';
+            *out++ = '\n';
+        }
+        out = std::to_chars(out, header + sizeof(header) - 2, piece.size(), 16).ptr;
+        *out++ = '\r';
+        *out++ = '\n';
+
+        written += piece.size();
+        m_bytes_sent.fetch_add(static_cast<size_t>(out - header) + piece.size(), std::memory_order_relaxed);
+        alive = channel.send(std::string(header, out), std::move(piece));
+        return alive;
     };
 
-    std::string result;
-    result.reserve(encoded.size());
+    try {
+        response.body_stream(write);
+    } catch (...) {
+        return false;
+    }
 
-    for (size_t i = 0; i < encoded.size(); ++i) {
-        if (encoded[i] == '%' && i + 2 < encoded.size()) {
-            int hi = hex_value(encoded[i + 1]);
-            int lo = hex_value(encoded[i + 2]);
-            if (hi >= 0 && lo >= 0) {
-                result += static_cast<char>((hi << 4) | lo);
-                i += 2;
-            } else {
-                // Malformed escape: keep the '%' literally instead of throwing.
-                result += encoded[i];
+    if (!chunked) {
+        return alive && written == *response.stream_length;
+    }
+
+    // Last chunk (and the CRLF closing the one before it)
+    if (!alive) {
+        return false;
+    }
+    std::string last = written > 0 ? "\r\n0\r\n\r\n" : "0\r\n\r\n";
+    m_bytes_sent.fetch_add(last.size(), std::memory_order_relaxed);
+    return channel.send(std::move(last));
+}
+
+s_http_response c_http_server::collect_body(s_http_response response) {
+    std::string body;
+    try {
+        response.body_stream([&body](std::string piece) {
+            body += piece;
+            return true;
+        });
+    } catch (const std::exception& e) {
+        return s_http_response::internal_error(std::string("Handler exception: ") + e.what());
+    } catch (...) {
+        return s_http_response::internal_error("Unknown handler exception");
+    }
+
+    response.body_stream = nullptr;
+    response.stream_length.reset();
+    response.body = std::move(body);
+    return response;
+}
+
+void c_http_server::respond_locked(const connection_ptr& conn, s_http_response response, bool keep_alive) {
+    if (conn->closing || !conn->channel) {
+        return;
+    }
+
+    // Server-generated errors (400, 413, 503) never went through negotiation
+    response.serialize(e_body_format::json);
+
+    // Head and body go out in one gathered write; the body is moved (or, from
+    // the response cache, referenced), not copied.
+    auto head = response.head(keep_alive);
+    c_io_buffer body = response.shared_body ? c_io_buffer(std::move(response.shared_body))
+                                            : c_io_buffer(std::move(response.body));
+    m_bytes_sent.fetch_add(head.size() + body.size(), std::memory_order_relaxed);
+    conn->channel->send(std::move(head), std::move(body));
+    if (!keep_alive) {
+        conn->closing = true;
+        conn->channel->close_after_send();
+    }
+}
+
+bool c_http_server::is_authorized(const s_http_request& request) const {
+    if (m_auth_token.empty()) {
+        return true; // auth disabled
+    }
+
+    // Accept either "Authorization: Bearer <token>" or "X-Auth-Token: <token>".
+    constexpr std::string_view prefix = "Bearer ";
+    auto authorization = request.get_header("authorization");
+    if (authorization.size() > prefix.size() &&
+        authorization.starts_with(prefix) &&
+        authorization.substr(prefix.size()) == m_auth_token) {
+        return true;
+    }
+
+    auto token = request.get_header("x-auth-token");
+    return !token.empty() && token == m_auth_token;
+}
+
+bool c_http_server::wants_keep_alive(const s_http_request& request) {
+    // Connection tokens are case-insensitive
+    auto contains_token = [](std::string_view value, std::string_view token) {
+        if (value.size() < token.size()) return false;
+        for (size_t i = 0; i + token.size() <= value.size(); ++i) {
+            bool match = true;
+            for (size_t j = 0; j < token.size() && match; ++j) {
+                match = std::tolower(static_cast<unsigned char>(value[i + j])) == token[j];
             }
-        } else if (encoded[i] == '+') {
-            result += ' ';
-        } else {
-            result += encoded[i];
+            if (match) return true;
         }
+        return false;
+    };
+
+    auto connection = request.get_header("connection");
+    if (contains_token(connection, "close")) {
+        return false;
+    }
+    if (contains_token(connection, "keep-alive")) {
+        return true;
     }
 
-    return result;
+    // HTTP/1.1 connections are persistent unless the client says otherwise.
+    return request.version != "HTTP/1.0";
+}
+
+c_http_server::e_framing c_http_server::find_request(const std::string& buffer, size_t& request_len) {
+    auto header_end_pos = buffer.find("\r\n\r\n");
+    if (header_end_pos == std::string::npos) {
+        return buffer.size() > MAX_REQUEST_SIZE ? e_framing::too_large : e_framing::incomplete;
+    }
+    std::string_view head(buffer.data(), header_end_pos);
+
+    // Upload routes take chunked bodies before we get here; ordinary routes
+    // only know Content-Length
+    if (find_header(head, "transfer-encoding")) {
+        return e_framing::unsupported;
+    }
+
+    // Two lengths, even equal ones, are a request smuggling staple: which
+    // one a proxy in front of us believed is anyone's guess
+    if (count_header(head, "content-length") > 1) {
+        return e_framing::bad_length;
+    }
+
+    size_t content_length = 0;
+    if (auto declared = find_header(head, "content-length")) {
+        unsigned long long value = 0;
+        auto res = std::from_chars(declared->data(), declared->data() + declared->size(), value);
+        if (declared->empty() || res.ec != std::errc{} || res.ptr != declared->data() + declared->size()) {
+            return e_framing::bad_length;
+        }
+        if (value > MAX_REQUEST_SIZE) {
+            return e_framing::too_large;
+        }
+        content_length = static_cast<size_t>(value);
+    }
+
+    auto body_start = header_end_pos + 4;
+    if (buffer.size() - body_start < content_length) {
+        return e_framing::incomplete;
+    }
+
+    request_len = body_start + content_length;
+    return e_framing::complete;
+}
+
+std::optional<std::string_view> c_http_server::find_header(std::string_view head, std::string_view name) {
+    std::optional<std::string_view> found;
+    for_each_header(head, name, [&](std::string_view value) {
+        if (!found) found = value;
+    });
+    return found;
+}
+
+size_t c_http_server::count_header(std::string_view head, std::string_view name) {
+    size_t count = 0;
+    for_each_header(head, name, [&](std::string_view) { ++count; });
+    return count;
+}
+
+template <typename F>
+void c_http_server::for_each_header(std::string_view head, std::string_view name, F&& visit) {
+    // Header lines follow the request line
+    auto line_start = head.find("\r\n");
+    while (line_start != std::string_view::npos) {
+        line_start += 2;
+        auto line_end = head.find("\r\n", line_start);
+        auto line = head.substr(line_start, line_end == std::string_view::npos ? line_end : line_end - line_start);
+
+        if (line.size() > name.size() && line[name.size()] == ':' &&
+            std::equal(name.begin(), name.end(), line.begin(), [](char expected, char c) {
+                return std::tolower(static_cast<unsigned char>(c)) == expected;
+            })) {
+            auto value = line.substr(name.size() + 1);
+            auto first = value.find_first_not_of(" \t");
+            visit(first == std::string_view::npos
+                ? std::string_view{}
+                : value.substr(first, value.find_last_not_of(" \t") - first + 1));
+        }
+        line_start = line_end;
+    }
+}
+
+std::expected<s_http_request, std::string> c_http_server::parse_request(std::string raw_data) {
+    if (raw_data.empty()) {
+        return std::unexpected("Empty request");
+    }
+
+    s_http_request req;
+    req.raw = std::make_shared<const std::string>(std::move(raw_data));
+    const std::string_view data = *req.raw;
+
+    // Single pass over the request: every field is a view into req.raw.
+    auto line_end = data.find("\r\n");
+    if (line_end == std::string_view::npos) {
+        return std::unexpected("Malformed request line");
+    }
+
+    // Parse: METHOD PATH HTTP/1.x
+    auto request_line = data.substr(0, line_end);
+    auto first_space = request_line.find(' ');
+    if (first_space == std::string_view::npos) {
+        return std::unexpected("Malformed request line: no method");
+    }
+    req.method = request_line.substr(0, first_space);
+
+    auto second_space = request_line.find(' ', first_space + 1);
+    if (second_space == std::string_view::npos) {
+        return std::unexpected("Malformed request line: no path");
+    }
+    auto full_path = request_line.substr(first_space + 1, second_space - first_space - 1);
+    req.version = request_line.substr(second_space + 1);
+
+    // Split path and query string (decoded lazily by get_query)
+    auto query_pos = full_path.find('?');
+    req.path = full_path.substr(0, query_pos);
+    if (query_pos != std::string_view::npos) {
+        req.query_string = full_path.substr(query_pos + 1);
+    }
+
+    // Header lines up to the blank line
+    size_t pos = line_end + 2;
+    while (true) {
+        auto eol = data.find("\r\n", pos);
+        if (eol == std::string_view::npos) {
+            return std::unexpected("Malformed headers");
+        }
+        if (eol == pos) {
+            pos += 2; // blank line: body follows
+            break;
+        }
+
+        auto line = data.substr(pos, eol - pos);
+        pos = eol + 2;
+
+        auto colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+
+        auto value = line.substr(colon + 1);
+        auto val_start = value.find_first_not_of(" \t");
+        value = (val_start == std::string_view::npos) ? std::string_view{} : value.substr(val_start);
+        auto val_end = value.find_last_not_of(" \t");
+        value = value.substr(0, val_end == std::string_view::npos ? 0 : val_end + 1);
+
+        req.headers.emplace_back(line.substr(0, colon), value);
+    }
+
+    req.body = data.substr(pos);
+    return req;
 }
@@ -1,15 +1,30 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <thread>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <cstdint>
 
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
+#include "http/net_platform.h"
+#include "http/c_content_encoder.h"
 #include "http/c_http_router.h"
+#include "http/c_io_reactor.h"
+#include "http/c_response_cache.h"
+#include "util/c_timer_wheel.h"
+#include "util/c_worker_pool.h"
+
+class c_prometheus_writer;
 
 class c_http_server {
 public:
@@ -22,7 +37,7 @@ public:
     c_http_server(c_http_server&&) = delete;
     c_http_server& operator=(c_http_server&&) = delete;
 
-    // Start the HTTP server on the given host:port
+    // Start the HTTP server on the given host:port (and the Unix socket, if set)
     [[nodiscard]] std::expected<void, std::string> start(
         const std::string& host, uint16_t port, c_http_router* router
     );
@@ -40,45 +55,316 @@ public:
     // Must be set before start().
     void set_auth_token(std::string token) { m_auth_token = std::move(token); }
 
+    // Also listen on an AF_UNIX socket at this filesystem path, served by the
+    // same router and workers as TCP. Empty = TCP only. Must be set before start().
+    void set_unix_socket_path(std::string path) { m_unix_socket_path = std::move(path); }
+    [[nodiscard]] const std::string& get_unix_socket_path() const { return m_unix_socket_path; }
+
+    // Response compression totals since the server was created
+    struct s_compression_stats {
+        uint64_t responses = 0;      // responses sent with a Content-Encoding
+        uint64_t bytes_in = 0;       // their body bytes before compression
+        uint64_t bytes_out = 0;      // ... and after
+        uint64_t time_us = 0;        // time spent compressing them
+    };
+    [[nodiscard]] s_compression_stats compression_stats() const;
+
+    // Responses of the router's cacheable routes. The embedder enables it
+    // (while the debuggee is paused) and invalidates it when the debuggee
+    // changes; requests other than GET invalidate it on their own.
+    [[nodiscard]] c_response_cache& response_cache() { return m_cache; }
+
+    // Workers, backlog and queue wait of one execution lane (see e_lane)
+    struct s_lane_stats {
+        const char* name = "";
+        size_t workers = 0;
+        size_t busy = 0;          // workers running a request
+        size_t queued = 0;        // requests waiting for one
+        uint64_t rejected = 0;    // 503s because the lane's queue was full
+        c_latency_histogram::s_snapshot queue_wait; // parse to worker start
+    };
+    [[nodiscard]] std::array<s_lane_stats, static_cast<size_t>(e_lane::count)> lane_stats() const;
+
+    // Stop the in-flight requests sent with this X-Request-Id (see
+    // c_cancel_token). Returns how many were signalled.
+    size_t cancel_request(std::string_view request_id);
+
+    // Server, per-route and compression metrics in Prometheus text format
+    void write_metrics(c_prometheus_writer& out) const;
+
+    // Parse one complete request. Takes ownership of the bytes; the returned
+    // request's fields are views into them.
+    [[nodiscard]] static std::expected<s_http_request, std::string> parse_request(std::string raw_data);
+
 private:
     static constexpr size_t MAX_REQUEST_SIZE = 1024 * 1024; // 1MB max request body
-    static constexpr int RECV_TIMEOUT_MS = 5000;
-    static constexpr int DRAIN_TIMEOUT_MS = 5000; // max wait for live connections on stop
+    static constexpr uint64_t MAX_UPLOAD_SIZE = 256ull * 1024 * 1024; // streamed body to an upload route
+    static constexpr int HEADER_TIMEOUT_MS = 5000;           // a started request's head must arrive within this
+    static constexpr int BODY_TIMEOUT_MS = 5000;             // longest gap allowed while a body is arriving
+    static constexpr int KEEP_ALIVE_TIMEOUT_MS = 5000;       // idle time allowed between requests
+    static constexpr int MAX_REQUESTS_PER_CONNECTION = 1000; // then the connection is closed
+    static constexpr int TIMER_TICK_MS = 100;                // deadline granularity
+    static constexpr int STREAM_WAIT_SLICE_MS = 250;         // a paced producer re-checks for shutdown this often
+    static constexpr size_t IO_THREADS = 2;                  // reactor threads driving all sockets
+    static constexpr size_t STREAM_HIGH_WATERMARK = 256 * 1024; // queued bytes before a producer waits
+    static constexpr int STREAM_STALL_TIMEOUT_MS = 10000;    // give up on a reader that stops reading
+    static constexpr size_t COMPRESSION_THRESHOLD = 4 * 1024; // smaller bodies are sent as-is
+    static constexpr int WS_PING_INTERVAL_MS = 20000;        // ping a WebSocket client this long idle
+    static constexpr int WS_IDLE_TIMEOUT_MS = 60000;         // then drop it if it stays silent
+
+    // Workers and queue capacity per lane, indexed by e_lane. Control stays
+    // small and idle enough to start a request at once; bulk is capped so
+    // scans cannot occupy every worker.
+    struct s_lane_config {
+        const char* name;
+        size_t workers;
+        size_t queue_capacity;
+    };
+    static constexpr std::array<s_lane_config, static_cast<size_t>(e_lane::count)> LANE_CONFIG = {{
+        {"control",     2,  64},
+        {"interactive", 12, 256},
+        {"bulk",        4,  32},
+    }};
+
+    // What a connection is waiting for; each has its own timeout
+    enum class e_deadline : uint8_t {
+        header,    // rest of a request's head
+        body,      // more of a request body (buffered or streamed to an upload)
+        idle,      // next request on a kept-alive connection
+        websocket, // next ping, or dropping a client that stopped answering
+        count
+    };
+
+    struct s_connection;
+
+    // A connection's entry in m_timers. At most one per connection, for the
+    // nearest thing it waits on; re-evaluated when it fires.
+    struct s_deadline : c_timer_wheel::s_timer {
+        std::weak_ptr<s_connection> conn;
+        e_deadline kind = e_deadline::idle;
+    };
+
+    // Per-connection HTTP state. Socket I/O is owned by the reactor channel.
+    struct s_connection {
+        explicit s_connection(c_http_server& owner) : server(owner) {}
+        ~s_connection(); // disarms the deadline if something left it armed
 
-    std::atomic<SOCKET> m_listen_socket{INVALID_SOCKET};
+        c_http_server& server;
+        std::mutex mutex;
+        std::shared_ptr<c_io_channel> channel;
+        std::string buffer;          // received bytes not yet consumed (may hold pipelined requests)
+        std::chrono::steady_clock::time_point last_activity = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point request_started = last_activity;
+        int served = 0;
+        bool busy = false;           // a request is with a worker; later ones wait their turn
+        bool peer_eof = false;       // client finished sending
+        bool closing = false;        // close requested, ignore further input
+
+        // Body of the upload in progress. Incoming bytes go to it first; what
+        // is left over (the next pipelined request) goes to buffer.
+        std::shared_ptr<c_request_body> upload;
+
+        // The reactor is done with the socket. Set by on_closed, which runs
+        // inside channel->close() and so cannot take the mutex.
+        std::atomic<bool> channel_closed{false};
+
+        // Set once upgraded to WebSocket; buffer then holds incoming frames
+        std::shared_ptr<c_websocket_session> websocket;
+        std::atomic<bool> websocket_ready{false}; // route handler done; on_closed reports the close
+        std::chrono::steady_clock::time_point last_ping;
+
+        s_deadline deadline; // guarded by m_timers_mutex
+    };
+    using connection_ptr = std::shared_ptr<s_connection>;
+
+    enum class e_framing {
+        complete,    // a full request is at the front of the buffer
+        incomplete,  // need more bytes
+        too_large,   // request exceeds MAX_REQUEST_SIZE
+        bad_length,  // Content-Length is not a number
+        unsupported  // Transfer-Encoding outside an upload route
+    };
+
+    std::atomic<socket_t> m_listen_socket{INVALID_SOCKET};
+    std::atomic<socket_t> m_unix_listen_socket{INVALID_SOCKET};
     std::atomic<bool> m_running{false};
-    std::atomic<int> m_active_connections{0};
     std::thread m_listener_thread;
+    std::thread m_unix_listener_thread;
+    std::thread m_timer_thread;
+    std::mutex m_timer_thread_mutex;
+    std::condition_variable m_timer_thread_cv;
+
+    // Deadlines of every connection. Lock order: conn->mutex, then this.
+    std::mutex m_timers_mutex;
+    c_timer_wheel m_timers{std::chrono::milliseconds(TIMER_TICK_MS), std::chrono::steady_clock::now()};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(e_deadline::count)> m_deadlines_pending{};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(e_deadline::count)> m_deadlines_expired{};
+
+    std::unique_ptr<c_io_reactor> m_reactor;
+    struct s_lane {
+        c_worker_pool pool;
+        c_latency_histogram queue_wait;
+        std::atomic<uint64_t> rejected{0};
+    };
+    std::array<s_lane, static_cast<size_t>(e_lane::count)> m_lanes;
+    mutable std::mutex m_connections_mutex;
+    std::unordered_set<connection_ptr> m_connections;
     c_http_router* m_router = nullptr;
     uint16_t m_port = 0;
     std::string m_auth_token;
+    std::string m_unix_socket_path;
+    c_response_cache m_cache;
+
+    // In-flight requests that /api/cancel can reach, by X-Request-Id
+    std::mutex m_cancellable_mutex;
+    std::unordered_multimap<std::string, std::shared_ptr<c_cancel_token>> m_cancellable;
+
+    std::atomic<uint64_t> m_compressed_responses{0};
+    std::atomic<uint64_t> m_compressed_bytes_in{0};
+    std::atomic<uint64_t> m_compressed_bytes_out{0};
+    std::atomic<uint64_t> m_compression_time_us{0};
+
+    std::atomic<uint64_t> m_connections_accepted{0};
+    std::atomic<uint64_t> m_bytes_received{0};       // request bytes, as read from sockets
+    std::atomic<uint64_t> m_bytes_sent{0};           // HTTP response bytes queued (not WebSocket frames)
+    std::atomic<uint64_t> m_requests_in_flight{0};   // with a worker, including streaming bodies
+    std::atomic<uint64_t> m_rejected_busy{0};        // 503: no worker free
+    std::atomic<uint64_t> m_rejected_malformed{0};   // 400: request could not be parsed
+    std::atomic<uint64_t> m_rejected_too_large{0};   // request over MAX_REQUEST_SIZE
+    std::atomic<uint64_t> m_rejected_timeout{0};     // request head or body deadline expired
+    std::atomic<uint64_t> m_rejected_overflow{0};    // pipelined too far ahead of the handler
+
+    // Queue a request's task in its lane, timing how long it waits for a
+    // worker. False if the lane's queue is full (counted as rejected).
+    [[nodiscard]] bool submit_to_lane(e_lane lane, c_worker_pool::task_t task);
+
+    // Give the request a cancel token if it asks for one: a deadline from
+    // X-Deadline-Ms (milliseconds from now; invalid values are ignored), or
+    // just the means to cancel it when it has an X-Request-Id. From then
+    // on cancel_request() reaches it, queued or running, until untracked.
+    void attach_cancel_token(s_http_request& request);
+
+    // Add or remove a request's token under its X-Request-Id
+    void track_cancellable(std::string_view id, const std::shared_ptr<c_cancel_token>& token);
+    void untrack_cancellable(std::string_view id, const std::shared_ptr<c_cancel_token>& token);
 
     // True if the request carries a valid token (or no token is required).
     [[nodiscard]] bool is_authorized(const s_http_request& request) const;
 
-    // Main listener loop (runs on m_listener_thread)
-    void listener_loop();
+    // Listening sockets for start()
+    [[nodiscard]] static std::expected<socket_t, std::string> open_tcp_listener(const std::string& host, uint16_t port);
+    [[nodiscard]] static std::expected<socket_t, std::string> open_unix_listener(const std::string& path);
 
-    // Handle a single client connection
-    void handle_connection(SOCKET client_socket);
+    // Blocking accept loop, one per listening socket (runs on
+    // m_listener_thread / m_unix_listener_thread; stop() closes the socket)
+    void listener_loop(std::atomic<socket_t>& listen_socket, bool tcp);
 
-    // Parse a Content-Length header without throwing. Sets too_large if the
-    // declared length exceeds MAX_REQUEST_SIZE. Returns 0 when absent/malformed.
-    [[nodiscard]] static size_t parse_content_length(
-        const std::string& raw_data, size_t header_end_pos, bool& too_large
-    );
+    // Run the timer wheel, acting on expired deadlines (runs on m_timer_thread)
+    void timer_loop();
 
-    // Parse raw HTTP request data into s_http_request
-    [[nodiscard]] static std::expected<s_http_request, std::string> parse_request(
-        const std::string& raw_data
-    );
+    // The nearest deadline the connection waits on, if any; none once the
+    // channel is closed. Caller holds conn->mutex.
+    [[nodiscard]] static std::optional<std::pair<e_deadline, std::chrono::steady_clock::time_point>>
+    next_deadline_locked(const connection_ptr& conn);
 
-    // Parse query string into key-value pairs
-    static void parse_query_string(
-        const std::string& query_string,
-        std::unordered_map<std::string, std::string>& out
-    );
+    // Arm, move or cancel the connection's timer after its state changed.
+    // A later deadline of the same kind is left for expire_deadline to find.
+    // Caller holds conn->mutex.
+    void update_deadline_locked(const connection_ptr& conn);
+
+    // A connection's timer fired: close it, ping it or re-arm (timer thread)
+    void expire_deadline(const connection_ptr& conn);
+
+    // Take the connection's timer out of the wheel, if armed.
+    // Caller holds m_timers_mutex.
+    void disarm_deadline_locked(s_connection& conn);
+
+    // Register an accepted socket with the reactor
+    void accept_connection(socket_t client_socket, bool tcp);
+
+    // Reactor callbacks (I/O threads)
+    void on_data(const connection_ptr& conn, std::string_view data);
+    void on_eof(const connection_ptr& conn);
+    void on_closed(const connection_ptr& conn);
+
+    // Frame the next request in the buffer and hand it to a worker.
+    // Caller holds conn->mutex. No-op while a request is in flight.
+    void start_next_request_locked(const connection_ptr& conn);
+
+    // If the buffer starts with a POST to an upload route carrying an
+    // octet-stream or chunked body, start streaming it to the handler and
+    // return true. Caller holds conn->mutex.
+    [[nodiscard]] bool try_start_upload_locked(const connection_ptr& conn);
+
+    // Run the router for one request (worker thread), then send the response
+    void handle_request(const connection_ptr& conn, const s_http_request& request, bool keep_alive);
+
+    // Run an upload handler while its body arrives (worker thread), then send the response
+    void handle_upload(const connection_ptr& conn, const s_http_request& request,
+                       const std::shared_ptr<c_request_body>& body, const upload_handler_t& handler,
+                       bool keep_alive);
+
+    // Answer a GET to a cacheable route: 304 if the client's ETag is still
+    // current, the stored response if there is one, else the route's (with
+    // `ticket` set so finish_request stores it)
+    [[nodiscard]] s_http_response dispatch_cached(const s_http_request& request,
+                                                  std::optional<c_response_cache::s_ticket>& ticket);
+
+    // Serialize, encode and send a handler's response, then move on to the
+    // next pipelined request (worker thread). With a cache ticket, the
+    // finished response is also stored in the response cache.
+    void finish_request(const connection_ptr& conn, const s_http_request& request,
+                        s_http_response response, bool keep_alive,
+                        const c_response_cache::s_ticket* cache_ticket = nullptr);
+
+    // Tag a fresh response with its ETag and store it once its body is
+    // complete (for a stream: once the last piece has been sent)
+    void cache_response(s_http_response& response, const c_response_cache::s_ticket& ticket);
+
+    // Complete a WebSocket handshake and hand the session to the route's
+    // handler (worker thread). The connection carries frames from then on.
+    void upgrade_websocket(const connection_ptr& conn, const s_http_request& request,
+                           const websocket_handler_t& handler);
+
+    // Pass buffered frames to the connection's WebSocket session.
+    // Caller holds conn->mutex.
+    static void feed_websocket_locked(const connection_ptr& conn);
+
+    // Compress the response body if the client accepts an encoding and the
+    // body is large enough to be worth it (worker thread)
+    void encode_response(s_http_response& response, const s_http_request& request);
+
+    void record_compression(size_t bytes_in, size_t bytes_out, std::chrono::steady_clock::duration elapsed);
+
+    // Send a response whose body comes from a producer (body_stream)
+    void stream_response(const connection_ptr& conn, const s_http_response& response, bool keep_alive);
+
+    // Run the producer, pacing it to the socket. True if the whole body was sent.
+    [[nodiscard]] bool produce_body(c_io_channel& channel, const s_http_response& response);
+
+    // Run a streamed response's producer into an ordinary body
+    [[nodiscard]] static s_http_response collect_body(s_http_response response);
+
+    // Queue a response; closes the connection after it unless keep_alive.
+    // Caller holds conn->mutex.
+    void respond_locked(const connection_ptr& conn, s_http_response response, bool keep_alive);
+
+    // Whether the client asked for (or defaults to) a persistent connection
+    [[nodiscard]] static bool wants_keep_alive(const s_http_request& request);
+
+    // Locate the end of the first request in the buffer. Anything that would
+    // leave the body's length in doubt is an error: a wrong guess would run
+    // the body as the next pipelined request.
+    [[nodiscard]] static e_framing find_request(const std::string& buffer, size_t& request_len);
+
+    // Value of the header `name` (lowercase) in an unparsed request head,
+    // matched case-insensitively at the start of a line and trimmed
+    [[nodiscard]] static std::optional<std::string_view> find_header(std::string_view head, std::string_view name);
+
+    // Number of lines in an unparsed request head carrying the header `name`
+    [[nodiscard]] static size_t count_header(std::string_view head, std::string_view name);
 
-    // URL-decode a string
-    [[nodiscard]] static std::string url_decode(const std::string& encoded);
+    // Calls visit(value) for each line carrying the header `name`, trimmed
+    template <typename F>
+    static void for_each_header(std::string_view head, std::string_view name, F&& visit);
 };
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "http/net_platform.h"
+
+// Callbacks for one attached socket. All of them run on a reactor I/O thread
+// and are serialized per channel (never two at once for the same socket).
+struct s_io_callbacks {
+    std::function<void(std::string_view data)> on_data; // bytes received
+    std::function<void()> on_eof;                       // peer finished sending
+    std::function<void()> on_closed;                    // channel gone, last call
+};
+
+// Bytes queued on a channel: a string the channel owns, or one shared with
+// whatever else holds it (a cached response body), kept alive until written
+class c_io_buffer {
+public:
+    c_io_buffer(std::string data) : m_owned(std::move(data)) {}
+    c_io_buffer(std::shared_ptr<const std::string> data) : m_shared(std::move(data)) {}
+
+    [[nodiscard]] const char* data() const { return (m_shared ? m_shared->data() : m_owned.data()) + m_consumed; }
+    [[nodiscard]] size_t size() const { return (m_shared ? m_shared->size() : m_owned.size()) - m_consumed; }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    // Skip the first `count` bytes (already written)
+    void consume(size_t count) { m_consumed += count; }
+
+private:
+    std::string m_owned;
+    std::shared_ptr<const std::string> m_shared;
+    size_t m_consumed = 0;
+};
+
+// A connected socket owned by the reactor. Writes are queued and flushed with
+// gathered writes (writev / WSASend) as the socket accepts them.
+class c_io_channel {
+public:
+    virtual ~c_io_channel() = default;
+
+    // Queue data for sending. Thread-safe. Returns false once the channel is closed.
+    bool send(std::string data) { return send(std::move(data), std::string()); }
+
+    // Queue two buffers (e.g. a response head and its body) so they leave in
+    // one gathered write without being concatenated. Thread-safe.
+    virtual bool send(std::string head, c_io_buffer body) = 0;
+
+    // Block until at most max_pending bytes are queued. Returns false if the
+    // channel closed or the timeout expired first. Thread-safe.
+    virtual bool wait_writable(size_t max_pending, std::chrono::milliseconds timeout) = 0;
+
+    // Stop or resume reading from the socket. While paused the kernel's
+    // receive buffer fills and TCP holds the sender back. A read already in
+    // progress may still deliver one more on_data. Thread-safe.
+    virtual void set_reading(bool enabled) = 0;
+
+    // Close once everything queued so far has been written. Thread-safe.
+    virtual void close_after_send() = 0;
+
+    // Close immediately, dropping unsent data. Thread-safe.
+    virtual void close() = 0;
+
+    // Bytes queued but not yet accepted by the socket
+    [[nodiscard]] virtual size_t pending_bytes() const = 0;
+};
+
+// Non-blocking socket multiplexer: a few I/O threads drive every connection.
+// Backends: IOCP on Windows, epoll on Linux (see c_io_reactor_*.cpp).
+class c_io_reactor {
+public:
+    virtual ~c_io_reactor() = default;
+
+    // Create the backend for the current platform
+    [[nodiscard]] static std::unique_ptr<c_io_reactor> create();
+
+    // Spawn the I/O threads
+    [[nodiscard]] virtual std::expected<void, std::string> start(size_t io_threads) = 0;
+
+    // Close every channel (on_closed fires for each) and join the I/O threads
+    virtual void stop() = 0;
+
+    // Take ownership of a connected socket and start reading from it.
+    // Returns nullptr (and closes the socket) if it cannot be registered.
+    [[nodiscard]] virtual std::shared_ptr<c_io_channel> attach(socket_t sock, s_io_callbacks callbacks) = 0;
+};
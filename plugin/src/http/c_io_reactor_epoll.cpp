@@ -0,0 +1,461 @@
+#include "http/c_io_reactor.h"
+
+#ifdef __linux__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// epoll backend. Every socket is registered EPOLLONESHOT, so exactly one I/O
+// thread handles a given connection at a time; the handling thread re-arms it
+// with the current interest (read, plus write while output is queued) when done.
+
+namespace {
+
+constexpr size_t READ_CHUNK = 16 * 1024;
+constexpr int READS_PER_EVENT = 16;  // then yield to other connections
+constexpr size_t MAX_IOV = 64;
+constexpr uint64_t WAKE_ID = 0;      // epoll data id of the stop eventfd
+
+class c_epoll_reactor;
+
+class c_epoll_channel final : public c_io_channel {
+public:
+    c_epoll_channel(c_epoll_reactor& reactor, socket_t sock, uint64_t id, s_io_callbacks callbacks)
+        : m_reactor(reactor), m_socket(sock), m_id(id), m_callbacks(std::move(callbacks)) {}
+
+    using c_io_channel::send;
+    bool send(std::string head, c_io_buffer body) override;
+    bool wait_writable(size_t max_pending, std::chrono::milliseconds timeout) override;
+    void set_reading(bool enabled) override;
+    void close_after_send() override;
+    void close() override;
+    [[nodiscard]] size_t pending_bytes() const override;
+
+    // Handle one epoll notification (runs on an I/O thread)
+    void handle_events(uint32_t events);
+
+private:
+    c_epoll_reactor& m_reactor;
+    const socket_t m_socket;
+    const uint64_t m_id;
+    s_io_callbacks m_callbacks;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_drained;  // signalled as queued output shrinks or on close
+    std::deque<c_io_buffer> m_out;
+    size_t m_out_offset = 0;   // bytes of m_out.front() already sent
+    size_t m_out_bytes = 0;
+    bool m_in_dispatch = false;
+    bool m_read_eof = false;
+    bool m_close_after_send = false;
+    bool m_finished = false;
+    std::atomic<bool> m_read_paused{false}; // checked by the read loop between on_data calls
+    std::atomic<bool> m_closed{false};
+
+    // Write as much as the socket accepts. Caller holds m_mutex.
+    // Returns false on a hard socket error.
+    bool flush_locked();
+
+    // Re-arm the one-shot registration with the current interest. Caller holds m_mutex.
+    void rearm_locked();
+
+    // Deregister, close the socket and fire on_closed. Caller must not hold
+    // m_mutex and must guarantee no dispatch is running for this channel.
+    void finish();
+};
+
+class c_epoll_reactor final : public c_io_reactor {
+public:
+    ~c_epoll_reactor() override { stop(); }
+
+    std::expected<void, std::string> start(size_t io_threads) override;
+    void stop() override;
+    std::shared_ptr<c_io_channel> attach(socket_t sock, s_io_callbacks callbacks) override;
+
+    [[nodiscard]] int epoll_fd() const { return m_epoll; }
+
+    void forget(uint64_t id) {
+        std::lock_guard lock(m_channels_mutex);
+        m_channels.erase(id);
+    }
+
+private:
+    int m_epoll = -1;
+    int m_wake = -1;
+    std::vector<std::thread> m_threads;
+    std::mutex m_channels_mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<c_epoll_channel>> m_channels;
+    uint64_t m_next_id = WAKE_ID;
+
+    void io_loop();
+
+    [[nodiscard]] std::shared_ptr<c_epoll_channel> find(uint64_t id) {
+        std::lock_guard lock(m_channels_mutex);
+        auto it = m_channels.find(id);
+        return (it != m_channels.end()) ? it->second : nullptr;
+    }
+};
+
+// ============================================================================
+// Channel
+// ============================================================================
+
+bool c_epoll_channel::send(std::string head, c_io_buffer body) {
+    std::unique_lock lock(m_mutex);
+    if (m_closed.load()) {
+        return false;
+    }
+    if (head.empty() && body.empty()) {
+        return true;
+    }
+
+    if (!head.empty()) {
+        m_out_bytes += head.size();
+        m_out.emplace_back(std::move(head));
+    }
+    if (!body.empty()) {
+        m_out_bytes += body.size();
+        m_out.push_back(std::move(body));
+    }
+
+    // The dispatching thread flushes and re-arms when it is done.
+    if (m_in_dispatch) {
+        return true;
+    }
+
+    // Try to write right away from the caller's thread; only fall back to
+    // EPOLLOUT if the socket buffer is full.
+    bool ok = flush_locked();
+    if (!ok || (m_close_after_send && m_out.empty())) {
+        m_closed.store(true);
+        lock.unlock();
+        finish();
+        return ok;
+    }
+
+    rearm_locked();
+    return true;
+}
+
+bool c_epoll_channel::wait_writable(size_t max_pending, std::chrono::milliseconds timeout) {
+    std::unique_lock lock(m_mutex);
+    m_drained.wait_for(lock, timeout, [&] { return m_closed.load() || m_out_bytes <= max_pending; });
+    return !m_closed.load() && m_out_bytes <= max_pending;
+}
+
+void c_epoll_channel::set_reading(bool enabled) {
+    std::lock_guard lock(m_mutex);
+    if (m_read_paused.exchange(!enabled) == !enabled) {
+        return;
+    }
+    // Pausing takes effect when the registration is next re-armed. A running
+    // dispatch re-arms when it is done; otherwise resume re-arms here.
+    if (enabled && !m_in_dispatch && !m_closed.load()) {
+        rearm_locked();
+    }
+}
+
+void c_epoll_channel::close_after_send() {
+    std::unique_lock lock(m_mutex);
+    if (m_closed.load()) {
+        return;
+    }
+    m_close_after_send = true;
+    if (m_in_dispatch || !m_out.empty()) {
+        return; // finished by the dispatcher / once the queue drains
+    }
+    m_closed.store(true);
+    lock.unlock();
+    finish();
+}
+
+void c_epoll_channel::close() {
+    std::unique_lock lock(m_mutex);
+    if (m_closed.exchange(true) || m_in_dispatch) {
+        return;
+    }
+    lock.unlock();
+    finish();
+}
+
+size_t c_epoll_channel::pending_bytes() const {
+    std::lock_guard lock(m_mutex);
+    return m_out_bytes;
+}
+
+void c_epoll_channel::handle_events(uint32_t events) {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_closed.load() || m_in_dispatch) {
+            return; // the running dispatch re-arms and picks this up
+        }
+        m_in_dispatch = true;
+    }
+
+    bool hard_error = false;
+
+    if (!m_read_eof && !m_read_paused.load() && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+        char buffer[READ_CHUNK];
+        for (int i = 0; i < READS_PER_EVENT && !m_closed.load() && !m_read_paused.load(); ++i) {
+            auto bytes_read = recv(m_socket, buffer, sizeof(buffer), 0);
+            if (bytes_read > 0) {
+                if (m_callbacks.on_data) {
+                    m_callbacks.on_data(std::string_view(buffer, static_cast<size_t>(bytes_read)));
+                }
+                continue;
+            }
+            if (bytes_read == 0) {
+                m_read_eof = true;
+                if (m_callbacks.on_eof) {
+                    m_callbacks.on_eof();
+                }
+            } else if (!net::would_block(net::last_error())) {
+                hard_error = true;
+            }
+            break;
+        }
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_in_dispatch = false;
+
+    if (!m_closed.load() && !hard_error) {
+        hard_error = !flush_locked();
+    }
+    if (hard_error || (m_close_after_send && m_out.empty())) {
+        m_closed.store(true);
+    }
+
+    if (m_closed.load()) {
+        lock.unlock();
+        finish();
+        return;
+    }
+
+    rearm_locked();
+}
+
+bool c_epoll_channel::flush_locked() {
+    while (!m_out.empty()) {
+        iovec iov[MAX_IOV];
+        size_t count = 0;
+        size_t offset = m_out_offset;
+        for (auto it = m_out.begin(); it != m_out.end() && count < MAX_IOV; ++it) {
+            iov[count].iov_base = const_cast<char*>(it->data() + offset);
+            iov[count].iov_len = it->size() - offset;
+            offset = 0;
+            ++count;
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        auto written = sendmsg(m_socket, &msg, MSG_NOSIGNAL);
+        if (written < 0) {
+            return net::would_block(net::last_error());
+        }
+
+        auto remaining = static_cast<size_t>(written);
+        m_out_bytes -= remaining;
+        m_drained.notify_all();
+        while (remaining > 0) {
+            size_t front_left = m_out.front().size() - m_out_offset;
+            if (remaining >= front_left) {
+                remaining -= front_left;
+                m_out.pop_front();
+                m_out_offset = 0;
+            } else {
+                m_out_offset += remaining;
+                remaining = 0;
+            }
+        }
+
+        if (m_out_offset > 0) {
+            return true; // socket buffer full
+        }
+    }
+    return true;
+}
+
+void c_epoll_channel::rearm_locked() {
+    uint32_t interest = 0;
+    if (!m_read_eof && !m_read_paused.load()) {
+        interest |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (!m_out.empty()) {
+        interest |= EPOLLOUT;
+    }
+    if (interest == 0) {
+        // Nothing to wait for until more output is queued. Staying disarmed
+        // also avoids spinning on EPOLLHUP, which is reported unconditionally.
+        return;
+    }
+
+    epoll_event ev{};
+    ev.events = interest | EPOLLONESHOT;
+    ev.data.u64 = m_id;
+    epoll_ctl(m_reactor.epoll_fd(), EPOLL_CTL_MOD, m_socket, &ev);
+}
+
+void c_epoll_channel::finish() {
+    bool graceful = false;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+        graceful = m_close_after_send && m_out.empty();
+        m_out.clear();
+        m_out_bytes = 0;
+    }
+    m_drained.notify_all();
+
+    epoll_ctl(m_reactor.epoll_fd(), EPOLL_CTL_DEL, m_socket, nullptr);
+    if (graceful) {
+        net::shutdown_send(m_socket);
+    }
+    net::close_socket(m_socket);
+
+    auto callbacks = std::move(m_callbacks);
+    m_callbacks = {};
+    m_reactor.forget(m_id);
+
+    if (callbacks.on_closed) {
+        callbacks.on_closed();
+    }
+}
+
+// ============================================================================
+// Reactor
+// ============================================================================
+
+std::expected<void, std::string> c_epoll_reactor::start(size_t io_threads) {
+    if (!m_threads.empty()) {
+        return std::unexpected("Reactor is already running");
+    }
+
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0) {
+        return std::unexpected("epoll_create1() failed with error: " + std::to_string(errno));
+    }
+
+    m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake < 0) {
+        auto err = errno;
+        ::close(m_epoll);
+        m_epoll = -1;
+        return std::unexpected("eventfd() failed with error: " + std::to_string(err));
+    }
+
+    // Level-triggered and never drained: once signalled, every thread wakes and exits.
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_ID;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &ev);
+
+    for (size_t i = 0; i < io_threads; ++i) {
+        m_threads.emplace_back(&c_epoll_reactor::io_loop, this);
+    }
+
+    return {};
+}
+
+void c_epoll_reactor::stop() {
+    if (m_threads.empty()) {
+        return;
+    }
+
+    uint64_t one = 1;
+    [[maybe_unused]] auto written = write(m_wake, &one, sizeof(one));
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+
+    // No dispatch can run anymore: close what is left from this thread.
+    std::vector<std::shared_ptr<c_epoll_channel>> remaining;
+    {
+        std::lock_guard lock(m_channels_mutex);
+        for (auto& [id, channel] : m_channels) {
+            remaining.push_back(channel);
+        }
+    }
+    for (auto& channel : remaining) {
+        channel->close();
+    }
+
+    ::close(m_wake);
+    ::close(m_epoll);
+    m_wake = -1;
+    m_epoll = -1;
+}
+
+std::shared_ptr<c_io_channel> c_epoll_reactor::attach(socket_t sock, s_io_callbacks callbacks) {
+    if (m_epoll < 0 || !net::set_non_blocking(sock)) {
+        net::close_socket(sock);
+        return nullptr;
+    }
+
+    std::shared_ptr<c_epoll_channel> channel;
+    uint64_t id = 0;
+    {
+        std::lock_guard lock(m_channels_mutex);
+        id = ++m_next_id;
+        channel = std::make_shared<c_epoll_channel>(*this, sock, id, std::move(callbacks));
+        m_channels.emplace(id, channel);
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.u64 = id;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, sock, &ev) != 0) {
+        forget(id);
+        net::close_socket(sock);
+        return nullptr;
+    }
+
+    return channel;
+}
+
+void c_epoll_reactor::io_loop() {
+    epoll_event events[64];
+
+    while (true) {
+        auto count = epoll_wait(m_epoll, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == WAKE_ID) {
+                return;
+            }
+            if (auto channel = find(events[i].data.u64)) {
+                channel->handle_events(events[i].events);
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::unique_ptr<c_io_reactor> c_io_reactor::create() {
+    return std::make_unique<c_epoll_reactor>();
+}
+
+#endif // __linux__
@@ -0,0 +1,485 @@
+#include "http/c_io_reactor.h"
+
+#ifdef _WIN32
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// IOCP backend. Each channel keeps at most one overlapped WSARecv and one
+// overlapped WSASend in flight; completions are handled by whichever I/O
+// thread dequeues them. A pending operation holds a reference to its channel,
+// so a channel is only released after the kernel is done with its buffers;
+// one still pending when the reactor stops is never released.
+
+namespace {
+
+constexpr size_t READ_CHUNK = 16 * 1024;
+constexpr size_t MAX_WSABUF = 64;
+constexpr ULONG_PTR EXIT_KEY = 1;
+constexpr int STOP_DRAIN_MS = 2000;
+
+class c_iocp_channel;
+
+struct s_overlapped_op {
+    OVERLAPPED overlapped{};
+    c_iocp_channel* owner = nullptr;
+    bool is_send = false;
+};
+
+class c_iocp_reactor;
+
+class c_iocp_channel final : public c_io_channel, public std::enable_shared_from_this<c_iocp_channel> {
+public:
+    c_iocp_channel(c_iocp_reactor& reactor, socket_t sock, s_io_callbacks callbacks)
+        : m_reactor(reactor), m_socket(sock), m_callbacks(std::move(callbacks)) {
+        m_recv_op.owner = this;
+        m_send_op.owner = this;
+        m_send_op.is_send = true;
+    }
+
+    using c_io_channel::send;
+    bool send(std::string head, c_io_buffer body) override;
+    bool wait_writable(size_t max_pending, std::chrono::milliseconds timeout) override;
+    void set_reading(bool enabled) override;
+    void close_after_send() override;
+    void close() override;
+    [[nodiscard]] size_t pending_bytes() const override;
+
+    // Issue the first receive (called once after attach)
+    void begin();
+
+    // Completion of one of our overlapped operations (runs on an I/O thread)
+    void on_completion(s_overlapped_op* op, DWORD bytes, bool ok);
+
+    // The reactor is stopping with an operation still in flight. The channel
+    // reports nothing more and no longer refers to the reactor; the caller
+    // keeps it allocated for the kernel to complete into.
+    void abandon();
+
+private:
+    c_iocp_reactor& m_reactor;
+    socket_t m_socket;
+    s_io_callbacks m_callbacks;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_drained;  // signalled as queued output shrinks or on close
+    s_overlapped_op m_recv_op;
+    s_overlapped_op m_send_op;
+    char m_recv_buffer[READ_CHUNK];
+    WSABUF m_wsabufs[MAX_WSABUF]{};
+
+    std::deque<c_io_buffer> m_out;      // queued, not yet handed to WSASend
+    std::vector<c_io_buffer> m_sending; // owned by the in-flight WSASend
+    size_t m_out_bytes = 0;
+
+    // References held on behalf of in-flight operations
+    std::shared_ptr<c_iocp_channel> m_recv_self;
+    std::shared_ptr<c_iocp_channel> m_send_self;
+
+    bool m_recv_active = false;  // WSARecv pending or its completion being handled
+    bool m_send_active = false;  // WSASend pending or its completion being handled
+    bool m_read_eof = false;
+    bool m_read_paused = false;  // no new WSARecv is posted while set
+    bool m_close_after_send = false;
+    bool m_closed = false;
+    bool m_finished = false;
+
+    void post_recv_locked();
+    bool start_send_locked();
+    void close_locked(bool graceful);
+
+    // Fire on_closed once the socket is closed and no operation is in flight.
+    // Releases the lock.
+    void maybe_finish(std::unique_lock<std::mutex>& lock);
+};
+
+class c_iocp_reactor final : public c_io_reactor {
+public:
+    ~c_iocp_reactor() override { stop(); }
+
+    std::expected<void, std::string> start(size_t io_threads) override;
+    void stop() override;
+    std::shared_ptr<c_io_channel> attach(socket_t sock, s_io_callbacks callbacks) override;
+
+    void forget(c_iocp_channel* channel) {
+        {
+            std::lock_guard lock(m_channels_mutex);
+            m_channels.erase(channel);
+        }
+        m_channels_cv.notify_all();
+    }
+
+private:
+    HANDLE m_port = nullptr;
+    std::vector<std::thread> m_threads;
+    std::mutex m_channels_mutex;
+    std::condition_variable m_channels_cv;
+    std::unordered_map<c_iocp_channel*, std::shared_ptr<c_iocp_channel>> m_channels;
+
+    void io_loop();
+};
+
+// ============================================================================
+// Channel
+// ============================================================================
+
+void c_iocp_channel::begin() {
+    std::unique_lock lock(m_mutex);
+    post_recv_locked();
+    maybe_finish(lock);
+}
+
+bool c_iocp_channel::send(std::string head, c_io_buffer body) {
+    std::unique_lock lock(m_mutex);
+    if (m_closed) {
+        return false;
+    }
+    if (head.empty() && body.empty()) {
+        return true;
+    }
+
+    if (!head.empty()) {
+        m_out_bytes += head.size();
+        m_out.emplace_back(std::move(head));
+    }
+    if (!body.empty()) {
+        m_out_bytes += body.size();
+        m_out.push_back(std::move(body));
+    }
+
+    if (!m_send_active && !start_send_locked()) {
+        maybe_finish(lock);
+        return false;
+    }
+    return true;
+}
+
+bool c_iocp_channel::wait_writable(size_t max_pending, std::chrono::milliseconds timeout) {
+    std::unique_lock lock(m_mutex);
+    m_drained.wait_for(lock, timeout, [&] { return m_closed || m_out_bytes <= max_pending; });
+    return !m_closed && m_out_bytes <= max_pending;
+}
+
+void c_iocp_channel::set_reading(bool enabled) {
+    std::unique_lock lock(m_mutex);
+    m_read_paused = !enabled;
+    if (enabled) {
+        post_recv_locked(); // no-op while a receive is still pending
+    }
+    maybe_finish(lock);
+}
+
+void c_iocp_channel::close_after_send() {
+    std::unique_lock lock(m_mutex);
+    if (m_closed) {
+        return;
+    }
+    m_close_after_send = true;
+    if (!m_send_active && m_out.empty()) {
+        close_locked(true);
+    }
+    maybe_finish(lock);
+}
+
+void c_iocp_channel::close() {
+    std::unique_lock lock(m_mutex);
+    close_locked(false);
+    maybe_finish(lock);
+}
+
+size_t c_iocp_channel::pending_bytes() const {
+    std::lock_guard lock(m_mutex);
+    return m_out_bytes;
+}
+
+void c_iocp_channel::on_completion(s_overlapped_op* op, DWORD bytes, bool ok) {
+    if (!op->is_send) {
+        std::shared_ptr<c_iocp_channel> self;
+        bool closed = false;
+        {
+            std::lock_guard lock(m_mutex);
+            self = std::move(m_recv_self);
+            closed = m_closed;
+        }
+
+        // Callbacks run without the lock: they may send or close re-entrantly.
+        if (ok && bytes > 0) {
+            if (!closed && m_callbacks.on_data) {
+                m_callbacks.on_data(std::string_view(m_recv_buffer, bytes));
+            }
+        } else if (ok && !closed) {
+            if (m_callbacks.on_eof) {
+                m_callbacks.on_eof();
+            }
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_recv_active = false;
+        if (!ok) {
+            close_locked(false);
+        } else if (bytes == 0) {
+            m_read_eof = true;
+        } else {
+            post_recv_locked();
+        }
+        maybe_finish(lock);
+        return;
+    }
+
+    std::unique_lock lock(m_mutex);
+    auto self = std::move(m_send_self);
+    m_send_active = false;
+
+    if (!ok) {
+        m_sending.clear();
+        close_locked(false);
+        maybe_finish(lock);
+        return;
+    }
+
+    // Overlapped stream sends normally complete in full; requeue any remainder.
+    size_t remaining = bytes;
+    m_out_bytes -= (remaining < m_out_bytes) ? remaining : m_out_bytes;
+    m_drained.notify_all();
+    size_t index = 0;
+    for (; index < m_sending.size() && remaining >= m_sending[index].size(); ++index) {
+        remaining -= m_sending[index].size();
+    }
+    if (index < m_sending.size()) {
+        m_sending[index].consume(remaining);
+        m_out.insert(m_out.begin(),
+                     std::make_move_iterator(m_sending.begin() + static_cast<ptrdiff_t>(index)),
+                     std::make_move_iterator(m_sending.end()));
+    }
+    m_sending.clear();
+
+    if (!m_closed) {
+        if (!m_out.empty()) {
+            start_send_locked();
+        } else if (m_close_after_send) {
+            close_locked(true);
+        }
+    }
+    maybe_finish(lock);
+}
+
+void c_iocp_channel::post_recv_locked() {
+    if (m_closed || m_read_eof || m_recv_active || m_read_paused) {
+        return;
+    }
+
+    ZeroMemory(&m_recv_op.overlapped, sizeof(m_recv_op.overlapped));
+    WSABUF buf{static_cast<ULONG>(sizeof(m_recv_buffer)), m_recv_buffer};
+    DWORD flags = 0;
+
+    m_recv_active = true;
+    m_recv_self = shared_from_this();
+    if (WSARecv(m_socket, &buf, 1, nullptr, &flags, &m_recv_op.overlapped, nullptr) == SOCKET_ERROR &&
+        WSAGetLastError() != WSA_IO_PENDING) {
+        m_recv_active = false;
+        m_recv_self.reset();
+        close_locked(false);
+    }
+}
+
+bool c_iocp_channel::start_send_locked() {
+    m_sending.clear();
+    while (!m_out.empty() && m_sending.size() < MAX_WSABUF) {
+        m_sending.push_back(std::move(m_out.front()));
+        m_out.pop_front();
+    }
+    for (size_t i = 0; i < m_sending.size(); ++i) {
+        m_wsabufs[i].buf = const_cast<CHAR*>(m_sending[i].data());
+        m_wsabufs[i].len = static_cast<ULONG>(m_sending[i].size());
+    }
+
+    ZeroMemory(&m_send_op.overlapped, sizeof(m_send_op.overlapped));
+    m_send_active = true;
+    m_send_self = shared_from_this();
+    if (WSASend(m_socket, m_wsabufs, static_cast<DWORD>(m_sending.size()), nullptr, 0,
+                &m_send_op.overlapped, nullptr) == SOCKET_ERROR &&
+        WSAGetLastError() != WSA_IO_PENDING) {
+        m_send_active = false;
+        m_send_self.reset();
+        m_sending.clear();
+        close_locked(false);
+        return false;
+    }
+    return true;
+}
+
+void c_iocp_channel::close_locked(bool graceful) {
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+    m_out.clear();
+    m_out_bytes = 0;
+    m_drained.notify_all();
+
+    // Closing the socket cancels pending operations; their completions
+    // arrive with an error and release the references they hold.
+    if (graceful) {
+        net::shutdown_send(m_socket);
+    }
+    net::close_socket(m_socket);
+}
+
+void c_iocp_channel::abandon() {
+    s_io_callbacks callbacks;
+    {
+        std::lock_guard lock(m_mutex);
+        m_finished = true;
+        callbacks = std::move(m_callbacks);
+        m_callbacks = {};
+    }
+    // Destroyed here, without the lock: they own the server's connection
+}
+
+void c_iocp_channel::maybe_finish(std::unique_lock<std::mutex>& lock) {
+    if (!m_closed || m_recv_active || m_send_active || m_finished) {
+        lock.unlock();
+        return;
+    }
+    m_finished = true;
+    auto callbacks = std::move(m_callbacks);
+    m_callbacks = {};
+    lock.unlock();
+
+    if (callbacks.on_closed) {
+        callbacks.on_closed();
+    }
+    m_reactor.forget(this);
+}
+
+// ============================================================================
+// Reactor
+// ============================================================================
+
+std::expected<void, std::string> c_iocp_reactor::start(size_t io_threads) {
+    if (!m_threads.empty()) {
+        return std::unexpected("Reactor is already running");
+    }
+
+    m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, static_cast<DWORD>(io_threads));
+    if (m_port == nullptr) {
+        return std::unexpected("CreateIoCompletionPort() failed with error: " +
+                               std::to_string(GetLastError()));
+    }
+
+    for (size_t i = 0; i < io_threads; ++i) {
+        m_threads.emplace_back(&c_iocp_reactor::io_loop, this);
+    }
+
+    return {};
+}
+
+void c_iocp_reactor::stop() {
+    if (m_threads.empty()) {
+        return;
+    }
+
+    // Close every channel while the I/O threads are still running, so the
+    // cancelled operations complete and each channel reports on_closed.
+    std::vector<std::shared_ptr<c_iocp_channel>> remaining;
+    {
+        std::lock_guard lock(m_channels_mutex);
+        for (auto& [ptr, channel] : m_channels) {
+            remaining.push_back(channel);
+        }
+    }
+    for (auto& channel : remaining) {
+        channel->close();
+    }
+    remaining.clear();
+
+    std::vector<std::shared_ptr<c_iocp_channel>> stuck;
+    {
+        std::unique_lock lock(m_channels_mutex);
+        m_channels_cv.wait_for(lock, std::chrono::milliseconds(STOP_DRAIN_MS),
+                               [this] { return m_channels.empty(); });
+        for (auto& [ptr, channel] : m_channels) {
+            stuck.push_back(std::move(channel));
+        }
+        m_channels.clear();
+    }
+
+    // Their cancelled operations never completed. The kernel may still write
+    // into their OVERLAPPED and buffers after the port is closed, so they are
+    // leaked rather than freed with the server.
+    if (!stuck.empty()) {
+        char message[128];
+        std::snprintf(message, sizeof(message),
+                      "[MCP] %zu connection(s) still had I/O pending at shutdown; leaking them\n", stuck.size());
+        OutputDebugStringA(message);
+
+        static auto* abandoned = new std::vector<std::shared_ptr<c_iocp_channel>>();
+        for (auto& channel : stuck) {
+            channel->abandon();
+            abandoned->push_back(std::move(channel));
+        }
+    }
+
+    for (size_t i = 0; i < m_threads.size(); ++i) {
+        PostQueuedCompletionStatus(m_port, 0, EXIT_KEY, nullptr);
+    }
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+
+    CloseHandle(m_port);
+    m_port = nullptr;
+}
+
+std::shared_ptr<c_io_channel> c_iocp_reactor::attach(socket_t sock, s_io_callbacks callbacks) {
+    if (m_port == nullptr ||
+        CreateIoCompletionPort(reinterpret_cast<HANDLE>(sock), m_port, 0, 0) == nullptr) {
+        net::close_socket(sock);
+        return nullptr;
+    }
+
+    auto channel = std::make_shared<c_iocp_channel>(*this, sock, std::move(callbacks));
+    {
+        std::lock_guard lock(m_channels_mutex);
+        m_channels.emplace(channel.get(), channel);
+    }
+
+    channel->begin();
+    return channel;
+}
+
+void c_iocp_reactor::io_loop() {
+    while (true) {
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+
+        BOOL ok = GetQueuedCompletionStatus(m_port, &bytes, &key, &overlapped, INFINITE);
+        if (overlapped == nullptr) {
+            if (key == EXIT_KEY || !ok) {
+                return;
+            }
+            continue;
+        }
+
+        auto* op = CONTAINING_RECORD(overlapped, s_overlapped_op, overlapped);
+        op->owner->on_completion(op, bytes, ok != FALSE);
+    }
+}
+
+} // namespace
+
+std::unique_ptr<c_io_reactor> c_io_reactor::create() {
+    return std::make_unique<c_iocp_reactor>();
+}
+
+#endif // _WIN32
@@ -0,0 +1,82 @@
+#include "http/c_json_stream.h"
+
+#include "util/c_job_manager.h"
+
+c_json_array_stream::c_json_array_stream(
+    const body_writer_t& write, const nlohmann::json& head_fields, std::string_view array_key
+) : m_write(write), m_last_flush(std::chrono::steady_clock::now()) {
+    m_pending.reserve(PIECE_SIZE + 1024);
+    m_pending = R"({"success":true,"data":{)";
+
+    // Head fields are an object; splice its members in without the braces
+    if (head_fields.is_object() && !head_fields.empty()) {
+        auto fields = head_fields.dump();
+        m_pending.append(fields, 1, fields.size() - 2);
+        m_pending += ',';
+    }
+
+    m_writer.key(array_key).begin_array();
+
+    // Send the envelope head right away so the client sees the first byte
+    flush();
+}
+
+bool c_json_array_stream::push(const nlohmann::json& item) {
+    if (!m_alive) {
+        return false;
+    }
+
+    m_writer.value(item);
+    ++m_count;
+    c_job_manager::report_partial(item);
+    return flush_if_due();
+}
+
+bool c_json_array_stream::item_written(size_t start) {
+    ++m_count;
+    if (c_job_manager::in_job()) {
+        // Only jobs keep partial items; parse the element back for them
+        auto item = std::string_view(m_pending).substr(start);
+        if (item.starts_with(',')) {
+            item.remove_prefix(1);
+        }
+        c_job_manager::report_partial(nlohmann::json::parse(item));
+    }
+    return flush_if_due();
+}
+
+bool c_json_array_stream::flush_if_due() {
+    if (m_pending.size() >= PIECE_SIZE ||
+        std::chrono::steady_clock::now() - m_last_flush >= FLUSH_INTERVAL) {
+        return flush();
+    }
+    return true;
+}
+
+bool c_json_array_stream::finish(const nlohmann::json& tail_fields) {
+    if (!m_alive) {
+        return false;
+    }
+
+    m_writer.end_array();
+    if (tail_fields.is_object() && !tail_fields.empty()) {
+        auto fields = tail_fields.dump();
+        m_pending += ',';
+        m_pending.append(fields, 1, fields.size() - 2);
+    }
+    m_pending += "}}";
+    return flush();
+}
+
+bool c_json_array_stream::flush() {
+    m_last_flush = std::chrono::steady_clock::now();
+    if (m_pending.empty()) {
+        return m_alive;
+    }
+
+    std::string piece;
+    piece.reserve(PIECE_SIZE + 1024);
+    piece.swap(m_pending);
+    m_alive = m_write(std::move(piece)) && m_alive;
+    return m_alive;
+}
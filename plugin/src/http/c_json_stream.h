@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <nlohmann/json.hpp>
+
+#include "http/c_json_writer.h"
+#include "http/s_http_response.h"
+
+// Writes a success envelope whose payload ends in one large array, item by
+// item, for use inside a chunked body producer:
+//
+//   {"success":true,"data":{<head fields>,"<key>":[item,...],<tail fields>}}
+//
+// Items are batched into pieces of a few KB before reaching the writer; a slow
+// producer's first items are still flushed promptly. Inside a background job
+// each item is also reported as a partial result (see c_job_manager).
+//
+// Prefer emit() for large listings: it writes the item straight into the
+// pending piece through a c_json_writer instead of building a DOM per item.
+class c_json_array_stream {
+public:
+    c_json_array_stream(const body_writer_t& write, const nlohmann::json& head_fields, std::string_view array_key);
+
+    // Append one array element. Returns false once the client is gone.
+    bool push(const nlohmann::json& item);
+
+    // Append one element written in place: `write_item` receives the writer
+    // positioned at the element and must write exactly one value. Returns
+    // false once the client is gone.
+    template <typename F>
+    bool emit(F&& write_item) {
+        if (!m_alive) {
+            return false;
+        }
+        const size_t start = m_pending.size();
+        write_item(m_writer);
+        return item_written(start);
+    }
+
+    // Close the array and the envelope, adding the tail fields (an object)
+    bool finish(const nlohmann::json& tail_fields = nlohmann::json::object());
+
+    [[nodiscard]] size_t count() const { return m_count; }
+    [[nodiscard]] bool alive() const { return m_alive; }
+
+private:
+    static constexpr size_t PIECE_SIZE = 16 * 1024;
+    static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(100);
+
+    const body_writer_t& m_write;
+    std::string m_pending;
+    c_json_writer m_writer{m_pending};
+    size_t m_count = 0;
+    bool m_alive = true;
+    std::chrono::steady_clock::time_point m_last_flush;
+
+    // Count the element written from m_pending[start] on, report it to a
+    // running job and flush if the piece is due
+    bool item_written(size_t start);
+    bool flush_if_due();
+    bool flush();
+};
@@ -0,0 +1,226 @@
+#include "http/c_json_writer.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+constexpr char HEX_UPPER[] = "0123456789ABCDEF";
+constexpr char HEX_LOWER[] = "0123456789abcdef";
+
+// The UTF-8 sequence at text[i]: a well-formed one (RFC 3629: no overlong
+// forms, surrogates or code points past U+10FFFF), or else its maximal
+// ill-formed prefix, which is replaced by a single U+FFFD as the Unicode
+// standard and nlohmann::json's replace mode do
+struct s_utf8_sequence {
+    size_t length;
+    bool valid;
+};
+
+s_utf8_sequence utf8_sequence(std::string_view text, size_t i) {
+    const auto lead = static_cast<uint8_t>(text[i]);
+    size_t continuations = 0;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        continuations = 1;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        continuations = 2;
+        if (lead == 0xE0) low = 0xA0;  // overlong
+        if (lead == 0xED) high = 0x9F; // surrogate
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        continuations = 3;
+        if (lead == 0xF0) low = 0x90;  // overlong
+        if (lead == 0xF4) high = 0x8F; // past U+10FFFF
+    } else {
+        return {1, false};
+    }
+
+    // Only the first continuation byte has a narrowed range
+    for (size_t k = 1; k <= continuations; ++k) {
+        if (i + k >= text.size()) {
+            return {k, false};
+        }
+        const auto c = static_cast<uint8_t>(text[i + k]);
+        if (c < low || c > high) {
+            return {k, false};
+        }
+        low = 0x80;
+        high = 0xBF;
+    }
+    return {continuations + 1, true};
+}
+
+} // namespace
+
+void c_json_writer::before_value() {
+    if (m_need_comma) {
+        m_out += ',';
+    }
+}
+
+c_json_writer& c_json_writer::begin_object() {
+    before_value();
+    m_out += '{';
+    m_need_comma = false;
+    return *this;
+}
+
+c_json_writer& c_json_writer::end_object() {
+    m_out += '}';
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::begin_array() {
+    before_value();
+    m_out += '[';
+    m_need_comma = false;
+    return *this;
+}
+
+c_json_writer& c_json_writer::end_array() {
+    m_out += ']';
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::key(std::string_view name) {
+    before_value();
+    write_string(name);
+    m_out += ':';
+    m_need_comma = false;
+    return *this;
+}
+
+c_json_writer& c_json_writer::value(std::string_view text) {
+    before_value();
+    write_string(text);
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::value(double number) {
+    if (!std::isfinite(number)) {
+        return literal("null"); // as nlohmann::json dumps NaN and infinities
+    }
+    before_value();
+    char text[32];
+    auto [end, ec] = std::to_chars(text, text + sizeof(text), number);
+    m_out.append(text, end);
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::value(const nlohmann::json& document) {
+    before_value();
+    m_out += document.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::address(uint64_t value, int digits) {
+    before_value();
+    char text[2 + 16 + 2];
+    char* p = text;
+    *p++ = '"';
+    *p++ = '0';
+    *p++ = 'x';
+    for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+        *p++ = HEX_UPPER[(value >> shift) & 0xF];
+    }
+    *p++ = '"';
+    m_out.append(text, p);
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::raw(std::string_view json) {
+    before_value();
+    m_out += json;
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::literal(std::string_view text) {
+    before_value();
+    m_out += text;
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::integer(int64_t number) {
+    before_value();
+    char text[24];
+    auto [end, ec] = std::to_chars(text, text + sizeof(text), number);
+    m_out.append(text, end);
+    m_need_comma = true;
+    return *this;
+}
+
+c_json_writer& c_json_writer::unsigned_integer(uint64_t number) {
+    before_value();
+    char text[24];
+    auto [end, ec] = std::to_chars(text, text + sizeof(text), number);
+    m_out.append(text, end);
+    m_need_comma = true;
+    return *this;
+}
+
+void c_json_writer::write_string(std::string_view text) {
+    m_out += '"';
+
+    // Copy runs that need no escaping in one append
+    size_t run = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        const auto c = static_cast<uint8_t>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80) {
+            ++i;
+            continue;
+        }
+        if (c >= 0x80) {
+            auto sequence = utf8_sequence(text, i);
+            if (!sequence.valid) {
+                m_out.append(text.data() + run, i - run);
+                m_out += "\xEF\xBF\xBD"; // U+FFFD
+                run = i + sequence.length;
+            }
+            i += sequence.length;
+            continue;
+        }
+
+        m_out.append(text.data() + run, i - run);
+        switch (c) {
+            case '"':  m_out += "\\\""; break;
+            case '\\': m_out += "\\\\"; break;
+            case '\b': m_out += "\\b"; break;
+            case '\f': m_out += "\\f"; break;
+            case '\n': m_out += "\\n"; break;
+            case '\r': m_out += "\\r"; break;
+            case '\t': m_out += "\\t"; break;
+            default: {
+                const char escape[] = {'\\', 'u', '0', '0', HEX_LOWER[c >> 4], HEX_LOWER[c & 0xF]};
+                m_out.append(escape, sizeof(escape));
+                break;
+            }
+        }
+        run = ++i;
+    }
+    m_out.append(text.data() + run, text.size() - run);
+    m_out += '"';
+}
+
+c_json_envelope::c_json_envelope(size_t reserve) {
+    m_body.reserve(reserve);
+    m_body = R"({"success":true,"data":)";
+}
+
+s_http_response c_json_envelope::finish() {
+    m_body += '}';
+
+    s_http_response resp;
+    resp.body = std::move(m_body);
+    resp.envelope_in_body = true;
+    return resp;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <nlohmann/json.hpp>
+
+#include "http/s_http_response.h"
+
+// Streaming JSON serializer: values are appended to a string as the handler
+// produces them, with no DOM in between. The writer only inserts the commas
+// and colons; the caller is responsible for nesting begin/end calls and for
+// writing a value after every key.
+//
+//   out.begin_object()
+//      .field("address", ...)
+//      .key("exits").begin_array().value(a).value(b).end_array()
+//      .end_object();
+//
+// Strings come out byte for byte as nlohmann::json::dump() writes them in its
+// replace mode: bytes that are not valid UTF-8 become U+FFFD instead of
+// throwing.
+class c_json_writer {
+public:
+    // Hex digits in format_utils::format_address() output for this build
+    static constexpr int ADDRESS_DIGITS = 2 * sizeof(void*);
+
+    explicit c_json_writer(std::string& out) : m_out(out) {}
+
+    c_json_writer(const c_json_writer&) = delete;
+    c_json_writer& operator=(const c_json_writer&) = delete;
+
+    c_json_writer& begin_object();
+    c_json_writer& end_object();
+    c_json_writer& begin_array();
+    c_json_writer& end_array();
+
+    // Object member name; the next call writes its value
+    c_json_writer& key(std::string_view name);
+
+    c_json_writer& value(std::string_view text);
+    c_json_writer& value(const char* text) { return value(std::string_view(text)); }
+    c_json_writer& value(const std::string& text) { return value(std::string_view(text)); }
+
+    template <std::integral T>
+    c_json_writer& value(T number) {
+        if constexpr (std::same_as<T, bool>) {
+            return literal(number ? "true" : "false");
+        } else if constexpr (std::is_signed_v<T>) {
+            return integer(static_cast<int64_t>(number));
+        } else {
+            return unsigned_integer(static_cast<uint64_t>(number));
+        }
+    }
+
+    c_json_writer& value(double number);
+
+    // An existing document, for the odd field that is already one
+    c_json_writer& value(const nlohmann::json& document);
+
+    c_json_writer& null() { return literal("null"); }
+
+    // An address as format_utils::format_address() spells it ("0x" and
+    // zero-padded uppercase hex), without the temporary string
+    c_json_writer& address(uint64_t value, int digits = ADDRESS_DIGITS);
+
+    // Already serialized JSON, written as one value
+    c_json_writer& raw(std::string_view json);
+
+    template <typename T>
+    c_json_writer& field(std::string_view name, T&& v) {
+        key(name);
+        return value(std::forward<T>(v));
+    }
+
+    c_json_writer& address_field(std::string_view name, uint64_t v) {
+        key(name);
+        return address(v);
+    }
+
+    [[nodiscard]] std::string& buffer() { return m_out; }
+
+private:
+    std::string& m_out;
+    bool m_need_comma = false; // a value was just completed at this level
+
+    void before_value();
+    c_json_writer& literal(std::string_view text);
+    c_json_writer& integer(int64_t number);
+    c_json_writer& unsigned_integer(uint64_t number);
+    void write_string(std::string_view text);
+};
+
+// Success response written straight into the response body: the envelope's
+// head is emitted up front, the handler writes the payload through data(),
+// and finish() closes the envelope and hands over the buffer. Replaces
+// s_http_response::ok() for payloads large enough that building the DOM,
+// copying it into the envelope and dumping it shows up in profiles.
+//
+//   c_json_envelope out;
+//   out.data().begin_object().field("count", n)...end_object();
+//   return out.finish();
+class c_json_envelope {
+public:
+    explicit c_json_envelope(size_t reserve = 4096);
+
+    c_json_envelope(const c_json_envelope&) = delete;
+    c_json_envelope& operator=(const c_json_envelope&) = delete;
+
+    // Positioned at the "data" member; write exactly one value
+    [[nodiscard]] c_json_writer& data() { return m_writer; }
+
+    [[nodiscard]] s_http_response finish();
+
+private:
+    std::string m_body;
+    c_json_writer m_writer{m_body};
+};
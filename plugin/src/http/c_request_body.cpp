@@ -0,0 +1,187 @@
+#include "http/c_request_body.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+constexpr auto WAIT_SLICE = std::chrono::milliseconds(100); // re-check the connection this often
+
+} // namespace
+
+c_request_body::c_request_body(std::optional<uint64_t> length, uint64_t max_size,
+                               std::function<void(bool)> set_reading, std::function<bool()> connected)
+    : m_length(length)
+    , m_max_size(max_size)
+    , m_set_reading(std::move(set_reading))
+    , m_connected(std::move(connected))
+    , m_state(!length ? e_state::chunk_size : *length > 0 ? e_state::data : e_state::done)
+    , m_remaining(length.value_or(0)) {}
+
+bool c_request_body::read(std::string& piece, std::chrono::milliseconds stall_timeout) {
+    std::unique_lock lock(m_mutex);
+    auto deadline = std::chrono::steady_clock::now() + stall_timeout;
+    while (m_pending.empty()) {
+        if (m_state == e_state::done || m_state == e_state::failed) {
+            return false;
+        }
+        if (!m_connected()) {
+            fail_locked("Connection closed before the request body was complete");
+            return false;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            fail_locked("Timed out waiting for the request body");
+            return false;
+        }
+        m_cv.wait_for(lock, WAIT_SLICE);
+    }
+
+    piece = std::move(m_pending);
+    m_pending.clear();
+    if (m_paused) {
+        // Called under m_mutex so a pause from feed() cannot overtake it
+        m_paused = false;
+        m_set_reading(true);
+    }
+    return true;
+}
+
+uint64_t c_request_body::received() const {
+    std::lock_guard lock(m_mutex);
+    return m_received;
+}
+
+bool c_request_body::complete() const {
+    std::lock_guard lock(m_mutex);
+    return m_state == e_state::done;
+}
+
+bool c_request_body::receiving() const {
+    std::lock_guard lock(m_mutex);
+    return m_state != e_state::done && m_state != e_state::failed;
+}
+
+std::string c_request_body::error() const {
+    std::lock_guard lock(m_mutex);
+    return m_error;
+}
+
+size_t c_request_body::feed(std::string_view data) {
+    std::lock_guard lock(m_mutex);
+    size_t pos = 0;
+    while (pos < data.size() && m_state != e_state::done && m_state != e_state::failed) {
+        if (m_state == e_state::data) {
+            auto take = static_cast<size_t>(std::min<uint64_t>(m_remaining, data.size() - pos));
+            append_locked(data.substr(pos, take));
+            pos += take;
+            m_remaining -= take;
+            if (m_remaining == 0) {
+                m_state = m_length ? e_state::done : e_state::chunk_end;
+            }
+            continue;
+        }
+
+        // Line-oriented chunked framing: collect up to the LF
+        auto eol = data.find('\n', pos);
+        auto end = (eol == std::string_view::npos) ? data.size() : eol;
+        if (m_line.size() + (end - pos) > MAX_LINE) {
+            fail_locked("Chunked framing line too long");
+            break;
+        }
+        m_line.append(data.substr(pos, end - pos));
+        pos = end;
+        if (eol == std::string_view::npos) {
+            break;
+        }
+        ++pos;
+
+        if (!m_line.empty() && m_line.back() == '\r') {
+            m_line.pop_back();
+        }
+        std::string line = std::move(m_line);
+        m_line.clear();
+        if (!on_line_locked(line)) {
+            break;
+        }
+    }
+
+    m_cv.notify_all();
+    return m_state == e_state::failed ? data.size() : pos;
+}
+
+void c_request_body::abort(std::string reason) {
+    std::lock_guard lock(m_mutex);
+    fail_locked(std::move(reason));
+}
+
+void c_request_body::fail_locked(std::string reason) {
+    if (m_state == e_state::done || m_state == e_state::failed) {
+        return;
+    }
+    m_state = e_state::failed;
+    m_error = std::move(reason);
+    m_pending.clear();
+    m_line.clear();
+    if (m_paused) {
+        // Keep draining the socket (feed swallows the rest) so the client
+        // can get to reading the error response
+        m_paused = false;
+        m_set_reading(true);
+    }
+    m_cv.notify_all();
+}
+
+void c_request_body::append_locked(std::string_view bytes) {
+    m_pending.append(bytes);
+    m_received += bytes.size();
+    if (!m_paused && m_pending.size() >= HIGH_WATERMARK) {
+        m_paused = true;
+        m_set_reading(false);
+    }
+}
+
+bool c_request_body::on_line_locked(std::string_view line) {
+    switch (m_state) {
+    case e_state::chunk_size: {
+        // "1a2b[;extension]": extensions are ignored
+        auto digits = line.substr(0, line.find(';'));
+        while (!digits.empty() && (digits.back() == ' ' || digits.back() == '\t')) {
+            digits.remove_suffix(1);
+        }
+        uint64_t size = 0;
+        auto res = std::from_chars(digits.data(), digits.data() + digits.size(), size, 16);
+        if (digits.empty() || res.ec != std::errc{} || res.ptr != digits.data() + digits.size()) {
+            fail_locked("Malformed chunk size");
+            return false;
+        }
+        if (size == 0) {
+            m_state = e_state::trailers;
+        } else if (size > m_max_size - m_received) {
+            fail_locked("Request body exceeds " + std::to_string(m_max_size) + " bytes");
+            return false;
+        } else {
+            m_remaining = size;
+            m_state = e_state::data;
+        }
+        return true;
+    }
+
+    case e_state::chunk_end:
+        if (!line.empty()) {
+            fail_locked("Chunk data not followed by CRLF");
+            return false;
+        }
+        m_state = e_state::chunk_size;
+        return true;
+
+    case e_state::trailers:
+        // Trailer fields carry nothing a handler uses; the blank line ends the body
+        if (line.empty()) {
+            m_state = e_state::done;
+        }
+        return true;
+
+    default:
+        return true;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// A request body handed to an upload handler while it is still arriving.
+// The server feeds it from the connection's I/O thread (Content-Length or
+// chunked framing); the handler pulls pieces on its worker thread. Past
+// HIGH_WATERMARK unread bytes the socket stops being read, so a slow handler
+// holds the client back through TCP instead of the body piling up in memory.
+class c_request_body {
+public:
+    static constexpr size_t HIGH_WATERMARK = 1024 * 1024; // unread bytes before reading pauses
+
+    // `length` is the Content-Length, or nullopt for a chunked body, which is
+    // refused once it grows past `max_size`. `set_reading` pauses or resumes
+    // the socket; `connected` reports whether the client is still there.
+    c_request_body(std::optional<uint64_t> length, uint64_t max_size,
+                   std::function<void(bool)> set_reading, std::function<bool()> connected);
+
+    // Non-copyable, non-movable
+    c_request_body(const c_request_body&) = delete;
+    c_request_body& operator=(const c_request_body&) = delete;
+    c_request_body(c_request_body&&) = delete;
+    c_request_body& operator=(c_request_body&&) = delete;
+
+    // Handler side: take everything received so far, waiting for at least
+    // one byte. False at the end of the body, or if it failed (see error()):
+    // malformed, aborted, or nothing arrived for stall_timeout.
+    [[nodiscard]] bool read(std::string& piece,
+                            std::chrono::milliseconds stall_timeout = std::chrono::seconds(10));
+
+    // Declared length; nullopt for a chunked body
+    [[nodiscard]] std::optional<uint64_t> length() const { return m_length; }
+
+    // Body bytes received so far (decoded, for a chunked body)
+    [[nodiscard]] uint64_t received() const;
+
+    // The whole body has arrived, so the connection's framing is intact
+    [[nodiscard]] bool complete() const;
+
+    // More body bytes are expected (neither complete nor failed)
+    [[nodiscard]] bool receiving() const;
+
+    // Why the body failed; empty if it has not
+    [[nodiscard]] std::string error() const;
+
+    // Server side: consume body bytes from the front of `data` and return how
+    // many were taken. Once complete, bytes past the body (a pipelined request)
+    // are left for the caller. After a failure everything is swallowed.
+    size_t feed(std::string_view data);
+
+    // Fail the body (client gone, handler gave up). No-op once complete.
+    void abort(std::string reason);
+
+private:
+    enum class e_state {
+        data,          // inside the body, or a chunk's data
+        chunk_size,    // reading a chunk-size line
+        chunk_end,     // reading the CRLF after a chunk's data
+        trailers,      // reading trailer lines up to the blank one
+        done,
+        failed
+    };
+
+    static constexpr size_t MAX_LINE = 256; // chunk-size and trailer lines
+
+    // Caller holds m_mutex
+    void fail_locked(std::string reason);
+    void append_locked(std::string_view bytes);
+    [[nodiscard]] bool on_line_locked(std::string_view line);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    const std::optional<uint64_t> m_length;
+    const uint64_t m_max_size;
+    std::function<void(bool)> m_set_reading;
+    std::function<bool()> m_connected;
+
+    e_state m_state;
+    std::string m_pending;     // received, not yet read by the handler
+    std::string m_line;        // partial chunk-size / trailer line
+    uint64_t m_remaining = 0;  // of the body, or of the current chunk
+    uint64_t m_received = 0;
+    bool m_paused = false;     // reading paused until the handler catches up
+    std::string m_error;
+};
@@ -0,0 +1,179 @@
+#include "http/c_response_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "util/c_prometheus_writer.h"
+
+namespace {
+
+uint64_t fnv1a(std::string_view text) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// "W/\"x\"" and "\"x\"" compare equal under weak comparison
+std::string_view opaque_tag(std::string_view etag) {
+    if (etag.starts_with("W/")) etag.remove_prefix(2);
+    return etag;
+}
+
+// Different in every process. The clock covers a random_device that is
+// deterministic on some toolchains.
+uint64_t make_instance_id() {
+    std::random_device device;
+    uint64_t id = (static_cast<uint64_t>(device()) << 32) | device();
+    return id ^ static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+} // namespace
+
+c_response_cache::c_response_cache()
+    : m_instance(make_instance_id()) {
+}
+
+void c_response_cache::enable(std::function<bool()> condition) {
+    m_condition = std::move(condition);
+}
+
+bool c_response_cache::active() const {
+    return m_condition && m_condition();
+}
+
+c_response_cache::s_ticket c_response_cache::ticket(const s_http_request& request, std::string_view variant) const {
+    // Query parameters in any order name the same resource
+    std::vector<std::string_view> params;
+    for (auto rest = request.query_string; !rest.empty();) {
+        auto amp = rest.find('&');
+        auto param = rest.substr(0, amp);
+        if (!param.empty()) params.push_back(param);
+        rest = (amp == std::string_view::npos) ? std::string_view{} : rest.substr(amp + 1);
+    }
+    std::sort(params.begin(), params.end());
+
+    s_ticket result;
+    result.key.reserve(request.path.size() + request.query_string.size() + variant.size() + 2);
+    result.key.append(request.path);
+    result.key += '?';
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (i > 0) result.key += '&';
+        result.key.append(params[i]);
+    }
+    result.key += '\n';
+    result.key.append(variant);
+
+    result.epoch = epoch();
+    char etag[64];
+    std::snprintf(etag, sizeof(etag), "W/\"%016llx-%llx-%016llx\"",
+                  static_cast<unsigned long long>(m_instance),
+                  static_cast<unsigned long long>(result.epoch),
+                  static_cast<unsigned long long>(fnv1a(result.key)));
+    result.etag = etag;
+    return result;
+}
+
+c_response_cache::entry_ptr c_response_cache::find(const s_ticket& ticket) {
+    std::lock_guard lock(m_mutex);
+    retire_locked(epoch());
+
+    auto it = m_entries.find(ticket.key);
+    if (it == m_entries.end() || m_entries_epoch != ticket.epoch) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    if (std::chrono::steady_clock::now() - it->second.stored > MAX_AGE) {
+        m_bytes -= it->second.response->body.size();
+        m_entries.erase(it);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    return it->second.response;
+}
+
+void c_response_cache::store(const s_ticket& ticket, s_http_response response) {
+    if (response.body_stream || response.body.size() > MAX_ENTRY_BYTES) {
+        return;
+    }
+    response.document.reset();
+    auto entry = std::make_shared<const s_http_response>(std::move(response));
+
+    std::lock_guard lock(m_mutex);
+    retire_locked(epoch());
+    if (ticket.epoch != m_entries_epoch) {
+        return; // computed in an epoch that has since ended
+    }
+
+    // Every entry dies with the epoch anyway, so on overflow start over
+    // rather than track recency
+    if (m_bytes + entry->body.size() > MAX_BYTES) {
+        m_entries.clear();
+        m_bytes = 0;
+    }
+
+    auto& slot = m_entries[ticket.key];
+    if (slot.response) {
+        m_bytes -= slot.response->body.size();
+    }
+    m_bytes += entry->body.size();
+    slot.response = std::move(entry);
+    slot.stored = std::chrono::steady_clock::now();
+}
+
+bool c_response_cache::matches(std::string_view if_none_match, std::string_view etag) {
+    while (!if_none_match.empty()) {
+        auto comma = if_none_match.find(',');
+        auto candidate = trim(if_none_match.substr(0, comma));
+        if_none_match = (comma == std::string_view::npos) ? std::string_view{} : if_none_match.substr(comma + 1);
+
+        if (candidate == "*" || (!candidate.empty() && opaque_tag(candidate) == opaque_tag(etag))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void c_response_cache::write_metrics(c_prometheus_writer& out) const {
+    out.family("x64dbg_mcp_http_cache_requests_total", "counter",
+               "Requests to cacheable routes, by how the response cache served them.");
+    out.sample("x64dbg_mcp_http_cache_requests_total", {{"result", "hit"}}, m_hits.load(std::memory_order_relaxed));
+    out.sample("x64dbg_mcp_http_cache_requests_total", {{"result", "miss"}}, m_misses.load(std::memory_order_relaxed));
+    out.sample("x64dbg_mcp_http_cache_requests_total", {{"result", "not_modified"}},
+               m_not_modified.load(std::memory_order_relaxed));
+
+    size_t entries = 0;
+    size_t bytes = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_entries_epoch == epoch()) {
+            entries = m_entries.size();
+            bytes = m_bytes;
+        }
+    }
+    out.family("x64dbg_mcp_http_cache_entries", "gauge", "Responses held by the response cache.");
+    out.sample("x64dbg_mcp_http_cache_entries", {}, static_cast<uint64_t>(entries));
+    out.family("x64dbg_mcp_http_cache_bytes", "gauge", "Body bytes held by the response cache.");
+    out.sample("x64dbg_mcp_http_cache_bytes", {}, static_cast<uint64_t>(bytes));
+    out.family("x64dbg_mcp_http_cache_epoch", "gauge", "Current cache epoch; moves on every debuggee state change.");
+    out.sample("x64dbg_mcp_http_cache_epoch", {}, epoch());
+}
+
+void c_response_cache::retire_locked(uint64_t epoch) {
+    if (m_entries_epoch != epoch) {
+        m_entries.clear();
+        m_bytes = 0;
+        m_entries_epoch = epoch;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "http/s_http_request.h"
+#include "http/s_http_response.h"
+
+class c_prometheus_writer;
+
+// Finished responses of read-only routes whose output depends only on the
+// debuggee's state, kept while that state cannot change (the debuggee is
+// paused). Entries belong to an epoch: invalidate() moves to the next one,
+// retiring every entry at once, and is called whenever the state may have
+// changed (resume, step, and routes the router marks mutating). A response's
+// ETag names its epoch, so a client revalidating within the same epoch gets
+// a 304 without the route running. Epochs restart with the process, so the
+// ETag also carries a random instance id: a tag from an earlier run never
+// matches.
+class c_response_cache {
+public:
+    static constexpr size_t MAX_BYTES = 64 * 1024 * 1024;      // all bodies together
+    static constexpr size_t MAX_ENTRY_BYTES = 8 * 1024 * 1024; // larger responses are not kept
+    // Edits made in the x64dbg UI fire no callback; this bounds how long an
+    // entry can hide one
+    static constexpr std::chrono::seconds MAX_AGE{30};
+
+    // Where a request's response lives: its key (route, normalized query and
+    // representation) and the epoch it is computed in
+    struct s_ticket {
+        std::string key;
+        uint64_t epoch = 0;
+        std::string etag;
+    };
+
+    using entry_ptr = std::shared_ptr<const s_http_response>;
+
+    c_response_cache();
+
+    // Cache only while `condition` holds (checked per request). Off until set.
+    void enable(std::function<bool()> condition);
+
+    // True if responses may be served from or stored in the cache right now
+    [[nodiscard]] bool active() const;
+
+    // Retire every entry: the state they were computed from may have changed.
+    // Safe from any thread, including debugger callbacks.
+    void invalidate() { m_epoch.fetch_add(1, std::memory_order_acq_rel); }
+
+    [[nodiscard]] uint64_t epoch() const { return m_epoch.load(std::memory_order_acquire); }
+
+    // Ticket for a request in the current epoch. `variant` distinguishes
+    // representations of the same resource (body format, content coding).
+    [[nodiscard]] s_ticket ticket(const s_http_request& request, std::string_view variant) const;
+
+    // The stored response for a ticket, or null if there is none in its
+    // epoch or it is older than MAX_AGE. Counts a miss; the caller counts
+    // how it answered from an entry (record_hit or record_not_modified), so
+    // each request lands in exactly one result.
+    [[nodiscard]] entry_ptr find(const s_ticket& ticket);
+
+    // Keep a finished response (body serialized and encoded, not streamed).
+    // Ignored if the epoch has moved on since the ticket was taken or the
+    // body is over MAX_ENTRY_BYTES.
+    void store(const s_ticket& ticket, s_http_response response);
+
+    // Count a request answered with a stored response
+    void record_hit() { m_hits.fetch_add(1, std::memory_order_relaxed); }
+
+    // Count a conditional request answered with 304
+    void record_not_modified() { m_not_modified.fetch_add(1, std::memory_order_relaxed); }
+
+    // True if an If-None-Match value lists `etag` (weak comparison) or is "*"
+    [[nodiscard]] static bool matches(std::string_view if_none_match, std::string_view etag);
+
+    // Hits, misses, 304s and current size
+    void write_metrics(c_prometheus_writer& out) const;
+
+private:
+    struct s_entry_slot {
+        entry_ptr response;
+        std::chrono::steady_clock::time_point stored;
+    };
+
+    std::function<bool()> m_condition;
+    const uint64_t m_instance;
+    std::atomic<uint64_t> m_epoch{1};
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, s_entry_slot> m_entries; // all from m_entries_epoch
+    uint64_t m_entries_epoch = 0;
+    size_t m_bytes = 0;
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_not_modified{0};
+
+    // Drop the entries if they are from an older epoch
+    void retire_locked(uint64_t epoch);
+};
@@ -0,0 +1,300 @@
+#include "http/c_websocket.h"
+
+#include <array>
+#include <cstring>
+
+namespace {
+
+// RFC 6455 section 1.3: appended to the client key before hashing
+constexpr std::string_view HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+// SHA-1 (FIPS 180-4). Only the handshake uses it, on a ~60 byte input.
+std::array<uint8_t, 20> sha1(std::string_view data) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    std::string message(data);
+    const uint64_t bit_length = static_cast<uint64_t>(data.size()) * 8;
+    message += static_cast<char>(0x80);
+    while (message.size() % 64 != 56) {
+        message += '\0';
+    }
+    for (int i = 7; i >= 0; --i) {
+        message += static_cast<char>((bit_length >> (i * 8)) & 0xFF);
+    }
+
+    auto rotl = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+
+    for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const uint8_t*>(message.data() + chunk + i * 4);
+            w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+
+            uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest{};
+    for (int i = 0; i < 5; ++i) {
+        digest[i * 4 + 0] = static_cast<uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+    return digest;
+}
+
+std::string base64_encode(const uint8_t* data, size_t size) {
+    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t n = uint32_t(data[i]) << 16;
+        if (i + 1 < size) n |= uint32_t(data[i + 1]) << 8;
+        if (i + 2 < size) n |= uint32_t(data[i + 2]);
+
+        out += alphabet[(n >> 18) & 0x3F];
+        out += alphabet[(n >> 12) & 0x3F];
+        out += (i + 1 < size) ? alphabet[(n >> 6) & 0x3F] : '=';
+        out += (i + 2 < size) ? alphabet[n & 0x3F] : '=';
+    }
+    return out;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != b[i]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+c_websocket_session::c_websocket_session(std::shared_ptr<c_io_channel> channel)
+    : m_channel(std::move(channel)) {
+}
+
+bool c_websocket_session::send_text(std::string message) {
+    return send_frame(op_text, std::move(message));
+}
+
+void c_websocket_session::ping() {
+    send_frame(op_ping, {});
+}
+
+void c_websocket_session::close(uint16_t code, std::string_view reason) {
+    if (m_closing.exchange(true)) {
+        return;
+    }
+
+    std::string payload;
+    payload += static_cast<char>(code >> 8);
+    payload += static_cast<char>(code & 0xFF);
+    payload.append(reason.substr(0, 123)); // control frames carry at most 125 bytes
+
+    auto header = frame_header(op_close, payload.size());
+    m_channel->send(std::move(header), std::move(payload));
+    m_channel->close_after_send();
+}
+
+void c_websocket_session::closed() {
+    if (m_closed.exchange(true)) {
+        return;
+    }
+    m_closing.store(true);
+    if (on_close) {
+        on_close();
+    }
+}
+
+bool c_websocket_session::send_frame(e_opcode opcode, std::string payload) {
+    if (m_closing.load()) {
+        return false;
+    }
+
+    // Events are pushed regardless of whether the client keeps up; drop a
+    // reader that has fallen this far behind rather than queue without bound
+    if (m_channel->pending_bytes() > MAX_PENDING_BYTES) {
+        m_closing.store(true);
+        m_channel->close();
+        return false;
+    }
+
+    // Build the header first: argument evaluation order is unspecified
+    auto header = frame_header(opcode, payload.size());
+    return m_channel->send(std::move(header), std::move(payload));
+}
+
+std::string c_websocket_session::frame_header(e_opcode opcode, size_t payload_size) {
+    std::string header;
+    header += static_cast<char>(0x80 | opcode); // FIN: messages are never fragmented
+
+    if (payload_size < 126) {
+        header += static_cast<char>(payload_size);
+    } else if (payload_size <= 0xFFFF) {
+        header += static_cast<char>(126);
+        header += static_cast<char>((payload_size >> 8) & 0xFF);
+        header += static_cast<char>(payload_size & 0xFF);
+    } else {
+        header += static_cast<char>(127);
+        for (int i = 7; i >= 0; --i) {
+            header += static_cast<char>((static_cast<uint64_t>(payload_size) >> (i * 8)) & 0xFF);
+        }
+    }
+    return header;
+}
+
+bool c_websocket_session::feed(std::string& buffer) {
+    size_t pos = 0;
+    bool keep_open = true;
+
+    while (keep_open && buffer.size() - pos >= 2) {
+        const auto* p = reinterpret_cast<const uint8_t*>(buffer.data() + pos);
+        const bool fin = (p[0] & 0x80) != 0;
+        const auto opcode = static_cast<e_opcode>(p[0] & 0x0F);
+        const bool masked = (p[1] & 0x80) != 0;
+        uint64_t length = p[1] & 0x7F;
+
+        // No extensions are negotiated, and clients must mask (RFC 6455 5.1)
+        if ((p[0] & 0x70) != 0 || !masked) {
+            close(1002, "Protocol error");
+            return false;
+        }
+
+        size_t header_size = 2;
+        if (length == 126) {
+            header_size = 4;
+        } else if (length == 127) {
+            header_size = 10;
+        }
+        if (buffer.size() - pos < header_size + 4) {
+            break;
+        }
+        if (length == 126) {
+            length = (uint64_t(p[2]) << 8) | p[3];
+        } else if (length == 127) {
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | p[2 + i];
+            }
+        }
+
+        const bool control = (opcode & 0x8) != 0;
+        if (control && (!fin || length > 125)) {
+            close(1002, "Protocol error");
+            return false;
+        }
+        if (length > MAX_MESSAGE_SIZE || m_fragments.size() + length > MAX_MESSAGE_SIZE) {
+            close(1009, "Message too big");
+            return false;
+        }
+        if (buffer.size() - pos < header_size + 4 + length) {
+            break;
+        }
+
+        const uint8_t* mask = p + header_size;
+        std::string payload(buffer, pos + header_size + 4, static_cast<size_t>(length));
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+        }
+        pos += header_size + 4 + static_cast<size_t>(length);
+
+        switch (opcode) {
+            case op_close: {
+                // Echo the status code, then close
+                uint16_t code = 1000;
+                if (payload.size() >= 2) {
+                    code = static_cast<uint16_t>((uint8_t(payload[0]) << 8) | uint8_t(payload[1]));
+                }
+                close(code);
+                keep_open = false;
+                break;
+            }
+            case op_ping:
+                send_frame(op_pong, std::move(payload));
+                break;
+            case op_pong:
+                break;
+            case op_text:
+            case op_binary:
+            case op_continuation:
+                if ((opcode == op_continuation) != m_in_message) {
+                    close(1002, "Unexpected continuation frame");
+                    return false;
+                }
+                m_fragments += payload;
+                m_in_message = !fin;
+                if (fin) {
+                    if (on_message) {
+                        on_message(m_fragments);
+                    }
+                    m_fragments.clear();
+                }
+                break;
+            default:
+                close(1002, "Unknown opcode");
+                return false;
+        }
+    }
+
+    buffer.erase(0, pos);
+    return keep_open;
+}
+
+bool c_websocket_session::is_upgrade_request(std::string_view upgrade_header) {
+    return iequals(upgrade_header, "websocket");
+}
+
+bool c_websocket_session::has_upgrade_token(std::string_view connection_header) {
+    // A comma-separated list of options, e.g. "keep-alive, Upgrade"
+    while (!connection_header.empty()) {
+        auto comma = connection_header.find(',');
+        auto option = connection_header.substr(0, comma);
+        while (!option.empty() && (option.front() == ' ' || option.front() == '\t')) option.remove_prefix(1);
+        while (!option.empty() && (option.back() == ' ' || option.back() == '\t')) option.remove_suffix(1);
+        if (iequals(option, "upgrade")) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        connection_header.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+std::string c_websocket_session::accept_key(std::string_view client_key) {
+    std::string input(client_key);
+    input.append(HANDSHAKE_GUID);
+    auto digest = sha1(input);
+    return base64_encode(digest.data(), digest.size());
+}
+
+std::string c_websocket_session::handshake_response(std::string_view client_key) {
+    return "HTTP/1.1 101 Switching Protocols\r\n"
+           "Upgrade: websocket\r\n"
+           "Connection: Upgrade\r\n"
+           "Sec-WebSocket-Accept: " + accept_key(client_key) + "\r\n\r\n";
+}
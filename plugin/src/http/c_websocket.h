@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "http/c_io_reactor.h"
+
+// Server side of one upgraded WebSocket connection (RFC 6455). Outgoing
+// messages are queued on the reactor channel, so send_text() never blocks and
+// may be called from any thread. Incoming frames are fed in by the server.
+class c_websocket_session {
+public:
+    static constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024;   // larger client messages close with 1009
+    static constexpr size_t MAX_PENDING_BYTES = 4 * 1024 * 1024; // a reader this far behind is dropped
+
+    explicit c_websocket_session(std::shared_ptr<c_io_channel> channel);
+
+    // Non-copyable, non-movable
+    c_websocket_session(const c_websocket_session&) = delete;
+    c_websocket_session& operator=(const c_websocket_session&) = delete;
+
+    // Queue a text message. Returns false once the session is closing; a
+    // client that stops reading is disconnected instead of buffering forever.
+    bool send_text(std::string message);
+
+    // Start the closing handshake and close the connection after it
+    void close(uint16_t code = 1000, std::string_view reason = {});
+
+    // Queue a ping (keep-alive probe); the client's pong counts as activity
+    void ping();
+
+    [[nodiscard]] bool is_open() const { return !m_closing.load(); }
+
+    // Set by the route handler before any frame is fed in. on_message gets
+    // complete text/binary messages (I/O thread); on_close runs once, when
+    // the connection is gone.
+    std::function<void(std::string_view message)> on_message;
+    std::function<void()> on_close;
+
+    // Consume the complete frames at the front of buffer (I/O thread, one
+    // caller at a time). Returns false when the connection should close.
+    [[nodiscard]] bool feed(std::string& buffer);
+
+    // The connection closed (server side); runs on_close once
+    void closed();
+
+    // Whether a request asks to upgrade to WebSocket
+    [[nodiscard]] static bool is_upgrade_request(std::string_view upgrade_header);
+
+    // Whether a Connection header value lists the "upgrade" option, as a
+    // handshake must (RFC 6455 section 4.2.1)
+    [[nodiscard]] static bool has_upgrade_token(std::string_view connection_header);
+
+    // Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key
+    [[nodiscard]] static std::string accept_key(std::string_view client_key);
+
+    // The 101 Switching Protocols head completing the handshake
+    [[nodiscard]] static std::string handshake_response(std::string_view client_key);
+
+private:
+    enum e_opcode : uint8_t {
+        op_continuation = 0x0,
+        op_text = 0x1,
+        op_binary = 0x2,
+        op_close = 0x8,
+        op_ping = 0x9,
+        op_pong = 0xA
+    };
+
+    std::shared_ptr<c_io_channel> m_channel;
+    std::atomic<bool> m_closing{false};
+    std::atomic<bool> m_closed{false};
+    std::string m_fragments;       // data frames of a message still being received
+    bool m_in_message = false;
+
+    bool send_frame(e_opcode opcode, std::string payload);
+
+    // Frame header for a server-to-client (unmasked) frame
+    [[nodiscard]] static std::string frame_header(e_opcode opcode, size_t payload_size);
+};
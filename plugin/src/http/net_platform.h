@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+
+// Thin portability layer over Winsock2 and BSD sockets, so the HTTP stack
+// (server, reactor, router) can also be built and load-tested on Linux.
+#ifdef _WIN32
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mstcpip.h>
+#include <afunix.h>
+
+using socket_t = SOCKET;
+
+#else
+
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using socket_t = int;
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (-1)
+#endif
+#ifndef SOCKET_ERROR
+#define SOCKET_ERROR (-1)
+#endif
+
+#endif
+
+namespace net {
+
+// Initialize the socket library (WSAStartup on Windows). Returns an error
+// string on failure, empty on success.
+[[nodiscard]] inline std::string startup() {
+#ifdef _WIN32
+    WSADATA wsa_data{};
+    auto wsa_result = WSAStartup(MAKEWORD(2, 2), &wsa_data);
+    if (wsa_result != 0) {
+        return "WSAStartup failed with error: " + std::to_string(wsa_result);
+    }
+#endif
+    return {};
+}
+
+inline void cleanup() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+[[nodiscard]] inline int last_error() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+// True if the error code means "try again later" on a non-blocking socket
+[[nodiscard]] inline bool would_block(int err) {
+#ifdef _WIN32
+    return err == WSAEWOULDBLOCK;
+#else
+    return err == EAGAIN || err == EWOULDBLOCK || err == EINTR;
+#endif
+}
+
+inline void close_socket(socket_t sock) {
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+// Stop sending (graceful close: the peer sees EOF after queued data)
+inline void shutdown_send(socket_t sock) {
+#ifdef _WIN32
+    shutdown(sock, SD_SEND);
+#else
+    shutdown(sock, SHUT_WR);
+#endif
+}
+
+// Stop both directions. Also wakes a thread blocked in accept() on Linux.
+inline void shutdown_both(socket_t sock) {
+#ifdef _WIN32
+    shutdown(sock, SD_BOTH);
+#else
+    shutdown(sock, SHUT_RDWR);
+#endif
+}
+
+[[nodiscard]] inline bool set_non_blocking(socket_t sock) {
+#ifdef _WIN32
+    u_long mode = 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    return flags >= 0 && fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+inline void set_option(socket_t sock, int level, int name, int value) {
+    setsockopt(sock, level, name, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Fill in an AF_UNIX address. False if the path is empty or too long.
+[[nodiscard]] inline bool make_unix_address(const std::string& path, sockaddr_un& addr) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Delete a socket file left by a listener. Anything else at the path (a
+// mistyped setting pointing at a real file) is left alone.
+inline void remove_socket_file(const std::string& path) {
+#ifdef _WIN32
+    // AF_UNIX socket files are reparse points
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+        DeleteFileA(path.c_str());
+    }
+#else
+    struct stat info{};
+    if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(path.c_str());
+    }
+#endif
+}
+
+// Let only the current user connect to a socket file. On Windows the file
+// inherits the directory's ACL instead.
+inline void restrict_to_owner(const std::string& path) {
+#ifndef _WIN32
+    chmod(path.c_str(), S_IRUSR | S_IWUSR);
+#else
+    (void)path;
+#endif
+}
+
+} // namespace net
@@ -0,0 +1,184 @@
+#include "http/s_http_request.h"
+
+#include <algorithm>
+#include <cctype>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool needs_decoding(std::string_view s) {
+    return s.find_first_of("%+") != std::string_view::npos;
+}
+
+// Append the URL-decoded form of `encoded` to `out`
+void url_decode_into(std::string_view encoded, std::string& out) {
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size()) {
+            int hi = hex_value(encoded[i + 1]);
+            int lo = hex_value(encoded[i + 2]);
+            if (hi >= 0 && lo >= 0) {
+                out += static_cast<char>((hi << 4) | lo);
+                i += 2;
+            } else {
+                // Malformed escape: keep the '%' literally instead of throwing.
+                out += encoded[i];
+            }
+        } else if (encoded[i] == '+') {
+            out += ' ';
+        } else {
+            out += encoded[i];
+        }
+    }
+}
+
+// Percent-encode one query component
+void append_query_component(std::string& out, std::string_view text) {
+    static constexpr char hex[] = "0123456789ABCDEF";
+    for (unsigned char c : text) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 0xF];
+        }
+    }
+}
+
+// "query" may be a ready-made query string or an object of parameters
+std::string build_query(const nlohmann::json& query) {
+    if (query.is_string()) {
+        return query.get<std::string>();
+    }
+
+    std::string out;
+    for (const auto& [key, value] : query.items()) {
+        if (!out.empty()) {
+            out += '&';
+        }
+        append_query_component(out, key);
+        out += '=';
+        append_query_component(out, value.is_string() ? value.get<std::string>() : value.dump());
+    }
+    return out;
+}
+
+} // namespace
+
+std::expected<s_http_request, std::string> s_http_request::from_spec(const nlohmann::json& spec) {
+    if (!spec.is_object() || !spec.contains("path") || !spec["path"].is_string()) {
+        return std::unexpected("Each request needs a 'path' string");
+    }
+
+    std::string method = spec.value("method", "GET");
+    std::transform(method.begin(), method.end(), method.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    std::string path = spec["path"].get<std::string>();
+    std::string query;
+    if (auto mark = path.find('?'); mark != std::string::npos) {
+        query = path.substr(mark + 1);
+        path.resize(mark);
+    }
+    if (spec.contains("query")) {
+        if (!spec["query"].is_string() && !spec["query"].is_object()) {
+            return std::unexpected("'query' must be a string or an object");
+        }
+        if (!query.empty()) {
+            query += '&';
+        }
+        query += build_query(spec["query"]);
+    }
+
+    std::string body;
+    if (spec.contains("body")) {
+        body = spec["body"].is_string() ? spec["body"].get<std::string>() : spec["body"].dump();
+    }
+
+    // No headers: the outer request was authenticated, and headers such as
+    // Range or Accept would not mean the same thing here
+    s_http_request request;
+    request.raw = std::make_shared<const std::string>(method + path + query + body);
+    std::string_view all = *request.raw;
+    request.method = all.substr(0, method.size());
+    request.path = all.substr(method.size(), path.size());
+    request.query_string = all.substr(method.size() + path.size(), query.size());
+    request.body = all.substr(method.size() + path.size() + query.size());
+    request.version = "HTTP/1.1";
+    return request;
+}
+
+std::string_view s_http_request::get_header(std::string_view key, std::string_view default_value) const {
+    for (const auto& [name, value] : headers) {
+        if (name.size() != key.size()) continue;
+
+        bool match = true;
+        for (size_t i = 0; i < name.size() && match; ++i) {
+            char c = name[i];
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            match = (c == key[i]);
+        }
+        if (match) return value;
+    }
+    return default_value;
+}
+
+const s_http_request::view_pairs& s_http_request::query_pairs() const {
+    if (m_query) {
+        return m_query->pairs;
+    }
+
+    auto index = std::make_shared<s_query_index>();
+
+    // Decoding never grows a component, so reserving the whole query string
+    // up front keeps views into `decoded` stable while it is filled.
+    if (needs_decoding(query_string)) {
+        index->decoded.reserve(query_string.size());
+    }
+
+    // Components without escapes point straight into the request
+    auto component = [&](std::string_view s) -> std::string_view {
+        if (!needs_decoding(s)) {
+            return s;
+        }
+        auto start = index->decoded.size();
+        url_decode_into(s, index->decoded);
+        return std::string_view(index->decoded).substr(start);
+    };
+
+    std::string_view rest = query_string;
+    while (!rest.empty()) {
+        auto amp = rest.find('&');
+        auto pair = rest.substr(0, amp);
+        rest = (amp == std::string_view::npos) ? std::string_view{} : rest.substr(amp + 1);
+        if (pair.empty()) continue;
+
+        auto eq = pair.find('=');
+        auto key = component(pair.substr(0, eq));
+        auto value = (eq == std::string_view::npos) ? std::string_view{} : component(pair.substr(eq + 1));
+
+        // A repeated key keeps its last value
+        bool replaced = false;
+        for (auto& [k, v] : index->pairs) {
+            if (k == key) {
+                v = value;
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) {
+            index->pairs.emplace_back(key, value);
+        }
+    }
+
+    m_query = std::move(index);
+    return m_query->pairs;
+}
@@ -1,25 +1,79 @@
 #pragma once
 
+#include <expected>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
 
+#include "util/c_cancel_token.h"
+
+// A parsed request. The fields are views into `raw`, the owned copy of the
+// request bytes, so parsing copies nothing and copies of a request share it.
+// Hand-built requests (no `raw`) may point the views at any storage that
+// outlives them, e.g. string literals.
 struct s_http_request {
-    std::string method;                                     // "GET", "POST", etc.
-    std::string path;                                       // "/api/debug/state"
-    std::string query_string;                               // "address=0x401000&size=64"
-    std::unordered_map<std::string, std::string> query;     // Parsed query parameters
-    std::unordered_map<std::string, std::string> headers;   // Request headers (lowercased keys)
-    std::string body;                                       // Raw request body
-
-    // Get a query parameter with a default value
-    [[nodiscard]] std::string get_query(const std::string& key, const std::string& default_value = "") const {
-        auto it = query.find(key);
-        return (it != query.end()) ? it->second : default_value;
+    using view_pairs = std::vector<std::pair<std::string_view, std::string_view>>;
+
+    std::shared_ptr<const std::string> raw;                 // Request bytes the views point into
+    std::string_view method;                                // "GET", "POST", etc.
+    std::string_view path;                                  // "/api/debug/state"
+    std::string_view version;                               // "HTTP/1.1"
+    std::string_view query_string;                          // "address=0x401000&size=64" (still encoded)
+    view_pairs headers;                                     // Request headers, as received
+    view_pairs params;                                      // Path parameters ("/api/threads/{id}" -> id)
+    std::string_view body;                                  // Raw request body
+
+    // Stop signal for long-running handlers: set by the server when the
+    // client sent X-Deadline-Ms or X-Request-Id (for /api/cancel), and by
+    // jobs. Null when nothing can stop the request.
+    std::shared_ptr<c_cancel_token> cancel;
+
+    // Why the handler should wrap up now (cancelled, deadline passed), or none
+    [[nodiscard]] c_cancel_token::e_reason stop_reason() const {
+        return cancel ? cancel->reason() : c_cancel_token::e_reason::none;
     }
 
-    // Get a header value (key must be lowercase)
-    [[nodiscard]] std::string get_header(const std::string& key, const std::string& default_value = "") const {
-        auto it = headers.find(key);
-        return (it != headers.end()) ? it->second : default_value;
+    // Get a query parameter with a default value. The query string is split
+    // and decoded on first use; lookups do not allocate.
+    [[nodiscard]] std::string_view get_query(std::string_view key, std::string_view default_value = "") const {
+        return find(query_pairs(), key, default_value);
+    }
+
+    // Get a path parameter captured by a templated route
+    [[nodiscard]] std::string_view get_param(std::string_view key, std::string_view default_value = "") const {
+        return find(params, key, default_value);
+    }
+
+    // Get a header value (key must be lowercase; names match case-insensitively)
+    [[nodiscard]] std::string_view get_header(std::string_view key, std::string_view default_value = "") const;
+
+    // Build a request from a JSON description, for routes that run other
+    // routes (/api/batch, /api/shm/fetch):
+    //   {"method":"GET", "path":"/api/..", "query":"a=1" or {"a":1}, "body":".." or {..}}
+    // The result owns its bytes and carries no headers.
+    [[nodiscard]] static std::expected<s_http_request, std::string> from_spec(const nlohmann::json& spec);
+
+private:
+    struct s_query_index {
+        std::string decoded;  // storage for components that needed %-decoding
+        view_pairs pairs;
+    };
+
+    // Shared so copies of the request keep pointing at valid storage.
+    // Built lazily; a request is handled by one thread at a time.
+    mutable std::shared_ptr<const s_query_index> m_query;
+
+    [[nodiscard]] const view_pairs& query_pairs() const;
+
+    [[nodiscard]] static std::string_view find(
+        const view_pairs& pairs, std::string_view key, std::string_view default_value
+    ) {
+        for (const auto& [k, v] : pairs) {
+            if (k == key) return v;
+        }
+        return default_value;
     }
 };
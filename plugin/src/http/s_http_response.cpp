@@ -0,0 +1,209 @@
+#include "http/s_http_response.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+namespace {
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Members whose values handlers write with format_address(): addresses,
+// registers and other address-sized fields. Only these are converted; a
+// string that merely looks like an address (a string search hit, a label or
+// comment, user text) stays a string. Array elements go by the array's name.
+constexpr std::array<std::string_view, 86> ADDRESS_KEYS = {
+    "address", "address_of_entry_point", "allocation_base", "base", "brfalse", "brtrue",
+    "characteristics", "cip", "destination", "dr0", "dr1", "dr2", "dr3", "dr6", "dr7",
+    "e_lfanew", "eax", "ebp", "ebx", "ecx", "edi", "edx", "eflags", "eip", "end", "entry",
+    "entry_point", "esi", "esp", "exits", "file_offset", "first_match", "flags", "from",
+    "granted_access", "handle", "handler", "hash", "iat", "image_base", "local_base", "machine",
+    "magic", "matches", "nt_global_flag", "parent", "peb", "peb_address", "process_handle",
+    "process_heap", "r10", "r11", "r12", "r13", "r14", "r15", "r8", "r9", "raw_offset", "rax",
+    "rbp", "rbx", "rcx", "rdi", "rdx", "return_address", "rip", "rsi", "rsp", "rva",
+    "seh_frame", "source", "stack_base", "stack_limit", "stack_pointer", "start",
+    "start_address", "style", "style_ex", "target", "teb", "teb_address", "to", "va",
+    "virtual_address", "wnd_proc",
+};
+static_assert(std::ranges::is_sorted(ADDRESS_KEYS));
+
+bool is_address_key(std::string_view key) {
+    return std::ranges::binary_search(ADDRESS_KEYS, key);
+}
+
+// format_address() output: "0x" followed by 8 (x32) or 16 (x64) hex digits
+bool parse_formatted_address(const std::string& text, uint64_t& value) {
+    if ((text.size() != 10 && text.size() != 18) || text[0] != '0' || text[1] != 'x') {
+        return false;
+    }
+
+    uint64_t result = 0;
+    for (size_t i = 2; i < text.size(); ++i) {
+        int digit = hex_value(text[i]);
+        if (digit < 0) return false;
+        result = (result << 4) | static_cast<uint64_t>(digit);
+    }
+    value = result;
+    return true;
+}
+
+void addresses_to_integers(nlohmann::json& node, bool address_member = false) {
+    if (node.is_object()) {
+        for (auto& [key, child] : node.items()) {
+            addresses_to_integers(child, is_address_key(key));
+        }
+        return;
+    }
+    if (node.is_array()) {
+        for (auto& child : node) {
+            addresses_to_integers(child, address_member);
+        }
+        return;
+    }
+
+    uint64_t value = 0;
+    if (address_member && node.is_string() &&
+        parse_formatted_address(node.get_ref<const std::string&>(), value)) {
+        node = value;
+    }
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != b[i]) return false;
+    }
+    return true;
+}
+
+// The q parameter of a media range (1 when absent or unparsable)
+double quality(std::string_view params) {
+    while (!params.empty()) {
+        auto semi = params.find(';');
+        auto param = trim(params.substr(0, semi));
+        params = (semi == std::string_view::npos) ? std::string_view{} : params.substr(semi + 1);
+
+        if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+            double q = 1.0;
+            auto value = param.substr(2);
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), q);
+            return (ec == std::errc()) ? q : 1.0;
+        }
+    }
+    return 1.0;
+}
+
+} // namespace
+
+void s_http_response::serialize(e_body_format format) {
+    if (envelope_in_body && format != e_body_format::json) {
+        // Rare: clients asking for CBOR/MessagePack pay for the DOM after all
+        document = nlohmann::json::parse(body);
+        envelope_in_body = false;
+    }
+    if (!document) {
+        return;
+    }
+
+    switch (format) {
+        case e_body_format::cbor: {
+            addresses_to_integers(*document);
+            body.clear();
+            nlohmann::json::to_cbor(*document, nlohmann::detail::output_adapter<char>(body));
+            content_type = "application/cbor";
+            headers.emplace_back("Vary", "Accept");
+            break;
+        }
+        case e_body_format::msgpack: {
+            addresses_to_integers(*document);
+            body.clear();
+            nlohmann::json::to_msgpack(*document, nlohmann::detail::output_adapter<char>(body));
+            content_type = "application/msgpack";
+            headers.emplace_back("Vary", "Accept");
+            break;
+        }
+        default:
+            // Handlers pass raw debuggee bytes through (e.g. ASCII string
+            // search hits); write them as U+FFFD rather than throw
+            body = document->dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+            content_type = "application/json";
+            break;
+    }
+    document.reset();
+}
+
+e_body_format s_http_response::negotiate_format(std::string_view accept) {
+    // Highest q wins; on a tie the earlier entry does. JSON (including
+    // wildcards) is the fallback.
+    e_body_format best = e_body_format::json;
+    double best_q = -1.0;
+
+    while (!accept.empty()) {
+        auto comma = accept.find(',');
+        auto item = accept.substr(0, comma);
+        accept = (comma == std::string_view::npos) ? std::string_view{} : accept.substr(comma + 1);
+
+        auto semi = item.find(';');
+        auto type = trim(item.substr(0, semi));
+        double q = (semi == std::string_view::npos) ? 1.0 : quality(item.substr(semi + 1));
+
+        e_body_format format;
+        if (iequals(type, "application/cbor")) {
+            format = e_body_format::cbor;
+        } else if (iequals(type, "application/msgpack") || iequals(type, "application/x-msgpack") ||
+                   iequals(type, "application/vnd.msgpack")) {
+            format = e_body_format::msgpack;
+        } else if (iequals(type, "application/json") || type == "application/*" || type == "*/*") {
+            format = e_body_format::json;
+        } else {
+            continue;
+        }
+
+        if (q > 0.0 && q > best_q) {
+            best = format;
+            best_q = q;
+        }
+    }
+    return best;
+}
+
+nlohmann::json s_http_response::to_envelope(s_http_response response) {
+    if (response.document) {
+        return std::move(*response.document);
+    }
+
+    // Checked before collecting a stream: an event stream never ends
+    if (response.content_type != "application/json") {
+        return *error(406, "Response of type " + response.content_type + " cannot be embedded").document;
+    }
+
+    if (response.body_stream) {
+        std::string body;
+        response.body_stream([&body](std::string piece) {
+            body += piece;
+            return true;
+        });
+        response.body = std::move(body);
+    }
+
+    auto parsed = nlohmann::json::parse(response.body, nullptr, false);
+    if (parsed.is_discarded()) {
+        return *internal_error("Response is not valid JSON").document;
+    }
+    return parsed;
+}
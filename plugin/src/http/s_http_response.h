@@ -1,33 +1,104 @@
 #pragma once
 
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+// Receives one piece of a streamed body. Returns false once the client is
+// gone; the producer should stop writing then. An empty piece sends nothing
+// and only checks that, for producers that wait between writes.
+using body_writer_t = std::function<bool(std::string piece)>;
+
+// Produces a streamed body by calling the writer repeatedly
+using body_producer_t = std::function<void(const body_writer_t& write)>;
+
+// Wire formats for the JSON envelope, chosen by the request's Accept header
+enum class e_body_format {
+    json,
+    cbor,       // application/cbor (RFC 8949)
+    msgpack     // application/msgpack
+};
+
 struct s_http_response {
     int status_code = 200;
     std::string content_type = "application/json";
     std::string body;
+    std::vector<std::pair<std::string, std::string>> headers; // extra response headers
+
+    // Streamed body (replaces `body` when set). The server sends the head, then
+    // runs the producer on the worker thread, pacing it to the socket so large
+    // payloads never exist in memory all at once. With a stream_length the
+    // producer must write exactly that many bytes; without one the body is
+    // sent with Transfer-Encoding: chunked.
+    body_producer_t body_stream;
+    std::optional<size_t> stream_length;
+
+    // Finished body shared with a response cache entry (replaces `body` when
+    // set). Sent as is, without being copied, encoded or serialized again.
+    std::shared_ptr<const std::string> shared_body;
+
+    // Envelope built by ok()/error(). The server serializes it into `body`
+    // once it knows which format the client accepts (see serialize()).
+    std::optional<nlohmann::json> document;
+
+    // `body` already holds a JSON envelope (see c_json_envelope). Sent as is
+    // to JSON clients; serialize() only parses it back for the binary formats.
+    bool envelope_in_body = false;
 
     // Build a success response with data payload
-    static s_http_response ok(const nlohmann::json& data) {
-        nlohmann::json envelope = {
+    static s_http_response ok(nlohmann::json data) {
+        s_http_response resp;
+        resp.document = nlohmann::json{
             {"success", true},
-            {"data", data}
+            {"data", std::move(data)}
         };
-        return {200, "application/json", envelope.dump()};
+        return resp;
     }
 
     // Build an error response
     static s_http_response error(int code, const std::string& message) {
-        nlohmann::json envelope = {
+        s_http_response resp;
+        resp.status_code = code;
+        resp.document = nlohmann::json{
             {"success", false},
             {"error", {
                 {"code", code},
                 {"message", message}
             }}
         };
-        return {code, "application/json", envelope.dump()};
+        return resp;
+    }
+
+    // Write `document` into `body` in the given format; no-op without one
+    // (or, for an envelope_in_body, when the format is JSON). The binary
+    // formats carry the format_address() strings ("0x" + 8 or 16 hex digits)
+    // of known address members ("address", "base", registers, ...) as
+    // unsigned integers; other strings are left alone.
+    void serialize(e_body_format format);
+
+    // The response's JSON envelope, for embedding in another response (batch
+    // entries, job results). Streamed bodies are collected; anything that is
+    // not JSON (e.g. format=raw memory) becomes an error envelope.
+    [[nodiscard]] static nlohmann::json to_envelope(s_http_response response);
+
+    // Pick the envelope format from an Accept header value: CBOR or
+    // MessagePack when the client prefers one, JSON otherwise
+    [[nodiscard]] static e_body_format negotiate_format(std::string_view accept);
+
+    // 304 Not Modified: the client's copy (named by If-None-Match) is current.
+    // Carries no body.
+    static s_http_response not_modified(std::string etag) {
+        s_http_response resp;
+        resp.status_code = 304;
+        resp.headers.emplace_back("ETag", std::move(etag));
+        return resp;
     }
 
     // 400 Bad Request
@@ -55,32 +126,128 @@ struct s_http_response {
         return error(500, message);
     }
 
-    // Serialize to HTTP response string
-    [[nodiscard]] std::string serialize() const {
-        std::ostringstream oss;
-        oss << "HTTP/1.1 " << status_code << " " << status_text() << "\r\n";
-        oss << "Content-Type: " << content_type << "\r\n";
-        oss << "Content-Length: " << body.size() << "\r\n";
-        oss << "Connection: close\r\n";
+    // 503 Service Unavailable (server saturated); tells the client when to retry
+    static s_http_response service_unavailable(const std::string& message, int retry_after_s = 1) {
+        auto resp = error(503, message);
+        resp.headers.emplace_back("Retry-After", std::to_string(retry_after_s));
+        return resp;
+    }
+
+    // 200 with an opaque binary body
+    static s_http_response binary(std::string data, std::string type = "application/octet-stream") {
+        s_http_response resp;
+        resp.content_type = std::move(type);
+        resp.body = std::move(data);
+        return resp;
+    }
+
+    // 200 with a plain-text body (e.g. the Prometheus exposition)
+    static s_http_response text(std::string data, std::string type = "text/plain; charset=utf-8") {
+        s_http_response resp;
+        resp.content_type = std::move(type);
+        resp.body = std::move(data);
+        return resp;
+    }
+
+    // 200 with a body produced incrementally (see body_stream)
+    static s_http_response stream(size_t length, body_producer_t producer,
+                                  std::string type = "application/json") {
+        s_http_response resp;
+        resp.content_type = std::move(type);
+        resp.body_stream = std::move(producer);
+        resp.stream_length = length;
+        return resp;
+    }
+
+    // 200 with a body of unknown length, sent chunked as the producer writes it
+    static s_http_response chunked(body_producer_t producer, std::string type = "application/json") {
+        s_http_response resp;
+        resp.content_type = std::move(type);
+        resp.body_stream = std::move(producer);
+        return resp;
+    }
+
+    // Serialize the status line and headers. The body is sent separately (in
+    // the same gathered write), so it is never copied into the head. keep_alive
+    // selects the Connection header; the server decides it per request.
+    [[nodiscard]] std::string head(bool keep_alive = false) const {
+        s_head_builder out;
+        char number[24];
+
+        out.append("HTTP/1.1 ");
+        out.append(std::string_view(number, std::to_chars(number, number + sizeof(number), status_code).ptr - number));
+        out.append(" ");
+        out.append(status_text());
+        out.append("\r\nContent-Type: ");
+        out.append(content_type);
+        if (status_code == 304) {
+            // No body, and no framing for one
+        } else if (body_stream && !stream_length) {
+            out.append("\r\nTransfer-Encoding: chunked");
+        } else {
+            out.append("\r\nContent-Length: ");
+            size_t length = body_stream ? *stream_length : shared_body ? shared_body->size() : body.size();
+            out.append(std::string_view(number, std::to_chars(number, number + sizeof(number), length).ptr - number));
+        }
+        out.append(keep_alive ? "\r\nConnection: keep-alive\r\n" : "\r\nConnection: close\r\n");
+        for (const auto& [name, value] : headers) {
+            out.append(name);
+            out.append(": ");
+            out.append(value);
+            out.append("\r\n");
+        }
         // No permissive CORS: this is a localhost-only API consumed by the Node
         // MCP server (which is not subject to CORS). Emitting "Allow-Origin: *"
         // would let any web page in a local browser drive the debugger, so we
         // deliberately send no Access-Control-Allow-* headers.
-        oss << "\r\n";
-        oss << body;
-        return oss.str();
+        out.append("\r\n");
+        return out.take();
     }
 
 private:
-    [[nodiscard]] std::string status_text() const {
+    // Formats into a stack buffer; spills to the heap only for unusually
+    // large header sets.
+    struct s_head_builder {
+        char stack[512];
+        size_t size = 0;
+        std::string spill;
+
+        void append(std::string_view text) {
+            if (spill.empty() && size + text.size() <= sizeof(stack)) {
+                std::memcpy(stack + size, text.data(), text.size());
+                size += text.size();
+                return;
+            }
+            if (spill.empty()) {
+                spill.assign(stack, size);
+            }
+            spill.append(text);
+        }
+
+        [[nodiscard]] std::string take() {
+            return spill.empty() ? std::string(stack, size) : std::move(spill);
+        }
+    };
+
+    [[nodiscard]] std::string_view status_text() const {
         switch (status_code) {
             case 200: return "OK";
+            case 202: return "Accepted";
+            case 206: return "Partial Content";
+            case 304: return "Not Modified";
             case 400: return "Bad Request";
             case 401: return "Unauthorized";
             case 404: return "Not Found";
             case 405: return "Method Not Allowed";
+            case 406: return "Not Acceptable";
             case 409: return "Conflict";
+            case 411: return "Length Required";
+            case 413: return "Content Too Large";
+            case 416: return "Range Not Satisfiable";
+            case 424: return "Failed Dependency";
+            case 426: return "Upgrade Required";
             case 500: return "Internal Server Error";
+            case 503: return "Service Unavailable";
             default:  return "Unknown";
         }
     }
@@ -11,6 +11,9 @@
 #include "http/c_http_server.h"
 #include "http/c_http_router.h"
 #include "bridge/c_bridge_executor.h"
+#include "util/c_event_hub.h"
+#include "util/c_job_manager.h"
+#include "util/c_prometheus_writer.h"
 #include "util/format_utils.h"
 #include "util/trace_state.h"
 #include "resources/plugin_icon.h"
@@ -41,6 +44,11 @@ namespace handlers {
     void register_process_routes(c_http_router& router);
     void register_handles_routes(c_http_router& router);
     void register_controlflow_routes(c_http_router& router);
+    void register_event_routes(c_http_router& router);
+    void register_batch_routes(c_http_router& router);
+    void stop_batch_helpers();
+    void register_job_routes(c_http_router& router);
+    void register_shm_routes(c_http_router& router);
 } // namespace handlers
 
 // Globals
@@ -83,11 +91,105 @@ nlohmann::json trace_status() {
 // export name.
 static void cb_start_trace(CBTYPE, void* cb_info) {
     auto* info = static_cast<PLUG_CB_STARTTRACE*>(cb_info);
-    mcp::trace_set_active(true, (info && info->traceFilePath) ? info->traceFilePath : "");
+    std::string file = (info && info->traceFilePath) ? info->traceFilePath : "";
+    mcp::trace_set_active(true, file);
+    get_event_hub().publish("trace_started", {{"file", file}});
 }
 
 static void cb_stop_trace(CBTYPE, void*) {
     mcp::trace_set_active(false, "");
+    get_event_hub().publish("trace_stopped");
+}
+
+// ============================================================================
+// Debugger event callbacks (exported by name, see plugin.def)
+// ============================================================================
+// Each one publishes to the event hub, which pushes to /api/events/ws
+// subscribers. They run on the debugger thread: publishing only queues.
+
+static const char* breakpoint_type_name(BPXTYPE type) {
+    switch (type) {
+        case bp_normal:    return "software";
+        case bp_hardware:  return "hardware";
+        case bp_memory:    return "memory";
+        case bp_dll:       return "dll";
+        case bp_exception: return "exception";
+        default:           return "unknown";
+    }
+}
+
+// Pausing, resuming and stepping also retire every cached response: they
+// were computed from the state the debuggee just left.
+PLUG_EXPORT void CBPAUSEDEBUG(CBTYPE, void*) {
+    g_server.response_cache().invalidate();
+    get_event_hub().publish("paused", {
+        {"address", format_utils::format_address(DbgValFromString("cip"))}
+    });
+}
+
+PLUG_EXPORT void CBRESUMEDEBUG(CBTYPE, void*) {
+    g_server.response_cache().invalidate();
+    get_event_hub().publish("resumed");
+}
+
+PLUG_EXPORT void CBSTEPPED(CBTYPE, void*) {
+    g_server.response_cache().invalidate();
+}
+
+PLUG_EXPORT void CBBREAKPOINT(CBTYPE, void* cb_info) {
+    auto* info = static_cast<PLUG_CB_BREAKPOINT*>(cb_info);
+    if (!info || !info->breakpoint) {
+        return;
+    }
+
+    const auto& bp = *info->breakpoint;
+    get_event_hub().publish("breakpoint", {
+        {"address",   format_utils::format_address(bp.addr)},
+        {"type",      breakpoint_type_name(bp.type)},
+        {"name",      bp.name},
+        {"module",    bp.mod},
+        {"hit_count", bp.hitCount}
+    });
+}
+
+PLUG_EXPORT void CBEXCEPTION(CBTYPE, void* cb_info) {
+    auto* info = static_cast<PLUG_CB_EXCEPTION*>(cb_info);
+    if (!info || !info->Exception) {
+        return;
+    }
+
+    const auto& record = info->Exception->ExceptionRecord;
+    char code[16];
+    snprintf(code, sizeof(code), "0x%08X", static_cast<unsigned int>(record.ExceptionCode));
+    get_event_hub().publish("exception", {
+        {"code",        code},
+        {"address",     format_utils::format_address(reinterpret_cast<duint>(record.ExceptionAddress))},
+        {"first_chance", info->Exception->dwFirstChance != 0}
+    });
+}
+
+PLUG_EXPORT void CBLOADDLL(CBTYPE, void* cb_info) {
+    auto* info = static_cast<PLUG_CB_LOADDLL*>(cb_info);
+    if (!info || !info->LoadDll) {
+        return;
+    }
+
+    get_event_hub().publish("dll_loaded", {
+        {"name", info->modname ? info->modname : ""},
+        {"base", format_utils::format_address(reinterpret_cast<duint>(info->LoadDll->lpBaseOfDll))},
+        {"size", info->modInfo ? info->modInfo->ImageSize : 0}
+    });
+}
+
+PLUG_EXPORT void CBUNLOADDLL(CBTYPE, void* cb_info) {
+    auto* info = static_cast<PLUG_CB_UNLOADDLL*>(cb_info);
+    if (!info || !info->UnloadDll) {
+        return;
+    }
+
+    get_event_hub().publish("dll_unloaded", {
+        {"base", format_utils::format_address(reinterpret_cast<duint>(info->UnloadDll->lpBaseOfDll))}
+    });
 }
 
 // ============================================================================
@@ -97,9 +199,19 @@ static void cb_stop_trace(CBTYPE, void*) {
 // Apply current settings (incl. auth token) and start the server.
 static std::expected<void, std::string> start_server() {
     g_server.set_auth_token(g_settings.auth_token);
+    g_server.set_unix_socket_path(g_settings.unix_socket);
+    // Listings only stand still while the debuggee is paused
+    g_server.response_cache().enable([] { return get_bridge().require_paused(); });
     return g_server.start(g_settings.host, g_settings.port, &g_router);
 }
 
+// Mention the Unix socket after a "started on host:port" line
+static void log_unix_socket() {
+    if (!g_server.get_unix_socket_path().empty()) {
+        _plugin_logprintf("[MCP] Also listening on Unix socket %s\n", g_server.get_unix_socket_path().c_str());
+    }
+}
+
 // ============================================================================
 // Menu helpers
 // ============================================================================
@@ -136,6 +248,10 @@ static void load_settings() {
     if (BridgeSettingGet(SETTINGS_SECTION, SETTINGS_KEY_TOKEN, buf)) {
         strncpy_s(g_settings.auth_token, buf, _TRUNCATE);
     }
+
+    if (BridgeSettingGet(SETTINGS_SECTION, SETTINGS_KEY_UNIX_SOCKET, buf)) {
+        strncpy_s(g_settings.unix_socket, buf, _TRUNCATE);
+    }
 }
 
 static void save_settings() {
@@ -143,6 +259,7 @@ static void save_settings() {
     BridgeSettingSetUint(SETTINGS_SECTION, SETTINGS_KEY_PORT, g_settings.port);
     BridgeSettingSetUint(SETTINGS_SECTION, SETTINGS_KEY_AUTOSTART, g_settings.auto_start ? 1 : 0);
     BridgeSettingSet(SETTINGS_SECTION, SETTINGS_KEY_TOKEN, g_settings.auth_token);
+    BridgeSettingSet(SETTINGS_SECTION, SETTINGS_KEY_UNIX_SOCKET, g_settings.unix_socket);
     BridgeSettingFlush();
 }
 
@@ -153,13 +270,66 @@ static void save_settings() {
 void register_all_routes(c_http_router& router) {
     // Health check endpoint
     router.get("/api/health", [](const s_http_request&) -> s_http_response {
+        auto compression = g_server.compression_stats();
+        auto lanes = nlohmann::json::object();
+        for (const auto& lane : g_server.lane_stats()) {
+            lanes[lane.name] = {
+                {"workers",  lane.workers},
+                {"busy",     lane.busy},
+                {"queued",   lane.queued},
+                {"rejected", lane.rejected},
+                {"queue_wait_us", {
+                    {"p50", lane.queue_wait.value_at_quantile(0.5)},
+                    {"p99", lane.queue_wait.value_at_quantile(0.99)}
+                }}
+            };
+        }
         return s_http_response::ok({
             {"version", PLUGIN_VERSION_STR},
             {"plugin",  PLUGIN_NAME},
-            {"status",  "ok"}
+            {"status",  "ok"},
+            {"compression", {
+                {"responses", compression.responses},
+                {"bytes_in",  compression.bytes_in},
+                {"bytes_out", compression.bytes_out},
+                {"time_us",   compression.time_us}
+            }},
+            {"lanes", std::move(lanes)}
+        });
+    });
+
+    // Prometheus scrape endpoint: request latency per route, traffic, errors
+    router.get("/api/metrics", [](const s_http_request&) -> s_http_response {
+        c_prometheus_writer out;
+        out.family("x64dbg_mcp_plugin_info", "gauge", "Plugin version; the value is always 1.");
+        out.sample("x64dbg_mcp_plugin_info", {{"version", PLUGIN_VERSION_STR}}, uint64_t{1});
+        g_server.write_metrics(out);
+        return s_http_response::text(out.take(), "text/plain; version=0.0.4; charset=utf-8");
+    });
+
+    // Stop a running request that was sent with an X-Request-Id header.
+    // Scans wrap up at their next chunk and return what they found so far.
+    router.post("/api/cancel", [](const s_http_request& req) -> s_http_response {
+        std::string request_id{req.get_query("request_id")};
+        if (request_id.empty()) {
+            return s_http_response::bad_request("Missing 'request_id' query parameter");
+        }
+
+        auto stopped = g_server.cancel_request(request_id);
+        if (stopped == 0) {
+            return s_http_response::not_found("No running request with id " + request_id);
+        }
+        return s_http_response::ok({
+            {"request_id", request_id},
+            {"cancelled",  stopped}
         });
     });
 
+    // Served by their own small lane so they answer while scans run
+    router.assign_lane("/api/health", e_lane::control);
+    router.assign_lane("/api/metrics", e_lane::control);
+    router.assign_lane("/api/cancel", e_lane::control);
+
     // Process info endpoint
     router.get("/api/process/info", [](const s_http_request&) -> s_http_response {
         auto& bridge = get_bridge();
@@ -202,6 +372,10 @@ void register_all_routes(c_http_router& router) {
     handlers::register_process_routes(router);
     handlers::register_handles_routes(router);
     handlers::register_controlflow_routes(router);
+    handlers::register_event_routes(router);
+    handlers::register_batch_routes(router);
+    handlers::register_job_routes(router);
+    handlers::register_shm_routes(router);
 }
 
 // ============================================================================
@@ -225,6 +399,7 @@ static bool mcp_server_command(int argc, char* argv[]) {
         auto result = start_server();
         if (result.has_value()) {
             _plugin_logprintf("[MCP] Server started on %s:%u\n", g_settings.host, g_settings.port);
+            log_unix_socket();
         } else {
             _plugin_logprintf("[MCP] Failed to start server: %s\n", result.error().c_str());
         }
@@ -247,6 +422,7 @@ static bool mcp_server_command(int argc, char* argv[]) {
     if (subcommand == "status") {
         if (g_server.is_running()) {
             _plugin_logprintf("[MCP] Server is running on %s:%u\n", g_settings.host, g_server.get_port());
+            log_unix_socket();
         } else {
             _plugin_logputs("[MCP] Server is not running");
         }
@@ -294,8 +470,11 @@ PLUG_EXPORT bool plugstop() {
     _plugin_unregistercallback(g_plugin_handle, CB_STARTTRACE);
     _plugin_unregistercallback(g_plugin_handle, CB_STOPTRACE);
 
-    // Stop the HTTP server
+    // Stop the HTTP server and the batch helpers, then cancel running jobs
+    // and wait for them to exit
     g_server.stop();
+    handlers::stop_batch_helpers();
+    get_job_manager().stop();
 
     _plugin_logputs("[MCP] Plugin stopped");
     return true;
@@ -331,6 +510,7 @@ PLUG_EXPORT void plugsetup(PLUG_SETUPSTRUCT* setup_struct) {
         if (result.has_value()) {
             _plugin_logprintf("[MCP] x64dbg MCP Server started on %s:%u\n",
                 g_settings.host, g_settings.port);
+            log_unix_socket();
         } else {
             _plugin_logprintf("[MCP] Failed to auto-start server: %s\n", result.error().c_str());
             _plugin_logputs("[MCP] Use 'mcpserver start' to retry");
@@ -355,6 +535,7 @@ PLUG_EXPORT void CBMENUENTRY(CBTYPE, void* call_info) {
             if (result.has_value()) {
                 _plugin_logprintf("[MCP] Server started on %s:%u\n",
                     g_settings.host, g_settings.port);
+                log_unix_socket();
             } else {
                 _plugin_logprintf("[MCP] Failed to start server: %s\n", result.error().c_str());
             }
@@ -373,24 +554,27 @@ PLUG_EXPORT void CBMENUENTRY(CBTYPE, void* call_info) {
         break;
 
     case menu_settings: {
-        // Snapshot current settings in case we need to detect host/port changes
+        // Snapshot current settings in case we need to detect listener changes
         const auto old_host = std::string(g_settings.host);
         const auto old_port = g_settings.port;
+        const auto old_unix_socket = std::string(g_settings.unix_socket);
 
         if (show_settings_dialog(g_hwnd_dlg, g_settings) == IDOK) {
             save_settings();
             _plugin_logputs("[MCP] Settings saved");
 
-            // Restart server if host/port changed and server is running
+            // Restart server if host/port/socket changed and server is running
             const bool host_changed = (old_host != g_settings.host);
             const bool port_changed = (old_port != g_settings.port);
+            const bool unix_socket_changed = (old_unix_socket != g_settings.unix_socket);
 
-            if (g_server.is_running() && (host_changed || port_changed)) {
+            if (g_server.is_running() && (host_changed || port_changed || unix_socket_changed)) {
                 g_server.stop();
                 auto result = start_server();
                 if (result.has_value()) {
                     _plugin_logprintf("[MCP] Server restarted on %s:%u\n",
                         g_settings.host, g_settings.port);
+                    log_unix_socket();
                 } else {
                     _plugin_logprintf("[MCP] Failed to restart server: %s\n",
                         result.error().c_str());
@@ -13,6 +13,8 @@ static constexpr WORD IDC_AUTOSTART    = 104;
 static constexpr WORD IDC_SEPARATOR    = 105;
 static constexpr WORD IDC_TOKEN_LABEL  = 106;
 static constexpr WORD IDC_TOKEN_EDIT   = 107;
+static constexpr WORD IDC_SOCKET_LABEL = 108;
+static constexpr WORD IDC_SOCKET_EDIT  = 109;
 static constexpr WORD IDC_SAVE_BTN     = IDOK;
 static constexpr WORD IDC_CANCEL_BTN   = IDCANCEL;
 
@@ -72,11 +74,11 @@ static LPDLGTEMPLATE build_settings_template() {
     dlg->style = DS_MODALFRAME | DS_CENTER | DS_SETFONT
                | WS_POPUP | WS_CAPTION | WS_SYSMENU;
     dlg->dwExtendedStyle = 0;
-    dlg->cdit = 10;  // 3 labels + 3 edits + checkbox + separator + 2 buttons
+    dlg->cdit = 12;  // 4 labels + 4 edits + checkbox + separator + 2 buttons
     dlg->x = 0;
     dlg->y = 0;
     dlg->cx = 160;
-    dlg->cy = 100;
+    dlg->cy = 118;
 
     auto* ptr = reinterpret_cast<LPWORD>(dlg + 1);
 
@@ -119,23 +121,32 @@ static LPDLGTEMPLATE build_settings_template() {
         ES_AUTOHSCROLL | ES_PASSWORD | WS_BORDER | WS_TABSTOP, 33, 41, 120, 12,
         IDC_TOKEN_EDIT, 0x0081, "");
 
-    // Row 4: Auto-start checkbox
+    // Row 4: Unix socket path (optional, served alongside TCP)
     ptr = add_dialog_item(ptr,
-        BS_AUTOCHECKBOX | WS_TABSTOP, 7, 59, 146, 10,
+        SS_RIGHT, 7, 61, 22, 8,
+        IDC_SOCKET_LABEL, 0x0082, "Socket:");
+
+    ptr = add_dialog_item(ptr,
+        ES_AUTOHSCROLL | WS_BORDER | WS_TABSTOP, 33, 59, 120, 12,
+        IDC_SOCKET_EDIT, 0x0081, "");
+
+    // Row 5: Auto-start checkbox
+    ptr = add_dialog_item(ptr,
+        BS_AUTOCHECKBOX | WS_TABSTOP, 7, 77, 146, 10,
         IDC_AUTOSTART, 0x0080, "Auto-start server on plugin load");
 
     // Etched separator line
     ptr = add_dialog_item(ptr,
-        SS_ETCHEDHORZ, 7, 74, 146, 1,
+        SS_ETCHEDHORZ, 7, 92, 146, 1,
         IDC_SEPARATOR, 0x0082, "");
 
     // Buttons row (right-aligned)
     ptr = add_dialog_item(ptr,
-        BS_DEFPUSHBUTTON | WS_TABSTOP, 56, 81, 45, 14,
+        BS_DEFPUSHBUTTON | WS_TABSTOP, 56, 99, 45, 14,
         IDC_SAVE_BTN, 0x0080, "Save");
 
     ptr = add_dialog_item(ptr,
-        BS_PUSHBUTTON | WS_TABSTOP, 106, 81, 45, 14,
+        BS_PUSHBUTTON | WS_TABSTOP, 106, 99, 45, 14,
         IDC_CANCEL_BTN, 0x0080, "Cancel");
 
     return dlg;
@@ -158,6 +169,7 @@ static INT_PTR CALLBACK settings_dlg_proc(HWND hdlg, UINT msg, WPARAM wparam, LP
         SetDlgItemTextA(hdlg, IDC_PORT_EDIT, port_buf);
 
         SetDlgItemTextA(hdlg, IDC_TOKEN_EDIT, settings->auth_token);
+        SetDlgItemTextA(hdlg, IDC_SOCKET_EDIT, settings->unix_socket);
 
         CheckDlgButton(hdlg, IDC_AUTOSTART,
             settings->auto_start ? BST_CHECKED : BST_UNCHECKED);
@@ -184,6 +196,7 @@ static INT_PTR CALLBACK settings_dlg_proc(HWND hdlg, UINT msg, WPARAM wparam, LP
             settings->port = static_cast<uint16_t>(port_val);
 
             GetDlgItemTextA(hdlg, IDC_TOKEN_EDIT, settings->auth_token, sizeof(settings->auth_token));
+            GetDlgItemTextA(hdlg, IDC_SOCKET_EDIT, settings->unix_socket, sizeof(settings->unix_socket));
 
             settings->auto_start =
                 (IsDlgButtonChecked(hdlg, IDC_AUTOSTART) == BST_CHECKED);
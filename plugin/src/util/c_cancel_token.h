@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+// Cooperative stop signal for one piece of work (a request or a job): set
+// explicitly with cancel(), or by passing the deadline it was created with.
+// Nothing is interrupted; long-running handlers poll stop_requested()
+// between chunks and wrap up with the results they have so far.
+class c_cancel_token {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Longer deadlines asked for by clients (X-Deadline-Ms, a job's
+    // deadline_ms) are clamped to this
+    static constexpr uint64_t MAX_DEADLINE_MS = 3600 * 1000;
+
+    enum class e_reason : uint8_t {
+        none,
+        cancelled,  // cancel() was called
+        deadline    // the deadline passed
+    };
+
+    c_cancel_token() = default;
+    explicit c_cancel_token(clock::time_point deadline) : m_deadline(deadline) {}
+
+    // Safe from any thread
+    void cancel() { m_cancelled.store(true, std::memory_order_release); }
+
+    // Why the work should stop, or none. A cancel wins over the deadline.
+    [[nodiscard]] e_reason reason() const {
+        if (m_cancelled.load(std::memory_order_acquire)) {
+            return e_reason::cancelled;
+        }
+        if (m_deadline && clock::now() >= *m_deadline) {
+            return e_reason::deadline;
+        }
+        return e_reason::none;
+    }
+
+    [[nodiscard]] bool stop_requested() const { return reason() != e_reason::none; }
+
+    [[nodiscard]] std::optional<clock::time_point> deadline() const { return m_deadline; }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+    const std::optional<clock::time_point> m_deadline;
+};
@@ -0,0 +1,87 @@
+#include "util/c_event_hub.h"
+
+#include <chrono>
+#include <utility>
+
+uint64_t c_event_hub::subscribe(subscriber_t subscriber) {
+    std::lock_guard lock(m_subscribers_mutex);
+    uint64_t token = m_next_token++;
+    auto list = std::make_shared<subscription_list>(*m_subscribers);
+    list->push_back({token, std::make_shared<const subscriber_t>(std::move(subscriber))});
+    m_subscribers = std::move(list);
+    return token;
+}
+
+void c_event_hub::unsubscribe(uint64_t token) {
+    std::shared_ptr<const subscription_list> previous; // freed after the lock is released
+    std::lock_guard lock(m_subscribers_mutex);
+    auto list = std::make_shared<subscription_list>(*m_subscribers);
+    std::erase_if(*list, [token](const s_subscription& s) { return s.token == token; });
+    previous = std::exchange(m_subscribers, std::move(list));
+}
+
+void c_event_hub::publish(std::string_view type, nlohmann::json data) {
+    auto event = std::make_shared<s_event>();
+    event->id = m_next_id.fetch_add(1);
+    event->type = std::string(type);
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    event->json = nlohmann::json{
+        {"id",    event->id},
+        {"event", event->type},
+        {"time",  std::chrono::duration_cast<std::chrono::milliseconds>(now).count()},
+        {"data",  std::move(data)}
+    }.dump();
+
+    event_ptr shared = std::move(event);
+    {
+        auto& slot = m_history[shared->id % HISTORY_SIZE];
+        std::lock_guard lock(slot.mutex);
+        slot.event = shared;
+    }
+
+    // A reader that checked for this id before the slot was stored counted
+    // itself in m_waiters first (the slot mutex orders the two), so it is
+    // seen here. Taking its lock means it is waiting by the time we notify.
+    if (m_waiters.load() != 0) {
+        { std::lock_guard lock(m_wait_mutex); }
+        m_published.notify_all();
+    }
+
+    // Deliver outside the lock, from a snapshot: a subscriber whose client
+    // is gone may unsubscribe from inside its own callback
+    std::shared_ptr<const subscription_list> targets;
+    {
+        std::lock_guard lock(m_subscribers_mutex);
+        targets = m_subscribers;
+    }
+    for (const auto& subscription : *targets) {
+        (*subscription.deliver)(shared);
+    }
+}
+
+c_event_hub::event_ptr c_event_hub::find(uint64_t id) const {
+    const auto& slot = m_history[id % HISTORY_SIZE];
+    std::lock_guard lock(slot.mutex);
+    return (slot.event && slot.event->id == id) ? slot.event : nullptr;
+}
+
+bool c_event_hub::wait(uint64_t id, std::chrono::milliseconds timeout) const {
+    std::unique_lock lock(m_wait_mutex);
+    m_waiters.fetch_add(1);
+    bool ready = m_published.wait_for(lock, timeout, [&] {
+        return find(id) || last_id() >= id + HISTORY_SIZE;
+    });
+    m_waiters.fetch_sub(1);
+    return ready;
+}
+
+size_t c_event_hub::subscriber_count() const {
+    std::lock_guard lock(m_subscribers_mutex);
+    return m_subscribers->size();
+}
+
+c_event_hub& get_event_hub() {
+    static c_event_hub instance;
+    return instance;
+}
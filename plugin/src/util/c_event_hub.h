@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// One debugger event, serialized once for every subscriber
+struct s_event {
+    uint64_t id = 0;        // increasing sequence number, from 1
+    std::string type;       // "paused", "breakpoint", "dll_loaded", ...
+    std::string json;       // {"id":..,"event":..,"time":..,"data":{..}}
+};
+
+// Fans debugger events out to live subscribers (WebSocket sessions).
+// Events are published from x64dbg callbacks on the debugger thread, so
+// subscribers must only queue them, never block.
+//
+// The most recent events are also kept in a history ring indexed by id,
+// which pulling readers (the SSE stream) drain at their own pace and which
+// lets a reconnecting client resume after the last id it saw. Publishers
+// claim an id with one atomic increment and store into their own slot. The
+// only lock they share is m_subscribers_mutex, held just to copy the pointer
+// to the current subscriber list, plus m_wait_mutex while a reader is
+// blocked in wait(); delivery runs with no lock held.
+class c_event_hub {
+public:
+    using event_ptr = std::shared_ptr<const s_event>;
+    using subscriber_t = std::function<void(const event_ptr& event)>;
+
+    static constexpr size_t HISTORY_SIZE = 1024; // events kept for resuming readers
+
+    // Register a subscriber. Returns a token for unsubscribe().
+    [[nodiscard]] uint64_t subscribe(subscriber_t subscriber);
+
+    // Remove a subscriber. Safe to call from inside a subscriber.
+    void unsubscribe(uint64_t token);
+
+    // Stamp, serialize and deliver an event to every subscriber
+    void publish(std::string_view type, nlohmann::json data = nlohmann::json::object());
+
+    [[nodiscard]] size_t subscriber_count() const;
+
+    // Id of the newest event claimed so far (0 before the first)
+    [[nodiscard]] uint64_t last_id() const { return m_next_id.load() - 1; }
+
+    // The event with this id, or null if it is not published yet or has
+    // already been overwritten in the history
+    [[nodiscard]] event_ptr find(uint64_t id) const;
+
+    // Block until event `id` is in the history (or has already left it).
+    // Returns false if the timeout expired first.
+    bool wait(uint64_t id, std::chrono::milliseconds timeout) const;
+
+private:
+    struct s_subscription {
+        uint64_t token;
+        std::shared_ptr<const subscriber_t> deliver;
+    };
+    using subscription_list = std::vector<s_subscription>;
+
+    // Copy-on-write: subscribe/unsubscribe build a new list and swap it in,
+    // so publish() copies one pointer rather than the list
+    mutable std::mutex m_subscribers_mutex;
+    std::shared_ptr<const subscription_list> m_subscribers = std::make_shared<const subscription_list>();
+    uint64_t m_next_token = 1;
+    std::atomic<uint64_t> m_next_id{1};
+
+    mutable std::mutex m_wait_mutex;
+    mutable std::condition_variable m_published; // readers waiting in wait()
+    mutable std::atomic<size_t> m_waiters{0};    // ... and how many there are
+
+    // One history entry. The lock is per slot: only a reader of the same id
+    // (or a publisher HISTORY_SIZE ids later) ever contends for it.
+    struct s_history_slot {
+        mutable std::mutex mutex;
+        event_ptr event;
+    };
+    std::array<s_history_slot, HISTORY_SIZE> m_history; // slot = id % HISTORY_SIZE
+};
+
+// Global event hub instance
+c_event_hub& get_event_hub();
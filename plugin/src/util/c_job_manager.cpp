@@ -0,0 +1,265 @@
+#include "util/c_job_manager.h"
+
+#include <algorithm>
+
+thread_local c_job_manager::s_job* c_job_manager::t_current = nullptr;
+
+namespace {
+
+// Same shape as s_http_response::error()'s envelope
+nlohmann::json error_envelope(int code, const std::string& message) {
+    return {
+        {"success", false},
+        {"error", {
+            {"code", code},
+            {"message", message}
+        }}
+    };
+}
+
+int64_t elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+} // namespace
+
+c_job_manager::~c_job_manager() {
+    stop();
+}
+
+std::expected<uint64_t, std::string> c_job_manager::submit(
+    nlohmann::json request, std::shared_ptr<c_cancel_token> cancel, work_t work) {
+    std::lock_guard lock(m_mutex);
+    retire_locked();
+
+    if (m_pool.worker_count() == 0) {
+        m_pool.start(WORKERS, MAX_QUEUED);
+    }
+
+    auto job = std::make_shared<s_job>();
+    job->id = m_next_id;
+    job->request = std::move(request);
+    job->cancel = std::move(cancel);
+    job->submitted = std::chrono::steady_clock::now();
+
+    // The task holds the job, so it outlives its removal from the table
+    bool queued = m_pool.try_submit([this, job, work = std::move(work)] {
+        run(job, work);
+    });
+    if (!queued) {
+        return std::unexpected(std::to_string(WORKERS + MAX_QUEUED) + " jobs are already queued or running");
+    }
+
+    ++m_next_id;
+    m_jobs.emplace(job->id, job);
+    m_order.push_back(job->id);
+    return job->id;
+}
+
+void c_job_manager::run(const job_ptr& job, const work_t& work) {
+    {
+        std::lock_guard lock(job->mutex);
+        job->state = e_state::running;
+        job->started = std::chrono::steady_clock::now();
+    }
+
+    nlohmann::json result;
+    if (auto reason = job->cancel->reason(); reason != c_cancel_token::e_reason::none) {
+        result = error_envelope(503, reason == c_cancel_token::e_reason::deadline
+            ? "Deadline passed before the job started"
+            : "Job was cancelled before it started");
+    } else {
+        t_current = job.get();
+        try {
+            result = work();
+        } catch (const std::exception& e) {
+            result = error_envelope(500, std::string("Job exception: ") + e.what());
+        } catch (...) {
+            result = error_envelope(500, "Job exception");
+        }
+        t_current = nullptr;
+    }
+
+    bool success = result.is_object() && result.value("success", false);
+
+    std::lock_guard lock(job->mutex);
+    job->result = std::move(result);
+    job->state = success ? e_state::succeeded : e_state::failed;
+    job->finished = std::chrono::steady_clock::now();
+    // The result supersedes the partial items
+    std::vector<nlohmann::json>().swap(job->partial);
+}
+
+std::optional<nlohmann::json> c_job_manager::describe(uint64_t id, size_t since) const {
+    job_ptr job;
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_jobs.find(id);
+        if (it == m_jobs.end()) {
+            return std::nullopt;
+        }
+        job = it->second;
+    }
+
+    std::lock_guard lock(job->mutex);
+    auto out = summary_locked(*job);
+    if (job->state == e_state::succeeded || job->state == e_state::failed) {
+        out["result"] = job->result;
+        return out;
+    }
+
+    // Items are kept in report order, so a poller passing the count it has
+    // seen as `since` receives each kept item exactly once
+    nlohmann::json items = nlohmann::json::array();
+    for (size_t i = since; i < job->partial.size(); ++i) {
+        items.push_back(job->partial[i]);
+    }
+    out["partial"] = {
+        {"since",     since},
+        {"items",     std::move(items)},
+        {"truncated", job->partial_count > job->partial.size()}
+    };
+    return out;
+}
+
+nlohmann::json c_job_manager::list() const {
+    std::vector<job_ptr> jobs;
+    {
+        std::lock_guard lock(m_mutex);
+        jobs.reserve(m_order.size());
+        for (uint64_t id : m_order) {
+            jobs.push_back(m_jobs.at(id));
+        }
+    }
+
+    auto out = nlohmann::json::array();
+    for (const auto& job : jobs) {
+        std::lock_guard lock(job->mutex);
+        out.push_back(summary_locked(*job));
+    }
+    return out;
+}
+
+c_job_manager::e_remove_result c_job_manager::remove(uint64_t id) {
+    std::lock_guard lock(m_mutex);
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) {
+        return e_remove_result::not_found;
+    }
+    {
+        std::lock_guard job_lock(it->second->mutex);
+        if (it->second->state == e_state::queued || it->second->state == e_state::running) {
+            return e_remove_result::unfinished;
+        }
+    }
+
+    m_jobs.erase(it);
+    m_order.erase(std::find(m_order.begin(), m_order.end(), id));
+    return e_remove_result::removed;
+}
+
+c_job_manager::e_cancel_result c_job_manager::cancel(uint64_t id) {
+    std::lock_guard lock(m_mutex);
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) {
+        return e_cancel_result::not_found;
+    }
+
+    std::lock_guard job_lock(it->second->mutex);
+    if (it->second->state == e_state::succeeded || it->second->state == e_state::failed) {
+        return e_cancel_result::finished;
+    }
+    it->second->cancel->cancel();
+    return e_cancel_result::cancelled;
+}
+
+void c_job_manager::stop() {
+    // Running scans notice within a chunk, so the join below is short
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto& [id, job] : m_jobs) {
+            job->cancel->cancel();
+        }
+    }
+    m_pool.stop();
+}
+
+void c_job_manager::report_progress(uint64_t done, uint64_t total) {
+    if (auto* job = t_current) {
+        job->progress_total.store(total, std::memory_order_relaxed);
+        job->progress_done.store(done, std::memory_order_relaxed);
+    }
+}
+
+void c_job_manager::report_partial(const nlohmann::json& item) {
+    if (auto* job = t_current) {
+        std::lock_guard lock(job->mutex);
+        if (job->partial.size() < MAX_PARTIAL_ITEMS) {
+            job->partial.push_back(item);
+        }
+        ++job->partial_count;
+    }
+}
+
+void c_job_manager::retire_locked() {
+    const auto now = std::chrono::steady_clock::now();
+    size_t finished = 0;
+    for (uint64_t id : m_order) {
+        std::lock_guard lock(m_jobs.at(id)->mutex);
+        auto state = m_jobs.at(id)->state;
+        finished += (state == e_state::succeeded || state == e_state::failed);
+    }
+
+    // Oldest first: a job over the count or past its age goes
+    for (auto it = m_order.begin(); it != m_order.end();) {
+        const auto& job = m_jobs.at(*it);
+        bool retire = false;
+        {
+            std::lock_guard lock(job->mutex);
+            if (job->state == e_state::succeeded || job->state == e_state::failed) {
+                retire = finished > MAX_FINISHED || now - job->finished > MAX_FINISHED_AGE;
+            }
+        }
+        if (!retire) {
+            ++it;
+            continue;
+        }
+        --finished;
+        m_jobs.erase(*it);
+        it = m_order.erase(it);
+    }
+}
+
+nlohmann::json c_job_manager::summary_locked(const s_job& job) {
+    const auto now = std::chrono::steady_clock::now();
+    const bool started = job.state != e_state::queued;
+    const bool finished = job.state == e_state::succeeded || job.state == e_state::failed;
+
+    return {
+        {"id",       job.id},
+        {"state",    state_name(job.state)},
+        {"request",  job.request},
+        {"progress", {
+            {"done",  job.progress_done.load(std::memory_order_relaxed)},
+            {"total", job.progress_total.load(std::memory_order_relaxed)} // 0 while unknown
+        }},
+        {"partial_count", job.partial_count},
+        {"queued_ms",  elapsed_ms(job.submitted, started ? job.started : now)},
+        {"running_ms", started ? elapsed_ms(job.started, finished ? job.finished : now) : 0}
+    };
+}
+
+const char* c_job_manager::state_name(e_state state) {
+    switch (state) {
+        case e_state::queued:    return "queued";
+        case e_state::running:   return "running";
+        case e_state::succeeded: return "succeeded";
+        case e_state::failed:    return "failed";
+    }
+    return "unknown";
+}
+
+c_job_manager& get_job_manager() {
+    static c_job_manager manager;
+    return manager;
+}
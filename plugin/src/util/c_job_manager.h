@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "util/c_cancel_token.h"
+#include "util/c_worker_pool.h"
+
+// Long-running work detached from the request that started it. submit()
+// queues the work on a dedicated pool and returns an id at once; the
+// client then polls describe() for progress, the partial results reported
+// so far and finally the result, so a client timeout no longer loses the
+// work.
+//
+// Code running inside a job reports through the static report_*() calls,
+// which are no-ops on any other thread; a handler does not need to know
+// whether it was called directly or as a job.
+class c_job_manager {
+public:
+    static constexpr size_t WORKERS = 2;              // jobs running at once
+    static constexpr size_t MAX_QUEUED = 16;          // waiting for a worker
+    static constexpr size_t MAX_FINISHED = 32;        // finished jobs kept for polling
+    static constexpr std::chrono::minutes MAX_FINISHED_AGE{10};
+    static constexpr size_t MAX_PARTIAL_ITEMS = 10000; // kept per job; later items are only counted
+
+    // Produces the job's result (a response envelope)
+    using work_t = std::function<nlohmann::json()>;
+
+    c_job_manager() = default;
+    ~c_job_manager();
+
+    c_job_manager(const c_job_manager&) = delete;
+    c_job_manager& operator=(const c_job_manager&) = delete;
+
+    // Queue a job. `request` describes it in listings; `cancel` is the token
+    // the work polls, which cancel() and stop() trigger. Fails if the queue
+    // is full.
+    [[nodiscard]] std::expected<uint64_t, std::string> submit(
+        nlohmann::json request, std::shared_ptr<c_cancel_token> cancel, work_t work);
+
+    // State, progress and timing of a job, with the partial results from
+    // index `since` on while it runs and the result once it has finished.
+    // nullopt if there is no such job (never was, or no longer retained).
+    [[nodiscard]] std::optional<nlohmann::json> describe(uint64_t id, size_t since = 0) const;
+
+    // Summaries of every retained job, oldest first
+    [[nodiscard]] nlohmann::json list() const;
+
+    enum class e_remove_result { removed, not_found, unfinished };
+
+    // Forget a finished job
+    e_remove_result remove(uint64_t id);
+
+    enum class e_cancel_result { cancelled, not_found, finished };
+
+    // Ask a job to stop. A running job wraps up with what it has (if its
+    // work polls the token); a queued one fails without running.
+    e_cancel_result cancel(uint64_t id);
+
+    // Cancel every job and join the workers. Jobs submitted afterwards
+    // start the pool again.
+    void stop();
+
+    // Progress of the calling thread's job, in the work's own units
+    // (pages, bytes, ...)
+    static void report_progress(uint64_t done, uint64_t total);
+
+    // One result item of the calling thread's job, visible to pollers
+    // before the job finishes
+    static void report_partial(const nlohmann::json& item);
+
+    // Whether the calling thread is running a job, for reporters that would
+    // have to build the item first
+    [[nodiscard]] static bool in_job() { return t_current != nullptr; }
+
+private:
+    enum class e_state { queued, running, succeeded, failed };
+
+    struct s_job {
+        uint64_t id = 0;
+        nlohmann::json request;
+        std::shared_ptr<c_cancel_token> cancel;
+        std::chrono::steady_clock::time_point submitted;
+
+        std::atomic<uint64_t> progress_done{0};
+        std::atomic<uint64_t> progress_total{0};
+
+        mutable std::mutex mutex; // guards the fields below
+        e_state state = e_state::queued;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point finished;
+        std::vector<nlohmann::json> partial;
+        size_t partial_count = 0; // including items past MAX_PARTIAL_ITEMS
+        nlohmann::json result;
+    };
+
+    using job_ptr = std::shared_ptr<s_job>;
+
+    c_worker_pool m_pool;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, job_ptr> m_jobs;
+    std::deque<uint64_t> m_order; // submission order, for listing and retention
+    uint64_t m_next_id = 1;
+
+    static thread_local s_job* t_current;
+
+    void run(const job_ptr& job, const work_t& work);
+
+    // Drop finished jobs beyond MAX_FINISHED or older than MAX_FINISHED_AGE
+    void retire_locked();
+
+    // Id, state, request and progress; caller holds job.mutex
+    [[nodiscard]] static nlohmann::json summary_locked(const s_job& job);
+    [[nodiscard]] static const char* state_name(e_state state);
+};
+
+c_job_manager& get_job_manager();
@@ -0,0 +1,76 @@
+#include "util/c_latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+size_t c_latency_histogram::bucket_index(uint64_t micros) {
+    micros = std::min(micros, MAX_MICROS);
+    if (micros < SUB_BUCKETS) {
+        return static_cast<size_t>(micros); // one bucket per value below the first octave
+    }
+
+    // The top SUB_BUCKET_BITS + 1 bits select the bucket: the leading one
+    // picks the octave, the bits after it the slice within it
+    const int exponent = std::bit_width(micros) - 1;
+    const int shift = exponent - SUB_BUCKET_BITS;
+    const size_t sub = static_cast<size_t>(micros >> shift) - SUB_BUCKETS;
+    return SUB_BUCKETS + static_cast<size_t>(shift) * SUB_BUCKETS + sub;
+}
+
+uint64_t c_latency_histogram::bucket_max(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const size_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((uint64_t(SUB_BUCKETS + sub + 1)) << shift) - 1;
+}
+
+void c_latency_histogram::record(std::chrono::steady_clock::duration elapsed) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    record_micros(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+}
+
+void c_latency_histogram::record_micros(uint64_t micros) {
+    m_buckets[bucket_index(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_sum_micros.fetch_add(micros, std::memory_order_relaxed);
+}
+
+c_latency_histogram::s_snapshot c_latency_histogram::snapshot() const {
+    s_snapshot out;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        out.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+    // Derived from the buckets so the total always matches them
+    for (uint64_t n : out.buckets) {
+        out.count += n;
+    }
+    out.sum_micros = m_sum_micros.load(std::memory_order_relaxed);
+    return out;
+}
+
+uint64_t c_latency_histogram::s_snapshot::count_at_or_below(uint64_t micros) const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && bucket_max(i) <= micros; ++i) {
+        total += buckets[i];
+    }
+    return total;
+}
+
+uint64_t c_latency_histogram::s_snapshot::value_at_quantile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return bucket_max(i);
+        }
+    }
+    return MAX_MICROS;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free latency histogram with HDR-style log-linear buckets: each power
+// of two (in microseconds) is split into SUB_BUCKETS equal buckets, so any
+// recorded value is known to within 1/SUB_BUCKETS (12.5%) from 1us up to
+// MAX_MICROS. record() is a few relaxed atomic adds; a snapshot taken while
+// others record is not a single instant, which is fine for monitoring.
+class c_latency_histogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t MAX_MICROS = (uint64_t(1) << 32) - 1; // ~71 minutes; larger values are clamped
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (32 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    void record(std::chrono::steady_clock::duration elapsed);
+    void record_micros(uint64_t micros);
+
+    struct s_snapshot {
+        std::array<uint64_t, BUCKET_COUNT> buckets{};
+        uint64_t count = 0;
+        uint64_t sum_micros = 0;
+
+        // Recorded values <= micros. Exact when micros + 1 is a bucket
+        // boundary (e.g. a power of two minus one); otherwise the bucket
+        // straddling it is left out.
+        [[nodiscard]] uint64_t count_at_or_below(uint64_t micros) const;
+
+        // Upper bound of the bucket holding the q-th quantile (0 < q <= 1)
+        [[nodiscard]] uint64_t value_at_quantile(double q) const;
+    };
+    [[nodiscard]] s_snapshot snapshot() const;
+
+    // Bucket for a value, and the largest value that bucket holds
+    [[nodiscard]] static size_t bucket_index(uint64_t micros);
+    [[nodiscard]] static uint64_t bucket_max(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_sum_micros{0};
+};
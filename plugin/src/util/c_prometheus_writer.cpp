@@ -0,0 +1,102 @@
+#include "util/c_prometheus_writer.h"
+
+#include <charconv>
+
+void c_prometheus_writer::family(std::string_view name, std::string_view type, std::string_view help) {
+    m_out += "# HELP ";
+    m_out += name;
+    m_out += ' ';
+    m_out += help;
+    m_out += "\n# TYPE ";
+    m_out += name;
+    m_out += ' ';
+    m_out += type;
+    m_out += '\n';
+}
+
+void c_prometheus_writer::sample(std::string_view name, labels_t labels, uint64_t value) {
+    append_name(name, {}, labels);
+    m_out += ' ';
+    m_out += std::to_string(value);
+    m_out += '\n';
+}
+
+void c_prometheus_writer::sample(std::string_view name, labels_t labels, double value) {
+    append_name(name, {}, labels);
+    m_out += ' ';
+    append_number(value);
+    m_out += '\n';
+}
+
+void c_prometheus_writer::histogram(std::string_view name, labels_t labels,
+                                    const c_latency_histogram::s_snapshot& snapshot) {
+    char bound[32];
+    for (uint64_t edge = 64; edge <= (uint64_t(1) << 26); edge *= 4) {
+        auto end = std::to_chars(bound, bound + sizeof(bound), static_cast<double>(edge) / 1e6).ptr;
+        append_name(name, "_bucket", labels, "le", std::string_view(bound, end - bound));
+        m_out += ' ';
+        m_out += std::to_string(snapshot.count_at_or_below(edge - 1));
+        m_out += '\n';
+    }
+
+    append_name(name, "_bucket", labels, "le", "+Inf");
+    m_out += ' ';
+    m_out += std::to_string(snapshot.count);
+    m_out += '\n';
+
+    append_name(name, "_sum", labels);
+    m_out += ' ';
+    append_number(static_cast<double>(snapshot.sum_micros) / 1e6);
+    m_out += '\n';
+
+    append_name(name, "_count", labels);
+    m_out += ' ';
+    m_out += std::to_string(snapshot.count);
+    m_out += '\n';
+}
+
+void c_prometheus_writer::append_name(std::string_view name, std::string_view suffix, labels_t labels,
+                                      std::string_view extra_name, std::string_view extra_value) {
+    m_out += name;
+    m_out += suffix;
+    if (labels.size() == 0 && extra_name.empty()) {
+        return;
+    }
+
+    m_out += '{';
+    bool first = true;
+    auto append_label = [&](std::string_view key, std::string_view value) {
+        if (!first) {
+            m_out += ',';
+        }
+        first = false;
+        m_out += key;
+        m_out += "=\"";
+        append_label_value(value);
+        m_out += '"';
+    };
+    for (const auto& [key, value] : labels) {
+        append_label(key, value);
+    }
+    if (!extra_name.empty()) {
+        append_label(extra_name, extra_value);
+    }
+    m_out += '}';
+}
+
+void c_prometheus_writer::append_label_value(std::string_view value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': m_out += "\\\\"; break;
+            case '"':  m_out += "\\\""; break;
+            case '\n': m_out += "\\n"; break;
+            default:   m_out += c; break;
+        }
+    }
+}
+
+void c_prometheus_writer::append_number(double value) {
+    char buffer[32];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    m_out.append(buffer, end);
+}
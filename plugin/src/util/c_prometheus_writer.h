@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "util/c_latency_histogram.h"
+
+// Builds a Prometheus text exposition (format 0.0.4). Call family() once per
+// metric name, then write its samples.
+class c_prometheus_writer {
+public:
+    using labels_t = std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+    // "# HELP" and "# TYPE" lines; type is "counter", "gauge" or "histogram"
+    void family(std::string_view name, std::string_view type, std::string_view help);
+
+    void sample(std::string_view name, labels_t labels, uint64_t value);
+    void sample(std::string_view name, labels_t labels, double value);
+
+    // name_bucket / name_sum / name_count for a histogram family, in
+    // seconds. Buckets end at 4^k microseconds from 64us to ~67s; each
+    // bound is a bucket edge of c_latency_histogram, so the counts are exact.
+    void histogram(std::string_view name, labels_t labels, const c_latency_histogram::s_snapshot& snapshot);
+
+    [[nodiscard]] std::string take() { return std::move(m_out); }
+
+private:
+    std::string m_out;
+
+    void append_name(std::string_view name, std::string_view suffix, labels_t labels,
+                     std::string_view extra_name = {}, std::string_view extra_value = {});
+    void append_label_value(std::string_view value);
+    void append_number(double value);
+};
@@ -0,0 +1,158 @@
+#include "util/c_shared_ring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr auto FULL_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+struct s_ring_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    alignas(64) uint64_t head; // own cache line: the client polls it
+    alignas(64) uint64_t tail; // own cache line: the client writes it
+};
+static_assert(offsetof(s_ring_header, head) == 64 && offsetof(s_ring_header, tail) == 128);
+static_assert(sizeof(s_ring_header) <= c_shared_ring::HEADER_SIZE);
+// The client's process shares these counters, so they must not hide a lock
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free);
+
+} // namespace
+
+std::expected<std::unique_ptr<c_shared_ring>, std::string> c_shared_ring::create(
+    const std::string& name, size_t capacity
+) {
+    // Checked before rounding: bit_ceil of a size above the top bit is undefined
+    if (capacity > MAX_CAPACITY) {
+        return std::unexpected("Ring size is limited to " + std::to_string(MAX_CAPACITY) + " bytes");
+    }
+    capacity = std::bit_ceil(std::max(capacity, MIN_CAPACITY));
+
+    std::unique_ptr<c_shared_ring> ring(new c_shared_ring());
+    ring->m_capacity = capacity;
+    const uint64_t total = HEADER_SIZE + capacity;
+
+#ifdef _WIN32
+    ring->m_name = "Local\\" + name;
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(total >> 32), static_cast<DWORD>(total),
+                                        ring->m_name.c_str());
+    if (mapping == nullptr) {
+        return std::unexpected("CreateFileMapping failed with error: " + std::to_string(GetLastError()));
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping);
+        return std::unexpected("Shared memory " + ring->m_name + " already exists");
+    }
+    ring->m_mapping = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(total));
+    if (view == nullptr) {
+        return std::unexpected("MapViewOfFile failed with error: " + std::to_string(GetLastError()));
+    }
+#else
+    ring->m_name = "/" + name;
+    int fd = shm_open(ring->m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return std::unexpected("shm_open(" + ring->m_name + ") failed with error: " + std::to_string(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        int err = errno;
+        close(fd);
+        shm_unlink(ring->m_name.c_str());
+        return std::unexpected("ftruncate failed with error: " + std::to_string(err));
+    }
+
+    void* view = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the object alive
+    if (view == MAP_FAILED) {
+        shm_unlink(ring->m_name.c_str());
+        return std::unexpected("mmap failed with error: " + std::to_string(errno));
+    }
+    ring->m_view_size = total;
+#endif
+
+    ring->m_view = static_cast<uint8_t*>(view);
+
+    // Fresh mappings are zero-filled, so head and tail start at 0. The magic
+    // goes last: a client that sees it sees the rest of the header.
+    auto* header = reinterpret_cast<s_ring_header*>(ring->m_view);
+    header->version = VERSION;
+    header->capacity = capacity;
+    std::atomic_ref<uint32_t>(header->magic).store(MAGIC, std::memory_order_release);
+
+    return ring;
+}
+
+c_shared_ring::~c_shared_ring() {
+#ifdef _WIN32
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+#else
+    if (m_view) {
+        munmap(m_view, m_view_size);
+        shm_unlink(m_name.c_str());
+    }
+#endif
+}
+
+std::expected<c_shared_ring::s_slot, std::string> c_shared_ring::publish(
+    size_t length, const std::function<bool(uint8_t* dest)>& fill, std::chrono::milliseconds timeout
+) {
+    if (length > max_payload()) {
+        return std::unexpected("Payload of " + std::to_string(length) + " bytes exceeds the ring's limit of " +
+                               std::to_string(max_payload()));
+    }
+
+    std::lock_guard lock(m_mutex);
+    auto* header = reinterpret_cast<s_ring_header*>(m_view);
+
+    // Keep the payload contiguous: if it would run past the end, skip the
+    // rest of the ring and start at offset 0
+    const size_t position = static_cast<size_t>(m_head & (m_capacity - 1));
+    const size_t skip = (length > m_capacity - position) ? m_capacity - position : 0;
+    const uint64_t end = m_head + skip + length;
+
+    // The client releases space from another process, so there is nothing
+    // to wait on but the counter itself
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (end - std::atomic_ref<uint64_t>(header->tail).load(std::memory_order_acquire) > m_capacity) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return std::unexpected("Ring is full: earlier payloads have not been released");
+        }
+        std::this_thread::sleep_for(FULL_POLL_INTERVAL);
+    }
+
+    const size_t offset = skip ? 0 : position;
+    if (!fill(m_view + HEADER_SIZE + offset)) {
+        return std::unexpected("Payload was abandoned");
+    }
+
+    m_head = end;
+    std::atomic_ref<uint64_t>(header->head).store(end, std::memory_order_release);
+    return s_slot{offset, length, end};
+}
+
+uint64_t c_shared_ring::pending() const {
+    auto* header = reinterpret_cast<s_ring_header*>(m_view);
+    return std::atomic_ref<uint64_t>(header->head).load(std::memory_order_acquire) -
+           std::atomic_ref<uint64_t>(header->tail).load(std::memory_order_acquire);
+}
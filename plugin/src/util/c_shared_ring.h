@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Ring buffer in a named shared-memory mapping, for handing bulk payloads
+// (memory reads, dumps) to a client process without pushing them through a
+// socket. The plugin writes each payload contiguously and publishes it by
+// advancing `head`; the client reads it in place, then advances `tail` to
+// give the space back. Which payload is where travels over HTTP.
+//
+// Layout (little-endian, byte offsets):
+//   0    uint32 magic ("MCPR")
+//   4    uint32 version
+//   8    uint64 capacity   data bytes, a power of two
+//   64   uint64 head       bytes ever published; written by the plugin
+//   128  uint64 tail       bytes ever released; written by the client
+//   192  data[capacity]
+// A payload {offset, length, end} occupies data[offset, offset + length).
+// The client releases it by storing `end` into tail, in publish order.
+class c_shared_ring {
+public:
+    static constexpr uint32_t MAGIC = 0x5250434D; // "MCPR"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 192;
+    static constexpr size_t MIN_CAPACITY = 64 * 1024;
+    static constexpr size_t MAX_CAPACITY = 256 * 1024 * 1024;
+
+    // Create a mapping holding at least `capacity` data bytes (rounded up to
+    // a power of two). `name` becomes "Local\name" on Windows and the POSIX
+    // shared-memory object "/name" elsewhere; it must not exist yet.
+    [[nodiscard]] static std::expected<std::unique_ptr<c_shared_ring>, std::string> create(
+        const std::string& name, size_t capacity
+    );
+
+    ~c_shared_ring();
+
+    // Non-copyable, non-movable
+    c_shared_ring(const c_shared_ring&) = delete;
+    c_shared_ring& operator=(const c_shared_ring&) = delete;
+    c_shared_ring(c_shared_ring&&) = delete;
+    c_shared_ring& operator=(c_shared_ring&&) = delete;
+
+    // The name a client opens (OpenFileMapping / shm_open)
+    [[nodiscard]] const std::string& name() const { return m_name; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    // Largest single payload. A payload that would straddle the end of the
+    // ring starts over at offset 0 instead, so it may cost up to twice its
+    // length; half the capacity always fits once the client catches up.
+    [[nodiscard]] size_t max_payload() const { return m_capacity / 2; }
+
+    struct s_slot {
+        size_t offset = 0;  // into the data area
+        size_t length = 0;
+        uint64_t end = 0;   // tail value that releases it
+    };
+
+    // Publish `length` bytes (at most max_payload()). `fill` writes them in
+    // place and returns false to abandon the payload, which then is never
+    // published. Waits up to `timeout` for the client to release space.
+    // Publishers are serialized.
+    [[nodiscard]] std::expected<s_slot, std::string> publish(
+        size_t length, const std::function<bool(uint8_t* dest)>& fill, std::chrono::milliseconds timeout
+    );
+
+    // Bytes published but not yet released
+    [[nodiscard]] uint64_t pending() const;
+
+private:
+    c_shared_ring() = default;
+
+    std::mutex m_mutex;       // one publisher at a time
+    std::string m_name;
+    size_t m_capacity = 0;
+    uint8_t* m_view = nullptr; // header, then data
+    uint64_t m_head = 0;       // our copy of the published head
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#else
+    size_t m_view_size = 0;
+#endif
+};
@@ -0,0 +1,105 @@
+#include "util/c_timer_wheel.h"
+
+#include <algorithm>
+
+namespace {
+
+void unlink(c_timer_wheel::s_timer& timer) {
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = nullptr;
+    timer.next = nullptr;
+}
+
+} // namespace
+
+c_timer_wheel::c_timer_wheel(std::chrono::milliseconds tick, clock::time_point origin)
+    : m_tick(tick)
+    , m_origin(origin) {
+    for (auto& level : m_slots) {
+        for (auto& head : level) {
+            head.prev = &head;
+            head.next = &head;
+        }
+    }
+}
+
+void c_timer_wheel::schedule(s_timer& timer, clock::time_point deadline) {
+    if (timer.armed()) {
+        unlink(timer);
+        --m_size;
+    }
+    // The current tick's slot has already been run
+    timer.expires = std::max(to_tick(deadline), m_current + 1);
+    insert(timer);
+    ++m_size;
+}
+
+void c_timer_wheel::cancel(s_timer& timer) {
+    if (timer.armed()) {
+        unlink(timer);
+        --m_size;
+    }
+}
+
+void c_timer_wheel::advance(clock::time_point now, const std::function<void(s_timer&)>& on_expired) {
+    // Only ticks that have fully elapsed
+    const uint64_t target = now > m_origin
+        ? static_cast<uint64_t>(std::chrono::floor<std::chrono::milliseconds>(now - m_origin) / m_tick)
+        : 0;
+    while (m_current < target) {
+        const uint64_t tick = ++m_current;
+
+        // Each time a level wraps, the next level's current slot moves down
+        for (size_t level = 1; level < LEVELS; ++level) {
+            const unsigned shift = SLOT_BITS * static_cast<unsigned>(level);
+            if ((tick & ((uint64_t{1} << shift) - 1)) != 0) {
+                break;
+            }
+            auto& head = m_slots[level][(tick >> shift) & SLOT_MASK];
+            while (head.next != &head) {
+                s_timer& timer = *head.next;
+                unlink(timer);
+                insert(timer);
+            }
+        }
+
+        auto& head = m_slots[0][tick & SLOT_MASK];
+        while (head.next != &head) {
+            s_timer& timer = *head.next;
+            unlink(timer);
+            --m_size;
+            on_expired(timer);
+        }
+    }
+}
+
+uint64_t c_timer_wheel::to_tick(clock::time_point when) const {
+    if (when <= m_origin) {
+        return 0;
+    }
+    // Round up: a timer must not fire before its deadline
+    auto elapsed = std::chrono::ceil<std::chrono::milliseconds>(when - m_origin);
+    return static_cast<uint64_t>((elapsed + m_tick - std::chrono::milliseconds(1)) / m_tick);
+}
+
+void c_timer_wheel::insert(s_timer& timer) {
+    // A timer moved down by advance() may be due on the tick being run: it
+    // lands in that tick's level-0 slot, which is run next
+    constexpr uint64_t max_delta = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+    if (timer.expires - m_current > max_delta) {
+        timer.expires = m_current + max_delta;
+    }
+
+    const uint64_t delta = timer.expires - m_current;
+    size_t level = 0;
+    while (level + 1 < LEVELS && delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+
+    auto& head = m_slots[level][(timer.expires >> (SLOT_BITS * level)) & SLOT_MASK];
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Hierarchical timer wheel: LEVELS rings of SLOTS lists, each level's slot
+// spanning a whole ring of the level below. Scheduling and cancelling are
+// O(1); a timer far in the future is moved down a level at a time as its
+// slot comes up, so each is touched at most LEVELS times before it fires.
+// Timers are intrusive (embedded in the timed object) and not owned by the
+// wheel: cancel one before its owner goes away. Not thread-safe.
+class c_timer_wheel {
+public:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+    static constexpr size_t LEVELS = 4; // 64^4 ticks: 19 days at 100ms
+
+    struct s_timer {
+        s_timer* prev = nullptr;
+        s_timer* next = nullptr;
+        uint64_t expires = 0; // tick
+
+        [[nodiscard]] bool armed() const { return next != nullptr; }
+    };
+
+    using clock = std::chrono::steady_clock;
+
+    c_timer_wheel(std::chrono::milliseconds tick, clock::time_point origin);
+
+    // Non-copyable, non-movable (slots point at each other)
+    c_timer_wheel(const c_timer_wheel&) = delete;
+    c_timer_wheel& operator=(const c_timer_wheel&) = delete;
+    c_timer_wheel(c_timer_wheel&&) = delete;
+    c_timer_wheel& operator=(c_timer_wheel&&) = delete;
+
+    // Arm `timer` for `deadline`, moving it if already armed. Fires on the
+    // first tick at or after the deadline, never on the current one.
+    void schedule(s_timer& timer, clock::time_point deadline);
+
+    // Disarm `timer`; no-op if it is not armed
+    void cancel(s_timer& timer);
+
+    // Run the wheel up to `now`, disarming each due timer and passing it to
+    // on_expired (which may schedule it again)
+    void advance(clock::time_point now, const std::function<void(s_timer&)>& on_expired);
+
+    // Timers currently armed
+    [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    std::chrono::milliseconds m_tick;
+    clock::time_point m_origin;
+    uint64_t m_current = 0;        // last tick processed
+    size_t m_size = 0;
+    std::array<std::array<s_timer, SLOTS>, LEVELS> m_slots; // list heads (circular)
+
+    // First tick at or after `when`
+    [[nodiscard]] uint64_t to_tick(clock::time_point when) const;
+
+    // Link into the slot for timer.expires, relative to m_current
+    void insert(s_timer& timer);
+};
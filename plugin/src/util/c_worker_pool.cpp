@@ -0,0 +1,82 @@
+#include "util/c_worker_pool.h"
+
+c_worker_pool::~c_worker_pool() {
+    stop();
+}
+
+void c_worker_pool::start(size_t worker_count, size_t queue_capacity) {
+    std::lock_guard lock(m_mutex);
+    if (!m_workers.empty()) {
+        return;
+    }
+
+    m_stopping = false;
+    m_capacity = queue_capacity;
+    m_workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        m_workers.emplace_back(&c_worker_pool::worker_loop, this);
+    }
+}
+
+void c_worker_pool::stop() {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_workers.empty()) {
+            return;
+        }
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_workers.clear();
+    m_queue.clear();
+}
+
+bool c_worker_pool::try_submit(task_t task) {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_stopping || m_workers.empty() || m_queue.size() >= m_capacity) {
+            return false;
+        }
+        m_queue.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+size_t c_worker_pool::queued() const {
+    std::lock_guard lock(m_mutex);
+    return m_queue.size();
+}
+
+void c_worker_pool::worker_loop() {
+    while (true) {
+        task_t task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return; // stopping and fully drained
+            }
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_busy.fetch_add(1);
+        }
+
+        // Tasks run on a plugin thread inside x64dbg: an escaping exception
+        // would terminate the debugger, so swallow anything the task missed.
+        try {
+            task();
+        } catch (...) {
+        }
+
+        m_busy.fetch_sub(1);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool with a bounded task queue. Submitting to a full
+// queue fails immediately instead of blocking, so callers can shed load.
+class c_worker_pool {
+public:
+    using task_t = std::function<void()>;
+
+    c_worker_pool() = default;
+    ~c_worker_pool();
+
+    // Non-copyable, non-movable
+    c_worker_pool(const c_worker_pool&) = delete;
+    c_worker_pool& operator=(const c_worker_pool&) = delete;
+    c_worker_pool(c_worker_pool&&) = delete;
+    c_worker_pool& operator=(c_worker_pool&&) = delete;
+
+    // Spawn worker_count threads. queue_capacity bounds tasks waiting for a worker.
+    void start(size_t worker_count, size_t queue_capacity);
+
+    // Stop accepting tasks, let the workers finish what is already queued,
+    // then join them. Safe to call more than once.
+    void stop();
+
+    // Queue a task. Returns false if the queue is full or the pool is stopped.
+    [[nodiscard]] bool try_submit(task_t task);
+
+    // Tasks waiting for a worker
+    [[nodiscard]] size_t queued() const;
+
+    // Workers currently running a task
+    [[nodiscard]] size_t busy() const { return m_busy.load(); }
+
+    [[nodiscard]] size_t worker_count() const { return m_workers.size(); }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<task_t> m_queue;
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_busy{0};
+    size_t m_capacity = 0;
+    bool m_stopping = false;
+
+    void worker_loop();
+};
@@ -2,35 +2,39 @@
 
 #include <string>
 #include <cstdint>
+#include <cstdio>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 
+#ifdef _WIN32
 #include "_plugin_types.h"
+#else
+// Portable builds (benchmarks) get the address and hex helpers only
+using duint = uintptr_t;
+#endif
 
 namespace format_utils {
 
     // Format a duint address as hex string with 0x prefix
     [[nodiscard]] inline std::string format_address(duint addr) {
-#ifdef _WIN64
         char buf[32];
-        snprintf(buf, sizeof(buf), "0x%016llX", static_cast<unsigned long long>(addr));
-#else
-        char buf[16];
-        snprintf(buf, sizeof(buf), "0x%08X", static_cast<unsigned int>(addr));
-#endif
+        if constexpr (sizeof(duint) == 8) {
+            snprintf(buf, sizeof(buf), "0x%016llX", static_cast<unsigned long long>(addr));
+        } else {
+            snprintf(buf, sizeof(buf), "0x%08X", static_cast<unsigned int>(addr));
+        }
         return buf;
     }
 
     // Format a duint value as hex string without prefix
     [[nodiscard]] inline std::string format_hex(duint value) {
-#ifdef _WIN64
         char buf[32];
-        snprintf(buf, sizeof(buf), "%llX", static_cast<unsigned long long>(value));
-#else
-        char buf[16];
-        snprintf(buf, sizeof(buf), "%X", static_cast<unsigned int>(value));
-#endif
+        if constexpr (sizeof(duint) == 8) {
+            snprintf(buf, sizeof(buf), "%llX", static_cast<unsigned long long>(value));
+        } else {
+            snprintf(buf, sizeof(buf), "%X", static_cast<unsigned int>(value));
+        }
         return buf;
     }
 
@@ -95,6 +99,8 @@ namespace format_utils {
 #endif
     }
 
+#ifdef _WIN32
+
     // Format DWORD protection flags as readable string
     [[nodiscard]] inline std::string format_protection(DWORD protect) {
         std::string result;
@@ -133,5 +139,6 @@ namespace format_utils {
             default:          return "UNKNOWN";
         }
     }
+#endif // _WIN32
 
 } // namespace format_utils
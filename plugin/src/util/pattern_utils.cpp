@@ -0,0 +1,71 @@
+#include "util/pattern_utils.h"
+
+namespace pattern_utils {
+
+std::vector<pattern_byte> parse_byte_pattern(const std::string& pattern_str) {
+    // Strip all spaces to normalize
+    std::string cleaned;
+    cleaned.reserve(pattern_str.size());
+    for (char c : pattern_str) {
+        if (c != ' ') cleaned += c;
+    }
+
+    if (cleaned.empty() || (cleaned.size() % 2) != 0) {
+        return {};
+    }
+
+    std::vector<pattern_byte> result;
+    result.reserve(cleaned.size() / 2);
+
+    for (size_t i = 0; i + 1 < cleaned.size(); i += 2) {
+        char hi = cleaned[i];
+        char lo = cleaned[i + 1];
+
+        bool hi_wild = (hi == '?' || hi == '*');
+        bool lo_wild = (lo == '?' || lo == '*');
+
+        if (hi_wild || lo_wild) {
+            result.push_back({0, true});
+        } else {
+            // Validate hex chars
+            auto is_hex = [](char c) {
+                return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+            };
+            if (!is_hex(hi) || !is_hex(lo)) {
+                return {};  // Invalid pattern
+            }
+            char hex[3] = {hi, lo, '\0'};
+            result.push_back({static_cast<uint8_t>(std::stoul(hex, nullptr, 16)), false});
+        }
+    }
+
+    return result;
+}
+
+std::vector<size_t> scan_buffer(
+    const uint8_t* buf, size_t buf_size,
+    const std::vector<pattern_byte>& pattern
+) {
+    std::vector<size_t> hits;
+    if (pattern.empty() || buf_size < pattern.size()) return hits;
+
+    const size_t pat_len = pattern.size();
+    const size_t search_end = buf_size - pat_len + 1;
+
+    for (size_t i = 0; i < search_end; ++i) {
+        bool match = true;
+        for (size_t j = 0; j < pat_len; ++j) {
+            if (!pattern[j].is_wildcard && buf[i + j] != pattern[j].value) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            hits.push_back(i);
+        }
+    }
+
+    return hits;
+}
+
+} // namespace pattern_utils
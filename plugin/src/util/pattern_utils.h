@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte-pattern (AOB) parsing and scanning used by the search endpoints.
+// Portable: no x64dbg SDK dependency.
+namespace pattern_utils {
+
+    struct pattern_byte {
+        uint8_t value = 0;
+        bool    is_wildcard = false;
+    };
+
+    // Parse a hex byte pattern string (e.g., "C4 CB 75 5B" or "C4CB755B" or "C4 ?? 75 5B")
+    // Returns pairs of (byte_value, is_wildcard).
+    // Returns empty vector if the pattern is malformed.
+    [[nodiscard]] std::vector<pattern_byte> parse_byte_pattern(const std::string& pattern_str);
+
+    // Scan a memory buffer for a byte pattern starting at any offset.
+    // Returns all offsets (relative to buffer start) where the pattern matches.
+    [[nodiscard]] std::vector<size_t> scan_buffer(
+        const uint8_t* buf, size_t buf_size,
+        const std::vector<pattern_byte>& pattern
+    );
+
+} // namespace pattern_utils